@@ -180,14 +180,11 @@ void ConsoleFormatter::PrintIterationInfo(ICellStatsProvider *stats, double curS
   fflush(stdout);
 }
 
-void ConsoleFormatter::PrintOnFinish(const std::vector<Cell *> &cells)
+void ConsoleFormatter::PrintOnFinish(ICellStatsProvider *stats)
 {
   printf("Simulation finished!\n");
-  std::vector<CellStats> stats;
-  for (size_t i = 0; i < cells.size(); i++)
-    stats.push_back(CellStats::Create(cells[i]));
-  
-  CellStats astats = CellStats::Aggregate(stats);
+  // Released cells have no data, so the stats are taken from the provider
+  CellStats astats = CellStats::Aggregate(stats->Stats());
   PrintSpringInfo(astats);
   PrintMtInfo(astats);
   PrintChromosomeInfo(astats);
@@ -25,7 +25,7 @@ class ConsoleFormatter : public IErrorFormatter, public IOutputFormatter
 
     virtual void PrintIterationInfo(ICellStatsProvider *stats, double curSimTime, double totalSimTime);
 
-    virtual void PrintOnFinish(const std::vector<Cell *> &cells);
+    virtual void PrintOnFinish(ICellStatsProvider *stats);
 
   private:
     void PrintTimeInfo(double curSimTime, double curRealTime, double totalSimTime);
@@ -28,7 +28,7 @@ class CsvFormatter : public IErrorFormatter, public IOutputFormatter
 
     virtual void PrintIterationInfo(ICellStatsProvider *stats, double curSimTime, double totalSimTime);
 
-    virtual void PrintOnFinish(const std::vector<Cell *> &cells) { /*nothing*/ }
+    virtual void PrintOnFinish(ICellStatsProvider *stats) { /*nothing*/ }
 
   private:
     std::unique_ptr<TimePredictor> _predictor;
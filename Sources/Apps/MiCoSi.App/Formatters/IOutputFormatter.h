@@ -29,7 +29,7 @@ class IOutputFormatter
 
     virtual void PrintIterationInfo(ICellStatsProvider *stats, double curSimTime, double totalSimTime) abstract;
 
-    virtual void PrintOnFinish(const std::vector<Cell *> &cells) abstract;
+    virtual void PrintOnFinish(ICellStatsProvider *stats) abstract;
 
     virtual ~IOutputFormatter() { /*nothing*/ }
 };
@@ -4,6 +4,101 @@
 #include "Formatters/ConsoleFormatter.h"
 #include "Formatters/CsvFormatter.h"
 
+#include <process.h>
+
+namespace
+{
+
+// '_spawnv()' joins arguments by spaces, so each of them is quoted by the rules of the C runtime:
+// backslashes are doubled before quotes and at the end, quotes are escaped
+std::string QuoteArgument(const std::string &arg)
+{
+  if (!arg.empty() && arg.find_first_of(" \t\n\v\"") == std::string::npos)
+  { return arg; }
+
+  std::string res = "\"";
+  size_t backslashes = 0;
+  for (char c : arg)
+  {
+    if (c == '\\')
+    {
+      backslashes++;
+      continue;
+    }
+
+    res.append(c == '"' ? backslashes * 2 + 1 : backslashes, '\\');
+    res.push_back(c);
+    backslashes = 0;
+  }
+  res.append(backslashes * 2, '\\');
+  res.push_back('"');
+  return res;
+}
+
+// Engines of both precisions are built together and stored in the same directory:
+// "MiCoSi" uses the default precision of the build, "MiCoSi.<PRECISION>" uses the other one
+// Runs the engine of the required precision with the same arguments and returns its exit code
+int StartEngine(MitosisArgs &args, const std::string &precision)
+{
+  char *self = nullptr;
+  if (_get_pgmptr(&self) != 0 || self == nullptr)
+  { throw std::runtime_error("failed to get path of the current engine"); }
+  std::string dir(self);
+  size_t slash = dir.find_last_of("\\/");
+  dir = slash == std::string::npos ? "" : dir.substr(0, slash + 1);
+
+  std::string engine = dir + "MiCoSi." + precision + ".exe";
+  FILE *f = fopen(engine.c_str(), "rb");
+  if (f != nullptr)
+  { fclose(f); }
+  else
+  { engine = dir + "MiCoSi.exe"; }
+  if (_stricmp(engine.c_str(), self) == 0)
+  { throw std::runtime_error(std::string("engine with \"") + precision + "\" precision was not built"); }
+
+  // The required precision is passed explicitly, so the engine doesn't look for another one
+  std::vector<std::string> params;
+  args.SetPrecision(precision);
+  args.Export(params);
+  params.insert(params.begin(), engine);
+  for (auto &param : params)
+  { param = QuoteArgument(param); }
+  std::vector<const char *> argv;
+  for (size_t i = 0; i < params.size(); i++)
+  { argv.push_back(params[i].c_str()); }
+  argv.push_back(nullptr);
+
+  fflush(stdout);
+  intptr_t res = _spawnv(_P_WAIT, engine.c_str(), argv.data());
+  if (res == -1)
+  { throw std::runtime_error(std::string("failed to start \"") + engine + "\""); }
+  return (int)res;
+}
+
+// The same, but errors are printed by the formatter
+int RunEngine(MitosisArgs &args, const std::string &precision,
+              IErrorFormatter *formatter, IErrorFormatter::ErrorType errType)
+{
+  try
+  { return StartEngine(args, precision); }
+  catch (std::exception &ex)
+  {
+    formatter->PrintError(errType, ex.what());
+    return 42;
+  }
+}
+
+// Returns precision of the engine that must process the stored results or nullptr if it's the current one
+const char *RequiredPrecision(const MitosisArgs &args, const CompilationConflictException &ex)
+{
+  const char *res = CurrentVersion::Precision(ex.RequiredFlags());
+  if (!args.GetPrecision().empty() || res == nullptr || strcmp(res, CurrentVersion::Precision()) == 0)
+  { return nullptr; }
+  return res;
+}
+
+} // unnamed namespace
+
 
 int main(int argc, char *argv[])
 {
@@ -30,6 +125,10 @@ int main(int argc, char *argv[])
                           : (IOutputFormatter *)(new ConsoleFormatter(args.GetPrintDelay())));
   IErrorFormatter *err_formatter = dynamic_cast<IErrorFormatter *>(out_formatter.get());
 
+  // Check for the "--precision" option, the other engine does everything if it's required
+  if (!args.GetPrecision().empty() && args.GetPrecision() != CurrentVersion::Precision())
+  { return RunEngine(args, args.GetPrecision(), err_formatter, IErrorFormatter::RuntimeError); }
+
   // Check for the "--info" option
   if (args.GetMode() == LaunchMode::Info)
   {
@@ -55,6 +154,15 @@ int main(int argc, char *argv[])
       out_formatter->PrintRepairCompleted(res.first, res.second);
       return 0;
     }
+    catch (CompilationConflictException &ex)
+    {
+      // Results were stored by the engine of the other precision, it repairs them
+      const char *precision = RequiredPrecision(args, ex);
+      if (precision != nullptr)
+      { return RunEngine(args, precision, err_formatter, IErrorFormatter::FailedToRepair); }
+      err_formatter->PrintError(IErrorFormatter::FailedToRepair, ex.what());
+      return 42;
+    }
     catch (std::exception &ex)
     {
       err_formatter->PrintError(IErrorFormatter::FailedToRepair, ex.what());
@@ -77,7 +185,8 @@ int main(int argc, char *argv[])
                                               args.GetPoleCoordsFile(),
                                               args.GetCellCount(),
                                               args.GetUserSeed(),
-                                              args.GetSolver());
+                                              args.GetSolver(),
+                                              args.GetStorageProfile());
         break;
       }
 
@@ -87,7 +196,8 @@ int main(int argc, char *argv[])
                                                 args.GetInitialConditionsFile(),
                                                 args.GetPoleCoordsFile(),
                                                 args.GetCellCount(),
-                                                args.GetSolver());
+                                                args.GetSolver(),
+                                                args.GetStorageProfile());
         break;
 
       case LaunchMode::Continue:
@@ -96,13 +206,23 @@ int main(int argc, char *argv[])
                                                  args.GetInitialConditionsFile(),
                                                  args.GetPoleCoordsFile(),
                                                  args.GetCellCount(),
-                                                 args.GetSolver());
+                                                 args.GetSolver(),
+                                                 args.GetStorageProfile());
         break;
 
       default:
         throw std::runtime_error("nternal error: unknown mode, did someone forget to update Main.cpp?");
     }
   }
+  catch (CompilationConflictException &ex)
+  {
+    // Results were stored by the engine of the other precision, it continues them
+    const char *precision = RequiredPrecision(args, ex);
+    if (precision != nullptr)
+    { return RunEngine(args, precision, err_formatter, IErrorFormatter::RuntimeError); }
+    err_formatter->PrintError(IErrorFormatter::RuntimeError, ex.what());
+    return 42;
+  }
   catch (std::exception &ex)
   {
     err_formatter->PrintError(IErrorFormatter::RuntimeError, ex.what());
@@ -114,12 +234,17 @@ int main(int argc, char *argv[])
   {
     double t_end = (double)GlobalSimParams::GetRef()->GetParameter(SimParameter::Double::T_End, true);
     double saveFreq = (double)GlobalSimParams::GetRef()->GetParameter(SimParameter::Double::Save_Freq_Macro, true);
+    double dt = (double)GlobalSimParams::GetRef()->GetParameter(SimParameter::Double::Dt, true);
     out_formatter->PrintOnStart(simulation->Cells());
     
+    // Iterations between two saves are done by one batch, the batch is limited to keep printing alive
+    // If the count is underestimated due to rounding, the rest is done by the next batch
+    const int MAX_BATCH = 100;
     double lastSavedTime = simulation->Time();
     while (!simulation->IsFinished())
     {
-      simulation->DoIteration();
+      double toSave = std::ceil((lastSavedTime + saveFreq - simulation->Time()) / dt - 1e-3);
+      simulation->DoIterations((int)std::max(1.0, std::min(toSave, (double)MAX_BATCH)));
       out_formatter->PrintIterationInfo(simulation.get(), simulation->Time(), t_end);
       if (lastSavedTime + saveFreq <= simulation->Time() + 1e-5)
       {
@@ -128,7 +253,8 @@ int main(int argc, char *argv[])
       }
     }
 
-    out_formatter->PrintOnFinish(simulation->Cells());
+    simulation->Flush();
+    out_formatter->PrintOnFinish(simulation.get());
     simulation.reset(nullptr);
   }
   catch (std::exception &ex)
@@ -1,16 +1,41 @@
 
 #include "Simulation.h"
 
+namespace
+{
+
+// Writers mostly wait for the disk, so a few of them are enough to hide I/O
+const size_t MAX_WRITERS = 4;
+
+std::vector<TimeStream *> StreamPointers(const std::vector<std::unique_ptr<TimeStream> > &streams)
+{
+  std::vector<TimeStream *> res;
+  for (auto &stream : streams)
+  { res.push_back(stream.get()); }
+  return res;
+}
+
+} // unnamed namespace
+
 //------------------
 //--- Simulation ---
 //------------------
 
+Simulation::Simulation(std::unique_ptr<Simulator> &sim,
+                       std::vector<std::unique_ptr<TimeStream> > &streams)
+  : _sim(std::move(sim)), _streams(std::move(streams)), _startTime(_sim->Time()),
+    _writer(new AsyncWriter(StreamPointers(_streams), MAX_WRITERS))
+{ SaveRetiredCells(); }
+
 const std::vector<Cell *> Simulation::Cells()
 {
   std::vector<Cell *> res;
   decltype(auto) ensemble = CellsAndRng();
   for (auto &cell : ensemble)
-  { res.emplace_back(&cell->CellObject()); }
+  {
+    if (cell != nullptr)
+    { res.emplace_back(&cell->CellObject()); }
+  }
   return res;
 }
 
@@ -21,5 +46,39 @@ void Simulation::SaveStates()
 
   decltype(auto) cells = _sim->Cells();
   for (size_t i = 0; i < _streams.size(); i++)
-  { _streams[i]->Append(cells[i]->CellObject(), _sim->Time(), cells[i]->Rng()); }
+  {
+    if (cells[i] != nullptr)
+    { _writer->Append(i, cells[i]->CellObject(), _sim->Time(), cells[i]->Rng()); }
+  }
+}
+
+void Simulation::Flush()
+{
+  _writer->Wait();
+  for (auto &stream : _streams)
+  { stream->Flush(); }
+}
+
+void Simulation::SaveRetiredCells()
+{
+  std::vector<size_t> retired;
+  for (size_t i = 0; i < _streams.size(); i++)
+  {
+    if (!_sim->IsRetired(i) || _sim->IsReleased(i))
+    { continue; }
+
+    // Cells that were retired before the continued simulation already have their final layers
+    auto cell = _sim->Release(i);
+    if (_sim->RetirementTime(i) > _startTime)
+    { _writer->Append(i, cell->CellObject(), _sim->RetirementTime(i), cell->Rng()); }
+    retired.push_back(i);
+  }
+
+  // Results of the retired cells are complete, so they are saved at once
+  if (!retired.empty())
+  {
+    _writer->Wait();
+    for (size_t i : retired)
+    { _streams[i]->Flush(); }
+  }
 }
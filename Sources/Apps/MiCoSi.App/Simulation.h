@@ -14,14 +14,13 @@ class Simulation : public ICellStatsProvider
     Simulation() = delete;
     Simulation(const Simulation &) = delete;
     Simulation(std::unique_ptr<Simulator> &sim,
-               std::vector<std::unique_ptr<TimeStream> > &streams)
-      : _sim(std::move(sim)), _streams(std::move(streams))
-    { /*nothing*/ }
+               std::vector<std::unique_ptr<TimeStream> > &streams);
     Simulation &operator =(const Simulation &) = delete;
     ~Simulation() = default;
 
     const Simulator::CellEnsemble &CellsAndRng() { return _sim->Cells(); }
 
+    // Cells that are still kept by the simulator, the released ones are skipped
     const std::vector<Cell *> Cells();
 
     double Time() { return _sim->Time(); }
@@ -30,13 +29,25 @@ class Simulation : public ICellStatsProvider
 
     bool IsFinished() { return _sim->IsFinished(); }
 
-    void DoIteration() { _sim->DoIteration(); }
+    void DoIteration() { _sim->DoIteration(); SaveRetiredCells(); }
 
+    void DoIterations(int count) { _sim->DoIterations(count); SaveRetiredCells(); }
+
+    // Appends the current states of active cells, the retired ones already have their final layers
+    // Layers are written in background, the call only takes snapshots of cells
     void SaveStates();
 
+    // Waits until all layers are written and flushes streams, reports errors of the background writes
+    void Flush();
+
   private:
+    // Writes the final layers of the newly retired cells and releases them
+    void SaveRetiredCells();
+
     std::unique_ptr<Simulator> _sim;
     std::vector<std::unique_ptr<TimeStream> > _streams;
+    double _startTime;
+    std::unique_ptr<AsyncWriter> _writer;   // is destroyed before streams
 
   friend class WorkingDirUtility;
 };
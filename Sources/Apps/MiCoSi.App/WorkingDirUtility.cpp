@@ -33,13 +33,26 @@ std::string ReadAllText(const std::string &filename)
   }
 }
 
+// Stored series are restarted and continued in the mode they were started with, so their results stay reproducible
+void UseStoredMode(SimulatorConfig &config, bool deterministic)
+{
+  if (config.IsDeterministic() && !deterministic)
+  {
+    throw std::runtime_error(
+      "cannot switch the stored simulation to the deterministic mode, it was started without it"
+    );
+  }
+  config.SetDeterministic(deterministic);
+}
+
 std::unique_ptr<Simulation> StartSimulation(const char *cellFile,
                                             const char *configFile,
                                             const char *initialConditions,
                                             const char *poleCoords,
                                             const std::vector<Random::State> &rngStates,
                                             int64_t userSeed,
-                                            SimulatorConfig config)
+                                            SimulatorConfig config,
+                                            FrameFormat::Profile profile)
 {
   std::unique_ptr<Simulator> sim;
   std::vector<std::unique_ptr<TimeStream> > ts;
@@ -65,7 +78,9 @@ std::unique_ptr<Simulation> StartSimulation(const char *cellFile,
   {
     auto cur = TimeStream::Create(filenames[i].c_str(),
                                   cells[i]->CellObject(),
-                                  rngStates[i], userSeed);
+                                  rngStates[i], userSeed,
+                                  IChunkCodec::Delta, config.IsDeterministic());
+    cur->SetProfile(profile);
     cur->Append(*GlobalSimParams::GetRef());
     ts.emplace_back(std::move(cur));
   }
@@ -93,7 +108,8 @@ std::unique_ptr<Simulation> WorkingDirUtility::Start(const char *cellFile,
                                                      const char *poleCoords,
                                                      size_t cellCount,
                                                      int64_t userSeed,
-                                                     SimulatorConfig config)
+                                                     SimulatorConfig config,
+                                                     FrameFormat::Profile profile)
 {
   auto initRng = [userSeed](Random::State &state) -> void {
     if (userSeed < 0) { Random::Initialize(state); }
@@ -101,7 +117,20 @@ std::unique_ptr<Simulation> WorkingDirUtility::Start(const char *cellFile,
   };
 
   std::vector<Random::State> states(cellCount);
-  if (states.size() == 1)
+  if (config.IsDeterministic())
+  {
+    // Each cell gets its own stream of the seed, so any cell of the series can be reproduced alone
+    uint32_t seed = (uint32_t)userSeed;
+    if (userSeed < 0)
+    {
+      Random::State tmp;
+      initRng(tmp);
+      seed = Random::Next(tmp);
+    }
+    for (size_t i = 0; i < states.size(); i++)
+    { Random::Initialize(states[i], seed, (uint32_t)i); }
+  }
+  else if (states.size() == 1)
   { initRng(states[0]); }
   else
   {
@@ -112,7 +141,7 @@ std::unique_ptr<Simulation> WorkingDirUtility::Start(const char *cellFile,
 
   return StartSimulation(cellFile, configFile,
                          initialConditions, poleCoords,
-                         states, userSeed, config);
+                         states, userSeed, config, profile);
 }
 
 std::unique_ptr<Simulation> WorkingDirUtility::Restart(const char *cellFile,
@@ -120,15 +149,18 @@ std::unique_ptr<Simulation> WorkingDirUtility::Restart(const char *cellFile,
                                                        const char *initialConditions,
                                                        const char *poleCoords,
                                                        size_t cellCount,
-                                                       SimulatorConfig config)
+                                                       SimulatorConfig config,
+                                                       FrameFormat::Profile profile)
 {
   int64_t userSeed = -1;
+  bool deterministic = false;
   std::vector<Random::State> states(cellCount);
   if (cellCount == 1)
   {
     std::unique_ptr<TimeStream> ts(TimeStream::Open(cellFile));
     states[0] = ts->InitialRNG();
     userSeed  = ts->UserSeed();
+    deterministic = ts->IsDeterministic();
   }
   else
   {
@@ -137,10 +169,15 @@ std::unique_ptr<Simulation> WorkingDirUtility::Restart(const char *cellFile,
     {
       std::unique_ptr<TimeStream> ts(TimeStream::Open(filenames[i].c_str()));
       states[i] = ts->InitialRNG();
+      if (i == 0)
+      { deterministic = ts->IsDeterministic(); }
+      else if (deterministic != ts->IsDeterministic())
+      { throw std::runtime_error("cannot process cells that were simulated in different modes"); }
     }
   }
+  UseStoredMode(config, deterministic);
 
-  return StartSimulation(cellFile, configFile, initialConditions, poleCoords, states, userSeed, config);
+  return StartSimulation(cellFile, configFile, initialConditions, poleCoords, states, userSeed, config, profile);
 }
 
 std::unique_ptr<Simulation> WorkingDirUtility::Continue(const char *cellFile,
@@ -148,7 +185,8 @@ std::unique_ptr<Simulation> WorkingDirUtility::Continue(const char *cellFile,
                                                         const char *initialConditions,
                                                         const char *poleCoords,
                                                         size_t cellCount,
-                                                        SimulatorConfig config)
+                                                        SimulatorConfig config,
+                                                        FrameFormat::Profile profile)
 {
   if (initialConditions != nullptr)
   {
@@ -159,7 +197,7 @@ std::unique_ptr<Simulation> WorkingDirUtility::Continue(const char *cellFile,
 
   std::vector<std::pair<const Cell *, Random::State> > cells;
   std::vector<std::unique_ptr<TimeStream> > ts;
-  double time = -1.0;
+  std::vector<double> times;
 
   // Create pole updater
   std::unique_ptr<IPoleUpdater> poleUpdater;
@@ -176,6 +214,8 @@ std::unique_ptr<Simulation> WorkingDirUtility::Continue(const char *cellFile,
     { throw std::runtime_error("cannot continue empty simulation, you should use 'new' mode"); }
 
     cur->MoveTo(cur->LayerCount() - 1);
+    if (cur->Current().GetProfile() != FrameFormat::Full)
+    { throw std::runtime_error("cannot continue simulation, its last time layer is stored with a lossy profile"); }
 
     // Set (or check) the simulation parameters
     std::unique_ptr<SimParams> params(new SimParams());
@@ -189,7 +229,7 @@ std::unique_ptr<Simulation> WorkingDirUtility::Continue(const char *cellFile,
       GlobalSimParams::GetRef()->SetAccess(SimParams::Access::Initialize);
       GlobalSimParams::GetRef()->ImportValues(params->ExportValues());
       GlobalSimParams::GetRef()->SetAccess(SimParams::Access::Update);
-      time = cur->Current().GetTime();
+      UseStoredMode(config, cur->IsDeterministic());
     }
     else // others check correctness of their own parameters
     {
@@ -211,17 +251,20 @@ std::unique_ptr<Simulation> WorkingDirUtility::Continue(const char *cellFile,
           ); }
       }
 
-      if (time != cur->Current().GetTime())
-      { throw std::runtime_error("cannot process cells with different times simultanoiusly"); }
+      if (config.IsDeterministic() != cur->IsDeterministic())
+      { throw std::runtime_error("cannot process cells that were simulated in different modes"); }
     }
+    cur->SetProfile(profile);
 
+    // Streams of the retired cells end earlier, the simulator continues from the latest time
+    times.push_back(cur->Current().GetTime());
     auto tl = cur->Current();
     cells.push_back(std::make_pair(&tl.GetCell(), tl.GetRng()));
     ts.emplace_back(std::move(cur));
   }
 
   // Finally, create the simulator
-  auto sim = SimulatorFactory::Create(cells, time, poleUpdater.get(), config);
+  auto sim = SimulatorFactory::Create(cells, times, poleUpdater.get(), config);
 
   return std::make_unique<Simulation>(sim, ts);
 }
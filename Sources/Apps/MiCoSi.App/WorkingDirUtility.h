@@ -17,13 +17,15 @@ class WorkingDirUtility
     static std::pair<size_t, double> Fix(const char *cellFile);
 
     // Creates new time streams, associated with provided cell files
+    // Time layers are stored with the given profile (see 'FrameFormat')
     static std::unique_ptr<Simulation> Start(const char *cellFile,
                                              const char *configFile,
                                              const char *initialConditions,
                                              const char *poleCoords,
                                              size_t cellCount,
                                              int64_t userSeed,
-                                             SimulatorConfig config);
+                                             SimulatorConfig config,
+                                             FrameFormat::Profile profile);
 
     // Creates new time streams, associated with provided cell files, but with the same RNG
     static std::unique_ptr<Simulation> Restart(const char *cellFile,
@@ -31,13 +33,16 @@ class WorkingDirUtility
                                                const char *initialConditions,
                                                const char *poleCoords,
                                                size_t cellCount,
-                                               SimulatorConfig config);
+                                               SimulatorConfig config,
+                                               FrameFormat::Profile profile);
 
     // Opens existant time streams, that are stored in cell files
+    // Their last time layers must be full, the following ones are stored with the given profile
     static std::unique_ptr<Simulation> Continue(const char *cellFile,
                                                 const char *configFile,
                                                 const char *initialConditions,
                                                 const char *poleCoords,
                                                 size_t cellCount,
-                                                SimulatorConfig config);
+                                                SimulatorConfig config,
+                                                FrameFormat::Profile profile);
 };
@@ -61,6 +61,15 @@ class MitosisArgsHelper
       catch (std::exception &) { return false; }
     }
 
+    static bool IsPrecisionStringOrNotSet(std::string str)
+    { return str.empty() || str == "fp32" || str == "fp64"; }
+
+    static bool IsStorageProfileString(std::string str)
+    {
+      FrameFormat::Profile profile;
+      return FrameFormat::TryParseProfile(str, profile);
+    }
+
     static bool IsLaunchModeButNotHelpString(std::string str)
     {
       LaunchMode::Type t;
@@ -96,6 +105,11 @@ const char *MitosisArgs::Option::ToString(MitosisArgs::Option::Type type)
     case Solver:                  return "--solver";
     case CsvOutput:               return "--csv";
     case PrintDelay:              return "--print_delay";
+    case Precision:               return "--precision";
+    case Deterministic:           return "--deterministic";
+    case PinThreads:              return "--pin_threads";
+    case FirstTouch:              return "--first_touch";
+    case StorageProfile:          return "--storage";
     default: throw std::runtime_error("Internal error - wrong value for MitosisArgs::Option");
   }
 }
@@ -152,12 +166,22 @@ MitosisArgs::MitosisArgs()
     _cellCount = 1;
     _csvOutput = false;
     _printDelay = 1.0;
+    _precision = "";
+    _deterministic = false;
+    _pinThreads = false;
+    _firstTouch = false;
+    _storage = FrameFormat::ProfileName(FrameFormat::Full);
 
     Register(Option::ToString(Option::RngSeed), _seed, MitosisArgsHelper::IsSeed);
     Register(Option::ToString(Option::Solver), _solver, MitosisArgsHelper::IsSolverString);
     Register(Option::ToString(Option::CellCount), _cellCount, MitosisArgsHelper::IsPositive);
     Register(Option::ToString(Option::CsvOutput), _csvOutput);
     Register(Option::ToString(Option::PrintDelay), _printDelay, MitosisArgsHelper::IsNonNegative);
+    Register(Option::ToString(Option::Precision), _precision, MitosisArgsHelper::IsPrecisionStringOrNotSet);
+    Register(Option::ToString(Option::Deterministic), _deterministic);
+    Register(Option::ToString(Option::PinThreads), _pinThreads);
+    Register(Option::ToString(Option::FirstTouch), _firstTouch);
+    Register(Option::ToString(Option::StorageProfile), _storage, MitosisArgsHelper::IsStorageProfileString);
 
     IncompatibleWith(Option::ToString(Option::RngSeed),
                      Option::ToString(Option::Mode), LaunchMode::ToString(LaunchMode::Fix));
@@ -171,6 +195,22 @@ MitosisArgs::MitosisArgs()
                      Option::ToString(Option::Mode), LaunchMode::ToString(LaunchMode::Fix));
     IncompatibleWith(Option::ToString(Option::Solver),
                      Option::ToString(Option::Mode), LaunchMode::ToString(LaunchMode::Info));
+    IncompatibleWith(Option::ToString(Option::Deterministic),
+                     Option::ToString(Option::Mode), LaunchMode::ToString(LaunchMode::Fix));
+    IncompatibleWith(Option::ToString(Option::Deterministic),
+                     Option::ToString(Option::Mode), LaunchMode::ToString(LaunchMode::Info));
+    IncompatibleWith(Option::ToString(Option::PinThreads),
+                     Option::ToString(Option::Mode), LaunchMode::ToString(LaunchMode::Fix));
+    IncompatibleWith(Option::ToString(Option::PinThreads),
+                     Option::ToString(Option::Mode), LaunchMode::ToString(LaunchMode::Info));
+    IncompatibleWith(Option::ToString(Option::FirstTouch),
+                     Option::ToString(Option::Mode), LaunchMode::ToString(LaunchMode::Fix));
+    IncompatibleWith(Option::ToString(Option::FirstTouch),
+                     Option::ToString(Option::Mode), LaunchMode::ToString(LaunchMode::Info));
+    IncompatibleWith(Option::ToString(Option::StorageProfile),
+                     Option::ToString(Option::Mode), LaunchMode::ToString(LaunchMode::Fix));
+    IncompatibleWith(Option::ToString(Option::StorageProfile),
+                     Option::ToString(Option::Mode), LaunchMode::ToString(LaunchMode::Info));
     IncompatibleWith(Option::ToString(Option::CsvOutput),
                      Option::ToString(Option::Mode), LaunchMode::ToString(LaunchMode::Fix));
     IncompatibleWith(Option::ToString(Option::PrintDelay),
@@ -195,6 +235,11 @@ MitosisArgs *MitosisArgs::Clone()
   res->_solver = _solver;
   res->_csvOutput = _csvOutput;
   res->_printDelay = _printDelay;
+  res->_precision = _precision;
+  res->_deterministic = _deterministic;
+  res->_pinThreads = _pinThreads;
+  res->_firstTouch = _firstTouch;
+  res->_storage = _storage;
 
   return res;
 }
@@ -210,8 +255,10 @@ std::string MitosisArgs::HelpMessage()
   ss << "     Mitosis [--mode <MODE>] [--cell <RESULTS>.cell]" << std::endl;
   ss << "             [--config <FILE>.conf] [--initial <FILE>.xml] [--poles <FILE>.xml]" << std::endl;
   ss << "             [--seed <SEED_VALUE>] [--series <SERIES>] [--solver <SOLVER>]" << std::endl;
-  ss << "             [--csv] [--print_delay <DELAY>]" << std::endl;
-  ss << "     Mitosis --mode fix [--cell <RESULTS>.cell]" << std::endl;
+  ss << "             [--deterministic] [--pin_threads] [--first_touch]" << std::endl;
+  ss << "             [--storage <PROFILE>]" << std::endl;
+  ss << "             [--csv] [--print_delay <DELAY>] [--precision <PRECISION>]" << std::endl;
+  ss << "     Mitosis --mode fix [--cell <RESULTS>.cell] [--precision <PRECISION>]" << std::endl;
   ss << "     Mitosis --mode info [--csv]" << std::endl;
   ss << std::endl;
   ss << "Where:" << std::endl;
@@ -261,14 +308,47 @@ std::string MitosisArgs::HelpMessage()
   ss << "                        number. The default value is one." << std::endl;
   ss << "     " << Option::ToString(Option::Solver) << " <SOLVER>" << std::endl;
   ss << "                      - defines implementation of the simulation algorithm." << std::endl;
-  ss << "                        SOLVER can be set by \"gold\", \"cuda\" or \"experimental\"" << std::endl;
-  ss << "                        values. The gold version is used by default." << std::endl;
+  ss << "                        SOLVER can be set by \"cpu\", \"cpu-intra\", \"cpu-tasks\"" << std::endl;
+  ss << "                        or \"cuda\" values with optional \":N\" suffix - count of" << std::endl;
+  ss << "                        threads or number of device. \"cpu-intra\" also splits" << std::endl;
+  ss << "                        MTs of each cell between threads, it's useful for small" << std::endl;
+  ss << "                        series. \"cpu-tasks\" balances large series of cells" << std::endl;
+  ss << "                        that differ in cost. The \"cpu\" version is used by" << std::endl;
+  ss << "                        default." << std::endl;
+  ss << "     " << Option::ToString(Option::Deterministic) << std::endl;
+  ss << "                      - makes results bitwise identical for all \"cpu*\" solvers" << std::endl;
+  ss << "                        and any count of threads, each cell of the series gets" << std::endl;
+  ss << "                        its own stream of the seed. The mode is stored with" << std::endl;
+  ss << "                        results, \"continue\" and \"restart\" modes keep it." << std::endl;
+  ss << "     " << Option::ToString(Option::PinThreads) << std::endl;
+  ss << "                      - binds threads of \"cpu*\" solvers to processors, each" << std::endl;
+  ss << "                        thread keeps its cells (except \"cpu-tasks\" that" << std::endl;
+  ss << "                        balances cells dynamically)." << std::endl;
+  ss << "     " << Option::ToString(Option::FirstTouch) << std::endl;
+  ss << "                      - copies data of each cell by the thread that owns it," << std::endl;
+  ss << "                        so it's allocated on the thread's NUMA node. Useful" << std::endl;
+  ss << "                        for large series on multi-socket machines, mostly" << std::endl;
+  ss << "                        together with \"" << Option::ToString(Option::PinThreads) << "\"." << std::endl;
+  ss << "     " << Option::ToString(Option::StorageProfile) << " <PROFILE>" << std::endl;
+  ss << "                      - defines which values of time layers are stored." << std::endl;
+  ss << "                        PROFILE can be set by \"full\" (default), \"analysis\"" << std::endl;
+  ss << "                        (half-precision directions and quantized lengths of" << std::endl;
+  ss << "                        MTs, no force offsets) or \"topology\" (only states" << std::endl;
+  ss << "                        and bound chromosomes of MTs and poses of chromosomes)." << std::endl;
+  ss << "                        Simulations with lossy profiles cannot be continued." << std::endl;
   ss << "     " << Option::ToString(Option::CsvOutput) << std::endl;
   ss << "                      - forces to use csv table for output printing. Useful for" << std::endl;
   ss << "                        parsing automatization." << std::endl;
   ss << "     " << Option::ToString(Option::PrintDelay) << " <DELAY>" << std::endl;
   ss << "                      - sets delay between printing of two output records, in" << std::endl;
   ss << "                        seconds. Default value - 1.0." << std::endl;
+  ss << "     " << Option::ToString(Option::Precision) << " <PRECISION>" << std::endl;
+  ss << "                      - defines floating point numbers of the engine, can be" << std::endl;
+  ss << "                        set by \"fp32\" or \"fp64\" values. Engines of both" << std::endl;
+  ss << "                        precisions are shipped, the required one is started" << std::endl;
+  ss << "                        automatically. If not specified, precision of the" << std::endl;
+  ss << "                        stored results is used, new simulations use \"fp32\"" << std::endl;
+  ss << "                        unless the build was configured differently." << std::endl;
   ss << std::endl;
 
   return ss.str();
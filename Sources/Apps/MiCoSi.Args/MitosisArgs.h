@@ -3,6 +3,7 @@
 
 #include "MiCoSi.Core/Random.h"
 #include "MiCoSi.Solvers/SimulatorConfig.h"
+#include "MiCoSi.Formatters/FrameFormat.h"
 #include "UniArgs.h"
 
 class LaunchMode
@@ -41,7 +42,12 @@ class MitosisArgs : public UniArgs
           CellCount              = 6,
           Solver                 = 7,
           CsvOutput              = 8,
-          PrintDelay             = 9
+          PrintDelay             = 9,
+          Precision              = 10,
+          Deterministic          = 11,
+          PinThreads             = 12,
+          FirstTouch             = 13,
+          StorageProfile         = 14
         };
       
         // Returns string-based name (like "--do_something").
@@ -96,10 +102,39 @@ class MitosisArgs : public UniArgs
     int GetCellCount() const { return _cellCount; }
     void SetCellCount(int value) { _cellCount = value; }
 
-    // Type of solver that must be used for computations
-    SimulatorConfig GetSolver() const { return SimulatorConfig::Parse(_solver.c_str()); }
+    // Type of solver that must be used for computations, includes the "--deterministic" flag
+    SimulatorConfig GetSolver() const
+    {
+      SimulatorConfig res = SimulatorConfig::Parse(_solver.c_str());
+      res.SetDeterministic(_deterministic);
+      res.SetPinThreads(_pinThreads);
+      res.SetFirstTouch(_firstTouch);
+      return res;
+    }
     void SetSolver(SimulatorConfig solver) { _solver = SimulatorConfig::Serialize(solver); }
 
+    // True if results must not depend on the solver and the count of threads
+    bool GetDeterministic() const { return _deterministic; }
+    void SetDeterministic(bool value) { _deterministic = value; }
+
+    // True if threads must be bound to processors
+    bool GetPinThreads() const { return _pinThreads; }
+    void SetPinThreads(bool value) { _pinThreads = value; }
+
+    // True if data of cells must be allocated by the threads that own them
+    bool GetFirstTouch() const { return _firstTouch; }
+    void SetFirstTouch(bool value) { _firstTouch = value; }
+
+    // Profile of the stored time layers, the lossy ones are smaller, but cannot be continued
+    FrameFormat::Profile GetStorageProfile() const
+    {
+      FrameFormat::Profile res;
+      if (!FrameFormat::TryParseProfile(_storage, res))
+      { throw std::runtime_error("Failed to parse storage profile \"" + _storage + "\""); }
+      return res;
+    }
+    void SetStorageProfile(FrameFormat::Profile value) { _storage = FrameFormat::ProfileName(value); }
+
     // True if output should be formatted as csv-table
     bool GetCsvOutput() const { return _csvOutput; }
     void SetCsvOutput(bool value) { _csvOutput = value; }
@@ -108,6 +143,11 @@ class MitosisArgs : public UniArgs
     double GetPrintDelay() const { return _printDelay; }
     void SetPrintDelay(double value) { _printDelay = value; }
 
+    // Precision of the engine ("fp32" or "fp64"), empty string means the precision of stored results
+    // or the default one of the build
+    const std::string &GetPrecision() const { return _precision; }
+    void SetPrecision(const std::string &value) { _precision = value; }
+
     static std::vector<std::string> MultiplyCells(const char *filenameTemplate, size_t cellCount);
 
   private:
@@ -122,4 +162,9 @@ class MitosisArgs : public UniArgs
     std::string _solver;
     bool _csvOutput;
     double _printDelay;
+    std::string _precision;
+    bool _deterministic;
+    bool _pinThreads;
+    bool _firstTouch;
+    std::string _storage;
 };
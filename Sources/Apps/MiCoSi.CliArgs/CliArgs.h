@@ -20,6 +20,8 @@ namespace MiCoSi
   {
     CPU           = ::SimulatorConfig::CPU,
     CUDA          = ::SimulatorConfig::CUDA,
+    CPU_INTRA     = ::SimulatorConfig::CPU_INTRA,
+    CPU_TASKS     = ::SimulatorConfig::CPU_TASKS,
   };
 
   public ref class SimulatorConfig : System::IDisposable
@@ -83,7 +85,12 @@ namespace MiCoSi
         CellCount              = ::MitosisArgs::Option::CellCount,
         Solver                 = ::MitosisArgs::Option::Solver,
         CsvOutput              = ::MitosisArgs::Option::CsvOutput,
-        PrintDelay             = ::MitosisArgs::Option::PrintDelay
+        PrintDelay             = ::MitosisArgs::Option::PrintDelay,
+        Precision              = ::MitosisArgs::Option::Precision,
+        Deterministic          = ::MitosisArgs::Option::Deterministic,
+        PinThreads             = ::MitosisArgs::Option::PinThreads,
+        FirstTouch             = ::MitosisArgs::Option::FirstTouch,
+        StorageProfile         = ::MitosisArgs::Option::StorageProfile
       };
 
       static System::String ^OptionName(Option opt)
@@ -246,6 +253,42 @@ namespace MiCoSi
         void set(double value) { _obj->SetPrintDelay(value); }
       }
 
+      property System::String ^Precision
+      {
+        System::String ^get() { return gcnew System::String(_obj->GetPrecision().c_str()); }
+        void set(System::String ^value) { _obj->SetPrecision(value == nullptr ? "" : StrToStr(value)); }
+      }
+
+      property bool Deterministic
+      {
+        bool get() { return _obj->GetDeterministic(); }
+        void set(bool value) { _obj->SetDeterministic(value); }
+      }
+
+      property bool PinThreads
+      {
+        bool get() { return _obj->GetPinThreads(); }
+        void set(bool value) { _obj->SetPinThreads(value); }
+      }
+
+      property bool FirstTouch
+      {
+        bool get() { return _obj->GetFirstTouch(); }
+        void set(bool value) { _obj->SetFirstTouch(value); }
+      }
+
+      property System::String ^StorageProfile
+      {
+        System::String ^get() { return gcnew System::String(::FrameFormat::ProfileName(_obj->GetStorageProfile())); }
+        void set(System::String ^value)
+        {
+          ::FrameFormat::Profile profile;
+          if (value == nullptr || !::FrameFormat::TryParseProfile(StrToStr(value), profile))
+          { throw gcnew System::ApplicationException("Unknown storage profile"); }
+          _obj->SetStorageProfile(profile);
+        }
+      }
+
       static array<System::String ^> ^MultiplyCells(System::String ^filenameTemplate, int cellCount)
       {
         auto res = ::MitosisArgs::MultiplyCells(StrToStr(filenameTemplate).c_str(), cellCount);
@@ -19,7 +19,12 @@ namespace MiCoSi
         Frozen_Coords             = ::SimParameter::Int::Frozen_Coords,
         MT_Wrapping               = ::SimParameter::Int::MT_Wrapping,
         MT_Lateral_Attachments    = ::SimParameter::Int::MT_Lateral_Attachments,
-        N_KMT_Max                 = ::SimParameter::Int::N_KMT_Max
+        N_KMT_Max                 = ::SimParameter::Int::N_KMT_Max,
+        Normal_Sampler            = ::SimParameter::Int::Normal_Sampler,
+        Free_MT_Engine            = ::SimParameter::Int::Free_MT_Engine,
+        Micro_Substeps            = ::SimParameter::Int::Micro_Substeps,
+        Macro_Period              = ::SimParameter::Int::Macro_Period,
+        Stop_Condition            = ::SimParameter::Int::Stop_Condition
       };
 
       enum class Double
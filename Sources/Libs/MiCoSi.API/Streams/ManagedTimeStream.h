@@ -83,6 +83,17 @@ namespace MiCoSi
         }
       }
 
+      property bool Deterministic
+      {
+        bool get()
+        {
+          try
+          { return (*_stream)->IsDeterministic(); }
+          catch (std::exception &ex)
+          { throw gcnew System::ApplicationException(gcnew System::String(ex.what())); }
+        }
+      }
+
       property TimeLayer ^Current
       {
         virtual TimeLayer ^get() = System::Collections::Generic::IEnumerator<TimeLayer ^>::Current::get
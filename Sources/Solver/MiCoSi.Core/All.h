@@ -6,5 +6,6 @@
 #include "Interfaces.h"
 #include "Random.h"
 #include "SimParams.h"
+#include "ThreadAffinity.h"
 #include "Timer.h"
 #include "Versions.h"
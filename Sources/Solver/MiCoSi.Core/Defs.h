@@ -16,6 +16,7 @@
 #include <stdexcept>
 #include <string>
 #include <sstream>
+#include <type_traits>
 #include <vector>
 
 #include <stdint.h>
@@ -144,8 +144,170 @@ uint32_t MersenneTwisterGenerator::Max() const
   return State::max();
 }
 
+//-----------------------
+//--- PhiloxGenerator ---
+//-----------------------
+
+void PhiloxGenerator::Initialize(State &state) const
+{
+  std::random_device rd;
+  Initialize(state, rd() ^ CreateTimeBasedSeed(), 0);
+}
+
+void PhiloxGenerator::Initialize(State &state, uint32_t seed) const
+{
+  Initialize(state, seed, 0);
+}
+
+void PhiloxGenerator::Initialize(State &state, uint32_t seed, uint32_t stream) const
+{
+  state.key[0] = seed;
+  state.key[1] = stream;
+  state.counter = 0;
+  state.used = 4;
+  for (int i = 0; i < 4; i++)
+  { state.block[i] = 0; }
+}
+
+void PhiloxGenerator::Multiply(PhiloxGenerator::State &oldState,
+                               std::vector<PhiloxGenerator::State> &newStates) const
+{
+  std::function<uint32_t()> next
+    = [this, &oldState]() -> uint32_t
+      { return Next(oldState); };
+  std::function<void(PhiloxGenerator::State &, uint32_t)> applySeed
+    = [this](PhiloxGenerator::State &state, uint32_t val) -> void
+      { Initialize(state, val); };
+
+  MultiplyState<PhiloxGenerator::State>(next, applySeed, newStates);
+}
+
+std::string PhiloxGenerator::Serialize(const State &state) const
+{
+  std::ostringstream ss;
+  ss << state.key[0] << " " << state.key[1] << " " << state.counter << " " << state.used;
+  return ss.str();
+}
+
+void PhiloxGenerator::Deserialize(std::string serialized, State &state) const
+{
+  std::istringstream ss(serialized);
+  State tmp;
+  if (!(ss >> tmp.key[0] >> tmp.key[1] >> tmp.counter >> tmp.used) || ss.bad() || !ss.eof() ||
+      tmp.used > 4 || (tmp.used < 4 && tmp.counter == 0))
+  { throw std::runtime_error("failed to deserialize RNG state"); }
+
+  if (tmp.used < 4)
+  { Block(tmp.key, tmp.counter - 1, tmp.block); }
+  else
+  {
+    for (int i = 0; i < 4; i++)
+    { tmp.block[i] = 0; }
+  }
+  state = tmp;
+}
+
+uint32_t PhiloxGenerator::Next(State &state) const
+{
+  if (state.used == 4)
+  {
+    Block(state.key, state.counter, state.block);
+    state.counter += 1;
+    state.used = 0;
+  }
+  return state.block[state.used++];
+}
+
+uint32_t PhiloxGenerator::Max() const
+{
+  return 0xFFFFFFFFu;
+}
+
+void PhiloxGenerator::Skip(State &state, uint64_t count) const
+{
+  // Position of the next number, the "used == 4" case is valid for the initial state as well
+  uint64_t pos = state.counter * 4 + state.used - 4 + count;
+  if (pos % 4 == 0)
+  {
+    state.counter = pos / 4;
+    state.used = 4;
+  }
+  else
+  {
+    Block(state.key, pos / 4, state.block);
+    state.counter = pos / 4 + 1;
+    state.used = (uint32_t)(pos % 4);
+  }
+}
+
+void PhiloxGenerator::Block(const uint32_t key[2], uint64_t counter, uint32_t res[4])
+{
+  const uint32_t M0 = 0xD2511F53u, M1 = 0xCD9E8D57u;
+  const uint32_t W0 = 0x9E3779B9u, W1 = 0xBB67AE85u;
+
+  uint32_t c[4] = { (uint32_t)counter, (uint32_t)(counter >> 32), 0, 0 };
+  uint32_t k[2] = { key[0], key[1] };
+  for (int round = 0; round < 10; round++)
+  {
+    uint64_t p0 = (uint64_t)M0 * c[0];
+    uint64_t p1 = (uint64_t)M1 * c[2];
+    uint32_t n[4] = { (uint32_t)(p1 >> 32) ^ c[1] ^ k[0], (uint32_t)p1,
+                      (uint32_t)(p0 >> 32) ^ c[3] ^ k[1], (uint32_t)p0 };
+    for (int i = 0; i < 4; i++)
+    { c[i] = n[i]; }
+    k[0] += W0;
+    k[1] += W1;
+  }
+  for (int i = 0; i < 4; i++)
+  { res[i] = c[i]; }
+}
+
+//--------------------------
+//--- SubstreamGenerator ---
+//--------------------------
+
+uint32_t SubstreamGenerator::Max() const
+{
+  return 0xFFFFFFFFu;
+}
+
 //--------------
 //--- Random ---
 //--------------
 
 Random::Generator Random::gen_;
+SubstreamGenerator Random::sub_;
+
+void Random::NextNormals(State &state, real *res, size_t count)
+{
+  const size_t BATCH = 64;
+  double u1[BATCH / 2], u2[BATCH / 2];
+  double scale = 1.0 / ((double)gen_.Max() + 1.0);
+
+  for (size_t offset = 0; offset < count; offset += BATCH)
+  {
+    size_t pairs = (std::min(BATCH, count - offset) + 1) / 2;
+
+    // Draws are sequential, the transform is a separate branch-free loop
+    // u1 is taken from (0, 1] in order to avoid log(0)
+    for (size_t i = 0; i < pairs; i++)
+    {
+      u1[i] = ((double)gen_.Next(state) + 1.0) * scale;
+      u2[i] = (double)gen_.Next(state) * scale;
+    }
+
+    real tmp[BATCH];
+    for (size_t i = 0; i < pairs; i++)
+    {
+      double r = std::sqrt(-2.0 * std::log(u1[i]));
+      double phi = 2.0 * PI * u2[i];
+      tmp[2 * i] = (real)(r * std::cos(phi));
+      tmp[2 * i + 1] = (real)(r * std::sin(phi));
+    }
+
+    // The last odd value is dropped
+    size_t n = std::min(BATCH, count - offset);
+    for (size_t i = 0; i < n; i++)
+    { res[offset + i] = tmp[i]; }
+  }
+}
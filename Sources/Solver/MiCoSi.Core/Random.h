@@ -52,16 +52,106 @@ class MersenneTwisterGenerator
     uint32_t Max() const;
 };
 
+// Counter-based generator Philox4x32-10 (J. Salmon et al, "Parallel random numbers: as easy as 1, 2, 3")
+// Each block of four numbers is a bijection of (key, counter), so any position of the stream is computed
+// directly, the state is just a few integers and doesn't depend on the order of previous draws
+class PhiloxGenerator
+{
+  public:
+    struct State
+    {
+      uint32_t key[2];      // seed and index of the stream
+      uint64_t counter;     // index of the next block
+      uint32_t used;        // count of the consumed numbers of the current block
+      uint32_t block[4];    // current block, it's a cache that is restored from the counter
+
+      bool operator ==(const State &other) const
+      {
+        return key[0] == other.key[0] && key[1] == other.key[1] &&
+               counter == other.counter && used == other.used;
+      }
+
+      bool operator !=(const State &other) const
+      { return !(*this == other); }
+    };
+
+    PhiloxGenerator() = default;
+    PhiloxGenerator(const PhiloxGenerator &) = delete;
+    PhiloxGenerator &operator =(const PhiloxGenerator &) = delete;
+
+    void Initialize(State &state) const;
+
+    void Initialize(State &state, uint32_t seed) const;
+
+    // Creates the 'stream'-th stream for the seed, e.g. (seed of cell, index of MT)
+    void Initialize(State &state, uint32_t seed, uint32_t stream) const;
+
+    void Multiply(State &oldState, std::vector<State> &newStates) const;
+
+    std::string Serialize(const State &state) const;
+
+    void Deserialize(std::string serialized, State &state) const;
+
+    uint32_t Next(State &state) const;
+
+    uint32_t Max() const;
+
+    // Moves the stream forward by 'count' numbers without generating them
+    void Skip(State &state, uint64_t count) const;
+
+    // Computes one block of the stream
+    static void Block(const uint32_t key[2], uint64_t counter, uint32_t res[4]);
+};
+
+// Light-weight generator for the independent substreams of some parent RNG
+// Substream is identified by the seed (taken from the parent) and by the key (e.g. MT's index),
+// so different substreams may be consumed concurrently and in any order
+class SubstreamGenerator
+{
+  public:
+    struct State
+    {
+      uint64_t value;
+    };
+
+    SubstreamGenerator() = default;
+    SubstreamGenerator(const SubstreamGenerator &) = delete;
+    SubstreamGenerator &operator =(const SubstreamGenerator &) = delete;
+
+    // Both methods are inlined, so loops over substreams can be vectorized
+    void Initialize(State &state, uint32_t seed, uint32_t key) const
+    { state.value = Mix(((uint64_t)seed << 32) | key); }
+
+    uint32_t Next(State &state) const
+    {
+      state.value += 0x9E3779B97F4A7C15ull;
+      return (uint32_t)(Mix(state.value) >> 32);
+    }
+
+    uint32_t Max() const;
+
+    // Finalizer of the SplitMix64 generator, scatters close values over the whole range
+    static uint64_t Mix(uint64_t z)
+    {
+      z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+      z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+      return z ^ (z >> 31);
+    }
+};
+
 // Extends our simple RNG and provides some useful methods
 class Random
 {
   public:
 #if defined(MICOSI_RNG_LCG)
     typedef CongruentialGenerator Generator;
+#elif defined(MICOSI_RNG_PHILOX)
+    typedef PhiloxGenerator Generator;
 #else
     typedef MersenneTwisterGenerator Generator;
 #endif
     typedef Generator::State State;
+    typedef SubstreamGenerator::State Substream;
 
     Random() = delete;
     Random(const Random &) = delete;
@@ -78,6 +168,19 @@ class Random
     static inline real NextReal(State &state, real lo, real hi)
     { return NextReal(state) * (hi - lo) + lo; }
 
+    // Fills array by normally distributed pseudo-random numbers with zero mean and unit variance
+    // Uses Box-Muller transform, so the tails are not truncated, each pair of values requires two draws
+    static void NextNormals(State &state, real *res, size_t count);
+
+    // Returns normally distributed pseudo-random number with zero mean and unit variance
+    // Wastes one draw, prefer 'NextNormals()' for the bulk generation
+    static inline real NextNormal(State &state)
+    {
+      real res;
+      NextNormals(state, &res, 1);
+      return res;
+    }
+
     // Creates a new state that is based on the current time
     static void Initialize(State &state)
     { gen_.Initialize(state); }
@@ -86,6 +189,15 @@ class Random
     static void Initialize(State &state, uint32_t seed)
     { gen_.Initialize(state, seed); }
 
+    // Deterministically creates the 'stream'-th state for the seed, e.g. (user's seed, index of cell)
+    // Unlike 'Multiply()', the state doesn't depend on the other streams and on their count
+    static void Initialize(State &state, uint32_t seed, uint32_t stream)
+    {
+      Substream substream;
+      sub_.Initialize(substream, seed, stream);
+      gen_.Initialize(state, sub_.Next(substream));
+    }
+
     // Deterministically creates new states that are based on the given one
     // May be useful to split some global RNG between parallel threads
     static void Multiply(State &oldState, std::vector<State> &newStates)
@@ -100,6 +212,19 @@ class Random
     static void Deserialize(std::string serialized, State &state)
     { gen_.Deserialize(serialized, state); }
 
+    // Creates substream that doesn't depend on the other substreams with the same seed
+    // Seed must be taken from the parent state via 'Next()', key must be unique for the consumer
+    static void Split(uint32_t seed, uint32_t key, Substream &substream)
+    { sub_.Initialize(substream, seed, key); }
+
+    // Returns uniformly distributed pseudo-random integer from the substream
+    static uint32_t Next(Substream &substream) { return sub_.Next(substream); }
+
+    // Returns uniformly distributed pseudo-random float number from the range [0.0, 1.0]
+    static inline real NextReal(Substream &substream)
+    { return (real)sub_.Next(substream) / sub_.Max(); }
+
   private:
     static Generator gen_;
+    static SubstreamGenerator sub_;
 };
@@ -1,72 +1,124 @@
 #include "SimParams.h"
 #include "Converter.h"
 
+namespace
+{
+
+// Static description of the parameter, see 'SimParameter::Descriptor' for the meaning of fields
+template <class T>
+struct ParamRecord
+{
+  const char *name;
+  bool constant;
+  T defaultVal, multiplierVal;
+  bool hasLower;
+  T lowerVal;
+  bool hasUpper;
+  T upperVal;
+};
+
+// Tables are indexed by the values of enums, the order of rows must be the same
+constexpr ParamRecord<int> INT_PARAMS[] =
+{
+  { "n_mt_total", true, 750, 1, true, 0, false, 0 },             // N_MT_Total
+  { "n_cr_total", true, 23, 1, true, 0, false, 0 },              // N_Cr_Total
+  { "spring_brake_type", false, 0, 1, true, 0, true, 1 },        // Spring_Brake_Type
+  { "spring_brake_mts", false, 25, 1, true, 0, false, 0 },       // Spring_Brake_MTs
+  { "n_nods", true, 676, 1, true, 0, false, 0 },                 // N_Nods
+  { "spring_type", false, 0, 1, true, 0, true, 1 },              // Spring_Type
+  { "frozen_coords", false, 0, 1, true, 0, true, 1 },            // Frozen_Coords
+  { "mt_wrapping", false, 1, 1, true, 0, true, 1 },              // MT_Wrapping
+  { "mt_lateral_attachments", false, 1, 1, true, 0, true, 1 },   // MT_Lateral_Attachments
+  { "n_kmt_max", false, 50, 1, true, 0, false, 0 },              // N_KMT_Max
+  { "normal_sampler", false, 0, 1, true, 0, true, 1 },           // Normal_Sampler: 0 - sum of 12 uniforms (default), 1 - Box-Muller
+  { "free_mt_engine", false, 0, 1, true, 0, true, 1 },           // Free_MT_Engine: 0 - fixed time steps, 1 - event-driven
+  { "micro_substeps", false, 1, 1, true, 1, false, 0 },          // Micro_Substeps: micro steps per iteration, each takes 'dt / micro_substeps'
+  { "macro_period", false, 1, 1, true, 1, false, 0 },            // Macro_Period: iterations per macro step, it takes 'dt * macro_period'
+  { "stop_condition", false, 0, 1, true, 0, true, 3 },           // Stop_Condition: bit mask, 1 - springs are broken, 2 - all kinetochores are amphitelic
+};
+
+constexpr ParamRecord<double> DOUBLE_PARAMS[] =
+{
+  { "l_poles", true, 14.0, 1e-6, true, 0.0, false, 0.0 },                        // L_Poles
+  { "r_cell", true, 8.0, 1e-6, true, 0.0, false, 0.0 },                          // R_Cell
+  { "spring_brake_force", false, 700.0, 1e-12, true, 0.0, false, 0.0 },          // Spring_Brake_Force
+  { "v_pol", false, 12.8, 1e-6 / 60.0, true, 0.0, false, 0.0 },                  // V_Pol
+  { "v_dep", false, 14.1, 1e-6 / 60.0, true, 0.0, false, 0.0 },                  // V_Dep
+  { "f_cat", false, 0.058, 1.0, true, 0.0, true, 1.0 },                          // F_Cat
+  { "f_res", false, 0.045, 1.0, true, 0.0, true, 1.0 },                          // F_Res
+  { "gamma", false, 0.006, 1e-12 / 1e-9, true, 0.0, false, 0.0 },                // Gamma
+  { "ieta", false, 5700.0, 1e-12 * 1e-9, true, 0.0, false, 0.0 },                // Ieta
+  { "l1", true, 100.0, 1e-9, true, 0.0, false, 0.0 },                            // L1
+  { "l3", true, 60.0, 1e-9, true, 0.0, false, 0.0 },                             // L3
+  { "eps", false, 0.05, 1.0, true, 0.0, true, 1.0 },                             // Eps
+  { "k_on", false, 1.0, 1.0, true, 0.0, false, 0.0 },                            // K_On
+  { "k_off", false, 4.0, 1.0, true, 0.0, false, 0.0 },                           // K_Off
+  { "dt", false, 0.1, 1.0, true, 1e-3, false, 0.0 },                             // Dt
+  { "t_end", false, 100.0, 1.0, true, 0.0, false, 0.0 },                         // T_End
+  { "save_freq_micro", false, 0.1, 1.0, true, 0.0, false, 0.0 },                 // Save_Freq_Micro
+  { "save_freq_macro", false, 0.1, 1.0, true, 0.0, false, 0.0 },                 // Save_Freq_Macro
+  { "cr_l", true, 5.0, 1e-6, true, 0.0, false, 0.0 },                            // Cr_L
+  { "cr_kin_l", true, 0.5, 1e-6, true, 0.0, false, 0.0 },                        // Cr_Kin_L
+  { "cr_kin_d", true, 0.3, 1e-6, true, 0.0, false, 0.0 },                        // Cr_Kin_D
+  { "cr_kin_angle", true, 115.0, PI / 180.0, true, 0.0, true, 180.0 },           // Cr_Kin_Angle
+  { "cr_hand_d", true, 0.5, 1e-6, true, 0.0, false, 0.0 },                       // Cr_Hand_D
+  { "const_a", false, 45, 1e-12, true, 0.0, false, 0.0 },                        // Const_A
+  { "const_b", false, 45 / 12.8, 1e-12 * 60.0 / 1e-6, true, 0.0, false, 0.0 },   // Const_B
+  { "d_trans", false, 0.01, 1e-9 * 1e-9, true, 0.0, false, 0.0 },                // D_Trans
+  { "d_rot", false, 1.5 * 1e-3, 1.0, true, 0.0, false, 0.0 },                    // D_Rot
+  { "spring_length", true, 0.0, 1e-6, true, 0.0, false, 0.0 },                   // Spring_Length
+  { "spring_k", false, 500.0, 1e-6, true, 20.0, false, 0.0 },                    // Spring_K
+};
+
+static_assert(sizeof(INT_PARAMS) / sizeof(INT_PARAMS[0]) == SimParameter::Int::Count,
+              "table of int parameters doesn't match the enum");
+static_assert(sizeof(DOUBLE_PARAMS) / sizeof(DOUBLE_PARAMS[0]) == SimParameter::Double::Count,
+              "table of double parameters doesn't match the enum");
+
+} // unnamed namespace
+
 //-------------------------
 //--- SimParameter::Int ---
 //-------------------------
 
-SimParameter::BaseType<SimParameter::Int::Type, int> *SimParameter::Int::_ref = nullptr;
+const size_t SimParameter::Int::Count;
 
-void SimParameter::Int::SafeInit()
+const SimParameter::BaseType<SimParameter::Int::Type, int> &SimParameter::Int::Ref()
 {
-  if (_ref != nullptr)
-    return;
-
-  _ref = new BaseType<Type, int>();
-  _ref->Register(Int::N_MT_Total, Descriptor<int>("n_mt_total", true, 750, 1, true, 0, false, 0));
-  _ref->Register(Int::N_Cr_Total, Descriptor<int>("n_cr_total", true, 23, 1, true, 0, false, 0));
-  _ref->Register(Int::Spring_Brake_Type, Descriptor<int>("spring_brake_type", false, 0, 1, true, 0, true, 1));
-  _ref->Register(Int::Spring_Brake_MTs, Descriptor<int>("spring_brake_mts", false, 25, 1, true, 0, false, 0));
-  _ref->Register(Int::N_Nods, Descriptor<int>("n_nods", true, 676, 1, true, 0, false, 0));
-  _ref->Register(Int::Spring_Type, Descriptor<int>("spring_type", false, 0, 1, true, 0, true, 1));
-  _ref->Register(Int::Frozen_Coords, Descriptor<int>("frozen_coords", false, 0, 1, true, 0, true, 1));
-  _ref->Register(Int::MT_Wrapping, Descriptor<int>("mt_wrapping", false, 1, 1, true, 0, true, 1));
-  _ref->Register(Int::MT_Lateral_Attachments, Descriptor<int>("mt_lateral_attachments",
-                                                              false, 1, 1, true, 0, true, 1));
-  _ref->Register(Int::N_KMT_Max, Descriptor<int>("n_kmt_max", false, 50, 1, true, 0, false, 0));
+  static const BaseType<Type, int> ref = []()
+  {
+    BaseType<Type, int> res;
+    for (size_t i = 0; i < Count; i++)
+    {
+      const ParamRecord<int> &r = INT_PARAMS[i];
+      res.Register((Type)i, Descriptor<int>(r.name, r.constant, r.defaultVal, r.multiplierVal,
+                                            r.hasLower, r.lowerVal, r.hasUpper, r.upperVal));
+    }
+    return res;
+  }();
+  return ref;
 }
 
 //----------------------------
 //--- SimParameter::Double ---
 //----------------------------
 
-SimParameter::BaseType<SimParameter::Double::Type, double> *SimParameter::Double::_ref = nullptr;
+const size_t SimParameter::Double::Count;
 
-void SimParameter::Double::SafeInit()
+const SimParameter::BaseType<SimParameter::Double::Type, double> &SimParameter::Double::Ref()
 {
-  if (_ref != nullptr)
-    return;
-
-  _ref = new BaseType<Type, double>();
-  _ref->Register(Double::L_Poles, Descriptor<double>("l_poles", true, 14.0, 1e-6, true, 0.0, false, 0.0));
-  _ref->Register(Double::R_Cell, Descriptor<double>("r_cell", true, 8.0, 1e-6, true, 0.0, false, 0.0));
-  _ref->Register(Double::Spring_Brake_Force, Descriptor<double>("spring_brake_force", false, 700.0, 1e-12, true, 0.0, false, 0.0));
-  _ref->Register(Double::V_Pol, Descriptor<double>("v_pol", false, 12.8, 1e-6 / 60.0, true, 0.0, false, 0.0));
-  _ref->Register(Double::V_Dep, Descriptor<double>("v_dep", false, 14.1, 1e-6 / 60.0, true, 0.0, false, 0.0));
-  _ref->Register(Double::F_Cat, Descriptor<double>("f_cat", false, 0.058, 1.0, true, 0.0, true, 1.0));
-  _ref->Register(Double::F_Res, Descriptor<double>("f_res", false, 0.045, 1.0, true, 0.0, true, 1.0));
-  _ref->Register(Double::Gamma, Descriptor<double>("gamma", false, 0.006, 1e-12 / 1e-9, true, 0.0, false, 0.0));
-  _ref->Register(Double::Ieta, Descriptor<double>("ieta", false, 5700.0, 1e-12 * 1e-9, true, 0.0, false, 0.0));
-  _ref->Register(Double::L1, Descriptor<double>("l1", true, 100.0, 1e-9, true, 0.0, false, 0.0));
-  _ref->Register(Double::L3, Descriptor<double>("l3", true, 60.0, 1e-9, true, 0.0, false, 0.0));
-  _ref->Register(Double::Eps, Descriptor<double>("eps", false, 0.05, 1.0, true, 0.0, true, 1.0));
-  _ref->Register(Double::K_On, Descriptor<double>("k_on", false, 1.0, 1.0, true, 0.0, false, 0.0));
-  _ref->Register(Double::K_Off, Descriptor<double>("k_off", false, 4.0, 1.0, true, 0.0, false, 0.0));
-  _ref->Register(Double::Dt, Descriptor<double>("dt", false, 0.1, 1.0, true, 1e-3, false, 0.0));
-  _ref->Register(Double::T_End, Descriptor<double>("t_end", false, 100.0, 1.0, true, 0.0, false, 0.0));
-  _ref->Register(Double::Save_Freq_Micro, Descriptor<double>("save_freq_micro", false, 0.1, 1.0, true, 0.0, false, 0.0));
-  _ref->Register(Double::Save_Freq_Macro, Descriptor<double>("save_freq_macro", false, 0.1, 1.0, true, 0.0, false, 0.0));
-  _ref->Register(Double::Cr_L, Descriptor<double>("cr_l", true, 5.0, 1e-6, true, 0.0, false, 0.0));
-  _ref->Register(Double::Cr_Kin_L, Descriptor<double>("cr_kin_l", true, 0.5, 1e-6, true, 0.0, false, 0.0));
-  _ref->Register(Double::Cr_Kin_D, Descriptor<double>("cr_kin_d", true, 0.3, 1e-6, true, 0.0, false, 0.0));
-  _ref->Register(Double::Cr_Kin_Angle, Descriptor<double>("cr_kin_angle", true, 115.0, PI / 180.0, true, 0.0, true, 180.0));
-  _ref->Register(Double::Cr_Hand_D, Descriptor<double>("cr_hand_d", true, 0.5, 1e-6, true, 0.0, false, 0.0));
-  _ref->Register(Double::Const_A, Descriptor<double>("const_a", false, 45, 1e-12, true, 0.0, false, 0.0));
-  _ref->Register(Double::Const_B, Descriptor<double>("const_b", false, 45 / 12.8, 1e-12 * 60.0 / 1e-6, true, 0.0, false, 0.0));
-  _ref->Register(Double::D_Trans, Descriptor<double>("d_trans", false, 0.01, 1e-9 * 1e-9, true, 0.0, false, 0.0));
-  _ref->Register(Double::D_Rot, Descriptor<double>("d_rot", false, 1.5 * 1e-3, 1.0, true, 0.0, false, 0.0));
-  _ref->Register(Double::Spring_Length, Descriptor<double>("spring_length", true, 0.0, 1e-6, true, 0.0, false, 0.0));
-  _ref->Register(Double::Spring_K, Descriptor<double>("spring_k", false, 500.0, 1e-6, true, 20.0, false, 0.0));
+  static const BaseType<Type, double> ref = []()
+  {
+    BaseType<Type, double> res;
+    for (size_t i = 0; i < Count; i++)
+    {
+      const ParamRecord<double> &r = DOUBLE_PARAMS[i];
+      res.Register((Type)i, Descriptor<double>(r.name, r.constant, r.defaultVal, r.multiplierVal,
+                                               r.hasLower, r.lowerVal, r.hasUpper, r.upperVal));
+    }
+    return res;
+  }();
+  return ref;
 }
 
 //-----------------
@@ -76,7 +128,7 @@ void SimParameter::Double::SafeInit()
 SimParams::SimParams()
   : _access(Access::Initialize)
 {
-  //Cannot call SetDefault() because we need to initialize maps.
+  //Cannot call SetDefault() because we need to initialize arrays.
   {
     const std::vector<SimParameter::Int::Type> &intParams = SimParameter::Int::All();
     for (size_t i = 0; i < intParams.size(); i++)
@@ -94,10 +146,9 @@ SimParams::SimParams()
 
 int SimParams::GetParameter(SimParameter::Int::Type type) const
 {
-  auto iter = _intValues.find(type);
-  if (iter == _intValues.end())
+  if ((size_t)type >= SimParameter::Int::Count)
     throw std::runtime_error("Wrong type of parameter");
-  return iter->second;
+  return _intValues[type];
 }
 
 void SimParams::SetParameter(SimParameter::Int::Type type, int value)
@@ -105,8 +156,7 @@ void SimParams::SetParameter(SimParameter::Int::Type type, int value)
   if (_access == Access::ReadOnly)
     throw std::runtime_error("The value of parameter cannot be changed due to read-only restriction");
 
-  auto iter = _intValues.find(type);
-  if (iter == _intValues.end())
+  if ((size_t)type >= SimParameter::Int::Count)
     throw std::runtime_error("Wrong type of parameter");
   if (_access == Access::Update && SimParameter::Int::Info(type).Constant() && _intValues[type] != value)
     throw std::runtime_error("Cannot set value for constant (not changeable) parameter");
@@ -115,10 +165,10 @@ void SimParams::SetParameter(SimParameter::Int::Type type, int value)
 
 double SimParams::GetParameter(SimParameter::Double::Type type, bool convertToSI) const
 {
-  auto iter = _doubleValues.find(type);
-  if (iter == _doubleValues.end())
+  if ((size_t)type >= SimParameter::Double::Count)
     throw std::runtime_error("Wrong type of parameter");
-  return convertToSI ? iter->second * SimParameter::Double::Info(type).SiMultiplier() : iter->second;
+  double value = _doubleValues[type];
+  return convertToSI ? value * SimParameter::Double::Info(type).SiMultiplier() : value;
 }
 
 void SimParams::SetParameter(SimParameter::Double::Type type, double value, bool isSI)
@@ -126,8 +176,7 @@ void SimParams::SetParameter(SimParameter::Double::Type type, double value, bool
   if (_access == Access::ReadOnly)
     throw std::runtime_error("The value of parameter cannot be changed due to read-only restriction");
 
-  auto iter = _doubleValues.find(type);
-  if (iter == _doubleValues.end())
+  if ((size_t)type >= SimParameter::Double::Count)
     throw std::runtime_error("Wrong type of parameter");
   value = isSI ? value / SimParameter::Double::Info(type).SiMultiplier() : value;
   if (_access == Access::Update && SimParameter::Double::Info(type).Constant() && _doubleValues[type] != value)
@@ -177,6 +226,19 @@ void SimParams::SetParameter(const std::string &name, const std::string &value,
   throw std::runtime_error("Parameter with such name is not known");
 }
 
+SimParamsSnapshot SimParams::Snapshot() const
+{
+  SimParamsSnapshot res;
+  for (size_t i = 0; i < SimParameter::Int::Count; i++)
+    res.ints[i] = _intValues[i];
+  for (size_t i = 0; i < SimParameter::Double::Count; i++)
+  {
+    res.exact[i] = _doubleValues[i] * SimParameter::Double::Info((SimParameter::Double::Type)i).SiMultiplier();
+    res.doubles[i] = (real)res.exact[i];
+  }
+  return res;
+}
+
 void SimParams::SetDefault()
 {
   {
@@ -196,15 +258,15 @@ std::vector<std::pair<std::string, std::string> > SimParams::ExportValues() cons
 {
   std::vector<std::pair<std::string, std::string> > res;
   {
-    for (auto iter = _intValues.begin(); iter != _intValues.end(); iter++)
-      res.push_back(std::make_pair(SimParameter::Int::Info(iter->first).Name(),
-                     Converter::ToString(iter->second)));
+    for (size_t i = 0; i < SimParameter::Int::Count; i++)
+      res.push_back(std::make_pair(SimParameter::Int::Info((SimParameter::Int::Type)i).Name(),
+                     Converter::ToString(_intValues[i])));
   }
 
   {
-    for (auto iter = _doubleValues.begin(); iter != _doubleValues.end(); iter++)
-      res.push_back(std::make_pair(SimParameter::Double::Info(iter->first).Name(),
-                       Converter::ToString(iter->second)));
+    for (size_t i = 0; i < SimParameter::Double::Count; i++)
+      res.push_back(std::make_pair(SimParameter::Double::Info((SimParameter::Double::Type)i).Name(),
+                       Converter::ToString(_doubleValues[i])));
   }
 
   return res;
@@ -65,7 +65,7 @@ class SimParameter
 
         // Returns true and sets lower boundary (if applicable, false otherwise)
         bool HasLowerBoundary(T &lower) const
-        { _lower = lower; return _hasLower; }
+        { lower = _lower; return _hasLower; }
 
       friend class Int;
       friend class Double;
@@ -73,17 +73,20 @@ class SimParameter
 
   private:
     // Base class with common logic for Int and Double sub-classes
+    // Descriptors are stored in a flat array indexed by the values of enum
     template <class T1, class T2>
     class BaseType
     {
       private:
         std::vector<T1> _all;
-        std::map<T1, Descriptor<T2> > _descs;
+        std::vector<Descriptor<T2> > _descs;
         std::map<std::string, T1> _names;
 
       public:
-        void Register(T1 type, class Descriptor<T2> &desc)
+        void Register(T1 type, const Descriptor<T2> &desc)
         {
+          if ((size_t)type >= _descs.size())
+            _descs.resize((size_t)type + 1);
           _all.push_back(type);
           _descs[type] = desc;
           _names[desc.Name()] = type;
@@ -106,10 +109,9 @@ class SimParameter
 
         const Descriptor<T2> &Info(T1 param) const
         {
-          auto iter = _descs.find(param);
-          if (iter == _descs.end())
+          if ((size_t)param >= _descs.size())
             throw std::runtime_error("Such parameter is not known");
-          return iter->second;
+          return _descs[param];
         }
     };
 
@@ -135,25 +137,33 @@ class SimParameter
           Frozen_Coords             = 6,
           MT_Wrapping               = 7,
           MT_Lateral_Attachments    = 8,
-          N_KMT_Max                 = 9
+          N_KMT_Max                 = 9,
+          Normal_Sampler            = 10,
+          Free_MT_Engine            = 11,
+          Micro_Substeps            = 12,
+          Macro_Period              = 13,
+          Stop_Condition            = 14
         };
 
+        // Count of parameters, all values of 'Type' are less than it
+        static const size_t Count = 15;
+
       private:
-        static BaseType<Type, int> *_ref;
-        static void SafeInit();
+        // Registry is created once, on the first call (thread-safe)
+        static const BaseType<Type, int> &Ref();
 
       public:
         // Returns all available int-based parameters
         static const std::vector<Type> &All()
-        { SafeInit(); return _ref->All(); }
+        { return Ref().All(); }
 
         // Tries to parse name and return the corresponding parameter
         static bool TryParse(std::string str, Type &res)
-        { SafeInit(); return _ref->TryParse(str, res); }
+        { return Ref().TryParse(str, res); }
 
         // Returns information about parameter
         static const Descriptor<int> &Info(Type param)
-        { SafeInit(); return _ref->Info(param); }
+        { return Ref().Info(param); }
     };
 
     // Double-based parameters - values, lengthes, coefficients, etc
@@ -198,25 +208,47 @@ class SimParameter
           Spring_K             = 28
         };
 
+        // Count of parameters, all values of 'Type' are less than it
+        static const size_t Count = 29;
+
       private:
-        static BaseType<Type, double> *_ref;
-        static void SafeInit();
+        // Registry is created once, on the first call (thread-safe)
+        static const BaseType<Type, double> &Ref();
 
       public:
         // Returns all available double-based parameters
         static const std::vector<Type> &All()
-        { SafeInit(); return _ref->All(); }
+        { return Ref().All(); }
 
         // Tries to parse name and return the corresponding parameter
         static bool TryParse(std::string str, Type &res)
-        { SafeInit(); return _ref->TryParse(str, res); }
+        { return Ref().TryParse(str, res); }
 
         // Returns information about parameter
         static const Descriptor<double> &Info(Type param)
-        { SafeInit(); return _ref->Info(param); }
+        { return Ref().Info(param); }
     };
 };
 
+// Plain copy of the parameters, is made once per iteration and is passed to all steps
+// Doubles are already converted to SI and to 'real', so reading is lock-free and cannot fail
+struct SimParamsSnapshot
+{
+  int ints[SimParameter::Int::Count];
+  real doubles[SimParameter::Double::Count];
+  double exact[SimParameter::Double::Count];    // the same values in double precision
+
+  int operator [](SimParameter::Int::Type type) const
+  { return ints[type]; }
+
+  real operator [](SimParameter::Double::Type type) const
+  { return doubles[type]; }
+
+  // Derived constants are computed in double precision and only then converted to 'real'
+  double Exact(SimParameter::Double::Type type) const
+  { return exact[type]; }
+};
+
 // Class that provides values of the simulation parameters
 class SimParams
 {
@@ -236,8 +268,8 @@ class SimParams
 
   private:
     Access::Type _access;
-    std::map<SimParameter::Int::Type, int> _intValues;
-    std::map<SimParameter::Double::Type, double> _doubleValues;
+    int _intValues[SimParameter::Int::Count];
+    double _doubleValues[SimParameter::Double::Count];
 
     SimParams(const SimParams &) = delete;
     void operator =(const SimParams &) = delete;
@@ -253,6 +285,9 @@ class SimParams
     std::string GetParameter(const std::string &name, bool convertToSI = false) const;
     void SetParameter(const std::string &name, const std::string &value, bool isSI = false);
 
+    // Copies all values to the flat structure, doubles are converted to SI
+    SimParamsSnapshot Snapshot() const;
+
     // Sets new mode for container
     void SetAccess(Access::Type access)
     { _access = access; }
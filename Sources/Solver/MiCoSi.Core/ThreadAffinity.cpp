@@ -0,0 +1,51 @@
+#include "ThreadAffinity.h"
+
+#ifdef WIN32
+#define NOMINMAX    // otherwise macros of 'windows.h' break 'std::max()'
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+//----------------------
+//--- ThreadAffinity ---
+//----------------------
+
+int ThreadAffinity::Processors()
+{
+#ifdef WIN32
+  return std::max(1, (int)GetActiveProcessorCount(ALL_PROCESSOR_GROUPS));
+#else
+  return std::max(1, (int)sysconf(_SC_NPROCESSORS_ONLN));
+#endif
+}
+
+bool ThreadAffinity::PinCurrentThread(int index)
+{
+  int processor = index % Processors();
+
+#ifdef WIN32
+  // Machines with more than 64 processors have several groups, the processor is found by its global index
+  WORD groups = GetActiveProcessorGroupCount();
+  for (WORD g = 0; g < groups; g++)
+  {
+    int count = (int)GetActiveProcessorCount(g);
+    if (processor < count)
+    {
+      GROUP_AFFINITY affinity = {};
+      affinity.Group = g;
+      affinity.Mask = (KAFFINITY)1 << processor;
+      return SetThreadGroupAffinity(GetCurrentThread(), &affinity, nullptr) != 0;
+    }
+    processor -= count;
+  }
+  return false;
+#else
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(processor, &set);
+  return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#endif
+}
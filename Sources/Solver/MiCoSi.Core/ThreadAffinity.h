@@ -0,0 +1,19 @@
+#pragma once
+#include "Defs.h"
+
+// Binds threads to logical processors, so the OS doesn't migrate them between cores and NUMA nodes
+// Processors are enumerated as the OS does, i.e. processors of the same node (or group) are adjacent
+class ThreadAffinity
+{
+  public:
+    ThreadAffinity() = delete;
+    ThreadAffinity(const ThreadAffinity &) = delete;
+    ThreadAffinity &operator =(const ThreadAffinity &) = delete;
+
+    // Count of logical processors in all groups
+    static int Processors();
+
+    // Binds the calling thread to the processor ('index' modulo count of processors)
+    // Returns false if the OS has rejected the request, the thread stays unbound in this case
+    static bool PinCurrentThread(int index);
+};
@@ -17,7 +17,7 @@ std::string Version::ToString() const
 //----------------------
 
 Version *CurrentVersion::_programVersion = new Version(0, 9, 2, "January, 2021");
-int CurrentVersion::_fileFormatVersion = 2;
+int CurrentVersion::_fileFormatVersion = 4;
 
 std::string CurrentVersion::CompilationFlags()
 {
@@ -33,6 +33,8 @@ std::string CurrentVersion::CompilationFlags()
   flags.emplace_back("MICOSI_RNG_LCG");
 #elif defined(MICOSI_RNG_MTG)
   flags.emplace_back("MICOSI_RNG_MTG");
+#elif defined(MICOSI_RNG_PHILOX)
+  flags.emplace_back("MICOSI_RNG_PHILOX");
 #endif
 
   std::ostringstream ss;
@@ -45,3 +47,21 @@ std::string CurrentVersion::CompilationFlags()
 
   return ss.str();
 }
+
+const char *CurrentVersion::Precision()
+{
+#if defined(MICOSI_PRECISION_FP64)
+  return "fp64";
+#else
+  return "fp32";
+#endif
+}
+
+const char *CurrentVersion::Precision(const std::string &flags)
+{
+  if (flags.find("MICOSI_PRECISION_FP64") != std::string::npos)
+  { return "fp64"; }
+  else if (flags.find("MICOSI_PRECISION_FP32") != std::string::npos)
+  { return "fp32"; }
+  return nullptr;
+}
@@ -98,8 +98,19 @@ class CurrentVersion
     static const int FileFormatVersion()
     { return _fileFormatVersion; }
 
+    // Files of the older formats up to this one are still opened and continued
+    static const int OldestFileFormatVersion()
+    { return 2; }
+
     static std::string CompilationFlags();
 
+    // Precision of the current engine, "fp32" or "fp64"
+    // Engines of both precisions are built together, see "--precision" option of the application
+    static const char *Precision();
+
+    // Extracts precision from the compilation flags of some file, returns nullptr if there is no such flag
+    static const char *Precision(const std::string &flags);
+
   private:
     static Version *_programVersion;
     static int _fileFormatVersion;
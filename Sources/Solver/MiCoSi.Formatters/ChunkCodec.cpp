@@ -0,0 +1,409 @@
+#include "ChunkCodec.h"
+
+#include <queue>
+
+namespace
+{
+
+//--- Stages of the delta codec ---
+
+// Frames are XOR-ed with the previous ones, so the unchanged values become zeros
+// Encoding goes backward and decoding goes forward, so the previous frame is always the original one
+void XorFrames(uint8_t *data, size_t size, const std::vector<FrameFormat::FrameRecord> &frames, bool encode)
+{
+  for (size_t n = 1; n < frames.size(); n++)
+  {
+    size_t k = encode ? frames.size() - n : n;
+    const FrameFormat::FrameRecord &cur = frames[k], &prev = frames[k - 1];
+    if (cur.offset > size || cur.size > size - cur.offset ||
+        prev.offset > size || prev.size > size - prev.offset)
+    { throw std::runtime_error("File with cell is corrupted. Frame is out of chunk"); }
+
+    size_t len = (size_t)std::min(cur.size, prev.size);
+    uint8_t *dst = data + cur.offset;
+    const uint8_t *src = data + prev.offset;
+    for (size_t i = 0; i < len; i++)
+    { dst[i] ^= src[i]; }
+  }
+}
+
+// Groups bytes by their positions in words, so the rarely changed high bytes form long zero runs
+void Shuffle(const uint8_t *src, uint8_t *dst, size_t size, size_t width)
+{
+  size_t count = size / width;
+  for (size_t b = 0; b < width; b++)
+  {
+    for (size_t i = 0; i < count; i++)
+    { dst[b * count + i] = src[i * width + b]; }
+  }
+  memcpy(dst + count * width, src + count * width, size - count * width);
+}
+
+void Unshuffle(const uint8_t *src, uint8_t *dst, size_t size, size_t width)
+{
+  size_t count = size / width;
+  for (size_t b = 0; b < width; b++)
+  {
+    for (size_t i = 0; i < count; i++)
+    { dst[i * width + b] = src[b * count + i]; }
+  }
+  memcpy(dst + count * width, src + count * width, size - count * width);
+}
+
+void WriteVarint(std::vector<uint8_t> &out, uint64_t value)
+{
+  while (value >= 0x80)
+  {
+    out.push_back((uint8_t)(value | 0x80));
+    value >>= 7;
+  }
+  out.push_back((uint8_t)value);
+}
+
+uint64_t ReadVarint(const uint8_t *&p, const uint8_t *end)
+{
+  uint64_t value = 0;
+  for (int shift = 0; shift < 64; shift += 7)
+  {
+    if (p == end)
+    { throw std::runtime_error("File with cell is corrupted. Cannot decode chunk"); }
+    uint8_t b = *p++;
+    value |= (uint64_t)(b & 0x7f) << shift;
+    if ((b & 0x80) == 0)
+    { return value; }
+  }
+  throw std::runtime_error("File with cell is corrupted. Cannot decode chunk");
+}
+
+// Shorter runs of zeros are cheaper as literals
+const size_t MIN_ZERO_RUN = 4;
+
+// Data is coded as pairs of "literals" and "zeros" records, each record starts with its length
+void EncodeZeroRuns(const uint8_t *src, size_t size, std::vector<uint8_t> &out)
+{
+  size_t i = 0;
+  while (i < size)
+  {
+    size_t start = i, run = 0;
+    while (i < size)
+    {
+      if (src[i] != 0)
+      {
+        i++;
+        continue;
+      }
+      size_t j = i;
+      while (j < size && src[j] == 0)
+      { j++; }
+      if (j - i >= MIN_ZERO_RUN || j == size)
+      {
+        run = j - i;
+        break;
+      }
+      i = j;
+    }
+
+    WriteVarint(out, i - start);
+    out.insert(out.end(), src + start, src + i);
+    WriteVarint(out, run);
+    i += run;
+  }
+}
+
+void DecodeZeroRuns(const uint8_t *src, size_t srcSize, uint8_t *dst, size_t dstSize)
+{
+  const uint8_t *p = src, *end = src + srcSize;
+  size_t pos = 0;
+  while (pos < dstSize)
+  {
+    uint64_t literals = ReadVarint(p, end);
+    if (literals > dstSize - pos || literals > (uint64_t)(end - p))
+    { throw std::runtime_error("File with cell is corrupted. Cannot decode chunk"); }
+    memcpy(dst + pos, p, (size_t)literals);
+    p += literals;
+    pos += (size_t)literals;
+
+    uint64_t zeros = ReadVarint(p, end);
+    if (zeros > dstSize - pos || (literals == 0 && zeros == 0))
+    { throw std::runtime_error("File with cell is corrupted. Cannot decode chunk"); }
+    memset(dst + pos, 0, (size_t)zeros);
+    pos += (size_t)zeros;
+  }
+}
+
+// Longer codes are not needed for 256 symbols and keep the decoding table small
+const int MAX_BITS = 15;
+
+// Builds lengths of Huffman codes, frequencies are flattened until the codes fit 'MAX_BITS'
+void BuildLengths(const uint64_t freq[256], uint8_t lengths[256])
+{
+  struct Node
+  {
+    uint64_t weight;
+    int left, right, symbol;
+  };
+  typedef std::pair<uint64_t, int> Item;
+
+  std::vector<uint64_t> weights(freq, freq + 256);
+  while (true)
+  {
+    std::vector<Node> nodes;
+    std::priority_queue<Item, std::vector<Item>, std::greater<Item> > queue;
+    memset(lengths, 0, 256);
+    for (int s = 0; s < 256; s++)
+    {
+      if (weights[s] > 0)
+      {
+        Node leaf = { weights[s], -1, -1, s };
+        queue.push(Item(weights[s], (int)nodes.size()));
+        nodes.push_back(leaf);
+      }
+    }
+    if (nodes.empty())
+    { return; }
+    if (nodes.size() == 1)
+    {
+      lengths[nodes[0].symbol] = 1;
+      return;
+    }
+
+    while (queue.size() > 1)
+    {
+      Item a = queue.top();
+      queue.pop();
+      Item b = queue.top();
+      queue.pop();
+      Node node = { a.first + b.first, a.second, b.second, -1 };
+      queue.push(Item(node.weight, (int)nodes.size()));
+      nodes.push_back(node);
+    }
+
+    int maxDepth = 0;
+    std::vector<std::pair<int, int> > stack(1, std::make_pair(queue.top().second, 0));
+    while (!stack.empty())
+    {
+      std::pair<int, int> cur = stack.back();
+      stack.pop_back();
+      const Node &node = nodes[cur.first];
+      if (node.symbol >= 0)
+      {
+        lengths[node.symbol] = (uint8_t)std::min(cur.second, 255);
+        maxDepth = std::max(maxDepth, cur.second);
+      }
+      else
+      {
+        stack.push_back(std::make_pair(node.left, cur.second + 1));
+        stack.push_back(std::make_pair(node.right, cur.second + 1));
+      }
+    }
+    if (maxDepth <= MAX_BITS)
+    { return; }
+
+    for (int s = 0; s < 256; s++)
+    {
+      if (weights[s] > 0)
+      { weights[s] = (weights[s] + 1) / 2; }
+    }
+  }
+}
+
+// Canonical codes with the reversed order of bits, the bit stream starts from the lowest bits
+void BuildCodes(const uint8_t lengths[256], uint16_t codes[256])
+{
+  int count[MAX_BITS + 1] = { 0 };
+  for (int s = 0; s < 256; s++)
+  { count[lengths[s]]++; }
+  count[0] = 0;
+
+  uint32_t next[MAX_BITS + 1] = { 0 };
+  uint32_t code = 0;
+  for (int len = 1; len <= MAX_BITS; len++)
+  {
+    code = (code + count[len - 1]) << 1;
+    next[len] = code;
+  }
+
+  for (int s = 0; s < 256; s++)
+  {
+    codes[s] = 0;
+    int len = lengths[s];
+    if (len == 0)
+    { continue; }
+    uint32_t c = next[len]++, reversed = 0;
+    for (int i = 0; i < len; i++)
+    { reversed |= ((c >> i) & 1) << (len - 1 - i); }
+    codes[s] = (uint16_t)reversed;
+  }
+}
+
+struct DeltaHeader
+{
+  uint32_t width;           // of the shuffled words, in bytes
+  uint32_t reserved;
+  uint64_t runsSize;        // size of the data with coded zero runs, it's coded by Huffman codes
+  uint8_t lengths[128];     // of Huffman codes, 4 bits per symbol
+};
+
+class NoneCodec : public IChunkCodec
+{
+  public:
+    virtual Type Id() const override
+    { return None; }
+
+    virtual void Encode(const void *data, size_t sizeInBytes,
+                        const std::vector<FrameFormat::FrameRecord> &frames, MemoryStream &out) const override
+    { out.Write((void *)data, sizeInBytes); }
+
+    virtual void Decode(const void *data, size_t sizeInBytes,
+                        const std::vector<FrameFormat::FrameRecord> &frames,
+                        void *dst, size_t dstSize) const override
+    {
+      if (sizeInBytes != dstSize)
+      { throw std::runtime_error("File with cell is corrupted. Wrong size of chunk"); }
+      memcpy(dst, data, dstSize);
+    }
+};
+
+class DeltaCodec : public IChunkCodec
+{
+  public:
+    virtual Type Id() const override
+    { return Delta; }
+
+    virtual void Encode(const void *data, size_t sizeInBytes,
+                        const std::vector<FrameFormat::FrameRecord> &frames, MemoryStream &out) const override
+    {
+      DeltaHeader header;
+      memset(&header, 0, sizeof(header));
+      header.width = (uint32_t)sizeof(real);
+
+      std::vector<uint8_t> xored((const uint8_t *)data, (const uint8_t *)data + sizeInBytes);
+      std::vector<uint8_t> shuffled(sizeInBytes);
+      std::vector<uint8_t> runs;
+      if (sizeInBytes > 0)
+      {
+        XorFrames(&xored[0], sizeInBytes, frames, true);
+        Shuffle(&xored[0], &shuffled[0], sizeInBytes, header.width);
+        EncodeZeroRuns(&shuffled[0], sizeInBytes, runs);
+      }
+      header.runsSize = runs.size();
+
+      uint64_t freq[256] = { 0 };
+      for (size_t i = 0; i < runs.size(); i++)
+      { freq[runs[i]]++; }
+      uint8_t lengths[256];
+      uint16_t codes[256];
+      BuildLengths(freq, lengths);
+      BuildCodes(lengths, codes);
+      for (int s = 0; s < 256; s += 2)
+      { header.lengths[s / 2] = (uint8_t)(lengths[s] | (lengths[s + 1] << 4)); }
+
+      std::vector<uint8_t> bits;
+      bits.reserve(runs.size() / 2 + 8);
+      uint64_t acc = 0;
+      int count = 0;
+      for (size_t i = 0; i < runs.size(); i++)
+      {
+        acc |= (uint64_t)codes[runs[i]] << count;
+        count += lengths[runs[i]];
+        while (count >= 8)
+        {
+          bits.push_back((uint8_t)acc);
+          acc >>= 8;
+          count -= 8;
+        }
+      }
+      if (count > 0)
+      { bits.push_back((uint8_t)acc); }
+
+      out.Write(&header, sizeof(header));
+      if (!bits.empty())
+      { out.Write(&bits[0], bits.size()); }
+    }
+
+    virtual void Decode(const void *data, size_t sizeInBytes,
+                        const std::vector<FrameFormat::FrameRecord> &frames,
+                        void *dst, size_t dstSize) const override
+    {
+      DeltaHeader header;
+      if (sizeInBytes < sizeof(header))
+      { throw std::runtime_error("File with cell is corrupted. Cannot decode chunk"); }
+      memcpy(&header, data, sizeof(header));
+      const uint8_t *begin = (const uint8_t *)data + sizeof(header);
+      uint64_t bitCount = (uint64_t)(sizeInBytes - sizeof(header)) * 8;
+
+      // Each symbol takes one bit at least
+      if (header.width == 0 || header.width > 16 || header.runsSize > bitCount)
+      { throw std::runtime_error("File with cell is corrupted. Cannot decode chunk"); }
+
+      uint8_t lengths[256];
+      uint16_t codes[256];
+      for (int s = 0; s < 256; s += 2)
+      {
+        lengths[s] = header.lengths[s / 2] & 0x0f;
+        lengths[s + 1] = header.lengths[s / 2] >> 4;
+      }
+      BuildCodes(lengths, codes);
+
+      // Each entry is "symbol | length << 8", zero length marks the codes that are not used
+      std::vector<uint16_t> table((size_t)1 << MAX_BITS, 0);
+      for (int s = 0; s < 256; s++)
+      {
+        int len = lengths[s];
+        if (len == 0)
+        { continue; }
+        for (size_t j = 0; j < ((size_t)1 << (MAX_BITS - len)); j++)
+        { table[codes[s] | (j << len)] = (uint16_t)(s | (len << 8)); }
+      }
+
+      std::vector<uint8_t> runs((size_t)header.runsSize);
+      const uint8_t *p = begin, *end = begin + (sizeInBytes - sizeof(header));
+      uint64_t acc = 0, consumed = 0;
+      int count = 0;
+      for (size_t i = 0; i < runs.size(); i++)
+      {
+        while (count < MAX_BITS)
+        {
+          acc |= (uint64_t)(p < end ? *p++ : 0) << count;
+          count += 8;
+        }
+        uint16_t entry = table[(size_t)(acc & (((uint64_t)1 << MAX_BITS) - 1))];
+        int len = entry >> 8;
+        consumed += len;
+        if (len == 0 || consumed > bitCount)
+        { throw std::runtime_error("File with cell is corrupted. Cannot decode chunk"); }
+        runs[i] = (uint8_t)entry;
+        acc >>= len;
+        count -= len;
+      }
+
+      if (dstSize == 0)
+      { return; }
+      std::vector<uint8_t> shuffled(dstSize);
+      DecodeZeroRuns(runs.empty() ? nullptr : &runs[0], runs.size(), &shuffled[0], dstSize);
+      Unshuffle(&shuffled[0], (uint8_t *)dst, dstSize, header.width);
+      XorFrames((uint8_t *)dst, dstSize, frames, false);
+    }
+};
+
+} // unnamed namespace
+
+//-------------------
+//--- IChunkCodec ---
+//-------------------
+
+const IChunkCodec *IChunkCodec::Get(uint32_t id)
+{
+  static const NoneCodec none;
+  static const DeltaCodec delta;
+
+  switch (id)
+  {
+    case None:
+      return &none;
+    case Delta:
+      return &delta;
+    default:
+      return nullptr;
+  }
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include "MiCoSi.Core/Defs.h"
+
+#include "FrameFormat.h"
+#include "MemoryStream.h"
+
+// Compresses binary data of the chunks with frames, ID of the codec is stored in the chunk's directory
+// Codecs get bounds of frames, so they can use similarity of the successive time layers
+class IChunkCodec
+{
+  public:
+    enum Type : uint32_t
+    {
+      None  = 0,    // frames are stored as is
+      Delta = 1     // XOR with the previous frame, byte shuffling, coding of zero runs and Huffman coding
+    };
+
+    virtual Type Id() const = 0;
+
+    // Appends the encoded data to the stream
+    virtual void Encode(const void *data, size_t sizeInBytes,
+                        const std::vector<FrameFormat::FrameRecord> &frames, MemoryStream &out) const = 0;
+
+    // Restores exactly 'dstSize' bytes, throws exception if the encoded data is corrupted
+    virtual void Decode(const void *data, size_t sizeInBytes,
+                        const std::vector<FrameFormat::FrameRecord> &frames,
+                        void *dst, size_t dstSize) const = 0;
+
+    virtual ~IChunkCodec()
+    { /*nothing*/ }
+
+    // Returns the built-in codec or nullptr, if there is no codec with such ID
+    static const IChunkCodec *Get(uint32_t id);
+};
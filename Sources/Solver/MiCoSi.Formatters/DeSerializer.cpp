@@ -10,6 +10,35 @@
 namespace
 {
 
+// Read-only array inside the loaded data, values are read without copying the whole array
+// The data can be unaligned (e.g. if it's a part of the memory-mapped file), so elements are copied one by one
+template <class T>
+class ArrayView
+{
+  public:
+    ArrayView()
+      : _data(nullptr), _size(0)
+    { /*nothing*/ }
+
+    ArrayView(const void *data, size_t size)
+      : _data((const uint8_t *)data), _size(size)
+    { /*nothing*/ }
+
+    size_t size() const
+    { return _size; }
+
+    T operator [](size_t idx) const
+    {
+      T res;
+      memcpy(&res, _data + idx * sizeof(T), sizeof(T));
+      return res;
+    }
+
+  private:
+    const uint8_t *_data;
+    size_t _size;
+};
+
 class Loader
 {
   public:
@@ -19,11 +48,12 @@ class Loader
     { /*nothing*/ }
     Loader &operator =(const Loader &) = delete;
 
-    void LoadArray(size_t offset, size_t size, void *dst) const
+    template <class T>
+    ArrayView<T> View(size_t offset, size_t size) const
     {
-      if (offset + size > _sizeInBytes)
+      if (offset > _sizeInBytes || size > _sizeInBytes - offset)
       { throw std::runtime_error("Cannot load array"); }
-      memcpy(dst, (uint8_t *)_data + offset, size);
+      return ArrayView<T>((const uint8_t *)_data + offset, size / sizeof(T));
     }
 
   private:
@@ -33,7 +63,7 @@ class Loader
 
 template <class T>
 static void DeserializeArray(const TiXmlElement *node, const char *name,
-                             const Loader &bin, std::vector<T> &arr)
+                             const Loader &bin, ArrayView<T> &arr)
 {
   std::string sName;
   offset_t offset = -1;
@@ -51,12 +81,9 @@ static void DeserializeArray(const TiXmlElement *node, const char *name,
   Converter::Parse(sName.substr(delim+1, len - delim), t[1]);
 
   if (t[0] >= 0 && t[1] > 0)
-  {
-    arr.resize((size_t)(t[1] / sizeof(T)));
-    bin.LoadArray((size_t)t[0], (size_t)t[1], &arr[0]);
-  }
+  { arr = bin.View<T>((size_t)t[0], (size_t)t[1]); }
   else
-  { arr.resize(0); }
+  { arr = ArrayView<T>(); }
 }
 
 double UintToDoubleConverter(const int* buf)
@@ -68,6 +95,142 @@ double UintToDoubleConverter(const int* buf)
   return res;
 }
 
+// Changeable values of the cell that are loaded from a time layer of any format
+// Arrays point to the layer's data, so they are decoded straight into the cell
+struct CellState
+{
+  vec3d leftPole, rightPole;
+  int springBroken;
+  ArrayView<real> lengthes, mtDirs_x, mtDirs_y, mtDirs_z, mtForces_x, mtForces_y, mtForces_z;
+  ArrayView<int> states, boundIDs;
+  ArrayView<real> x, y, z, mat;
+};
+
+// Validates the loaded state and writes it to the cell
+void ApplyCellState(const CellState &s, Cell &cell)
+{
+  cell.SetSpringFlag(s.springBroken != 0);
+  cell.GetPole(PoleType::Left)->Position() = vec3r((real)s.leftPole.x, (real)s.leftPole.y, (real)s.leftPole.z);
+  cell.GetPole(PoleType::Right)->Position() = vec3r((real)s.rightPole.x, (real)s.rightPole.y, (real)s.rightPole.z);
+
+  if (cell.MTs().size() != s.lengthes.size() ||
+      cell.MTs().size() != s.mtDirs_x.size() ||
+      cell.MTs().size() != s.mtDirs_y.size() ||
+      cell.MTs().size() != s.mtDirs_z.size() ||
+      cell.MTs().size() != s.mtForces_x.size() ||
+      cell.MTs().size() != s.mtForces_y.size() ||
+      cell.MTs().size() != s.mtForces_z.size() ||
+      cell.MTs().size() != s.states.size() ||
+      cell.MTs().size() != s.boundIDs.size())
+  {
+    throw std::runtime_error(
+        "File with cell is corrupted. Count of MTs differs in initial configuration and time layer"
+    );
+  }
+
+  int chrSize = (int)cell.Chromosomes().size();
+  for (size_t i = 0; i < s.lengthes.size(); i++)
+  {
+    if (s.boundIDs[i] >= chrSize)
+    { throw std::runtime_error("File with cell is corrupted. Wrong indices of the bound MTs"); }
+  }
+
+  for (size_t i = 0; i < s.lengthes.size(); i++)
+  {
+    MT *mt = cell.MTs()[i];
+    mt->Length() = s.lengthes[i];
+    mt->Direction() = vec3r(s.mtDirs_x[i], s.mtDirs_y[i], s.mtDirs_z[i]);
+    mt->ForceOffset() = vec3r(s.mtForces_x[i], s.mtForces_y[i], s.mtForces_z[i]);
+    mt->State() = s.states[i] == 0 ? MTState::Polymerization : MTState::Depolymerization;
+    if (mt->BoundChromosome() != nullptr)
+    { mt->UnBind(); }
+    if (s.boundIDs[i] >= 0)
+    { mt->Bind(cell.Chromosomes()[s.boundIDs[i]]); }
+  }
+
+  if (cell.Chromosomes().size() != s.x.size() ||
+      cell.Chromosomes().size() != s.y.size() ||
+      cell.Chromosomes().size() != s.z.size() ||
+      cell.Chromosomes().size() * 9 != s.mat.size())
+  {
+    throw std::runtime_error(
+        "File with cell is corrupted. Count of Chromosomes differs in initial configuration and time layer"
+    );
+  }
+
+  const std::vector<Chromosome *> &chrsRef = cell.Chromosomes();
+  for (size_t i = 0; i < cell.Chromosomes().size(); i++)
+  {
+    Chromosome *chrRef = chrsRef[i];
+    chrRef->Position() = vec3r(s.x[i], s.y[i], s.z[i]);
+    chrRef->Orientation() = mat3x3r(s.mat[i * 9 + 0], s.mat[i * 9 + 1], s.mat[i * 9 + 2],
+                                    s.mat[i * 9 + 3], s.mat[i * 9 + 4], s.mat[i * 9 + 5],
+                                    s.mat[i * 9 + 6], s.mat[i * 9 + 7], s.mat[i * 9 + 8]);
+  }
+  cell.GeometryCache().Invalidate();
+}
+
+// Binary frame (see 'FrameFormat') with the validated directory of columns
+class FrameReader
+{
+  public:
+    FrameReader() = delete;
+    FrameReader(const void *data, size_t sizeInBytes)
+      : _data((const uint8_t *)data), _sizeInBytes(sizeInBytes)
+    {
+      if (data == nullptr || sizeInBytes < sizeof(_header))
+      { throw std::runtime_error("File with cell is corrupted. Frame is too small"); }
+      memcpy(&_header, data, sizeof(_header));
+      if (_header.magic != FrameFormat::FRAME_MAGIC ||
+          _header.columns > (sizeInBytes - sizeof(_header)) / sizeof(FrameFormat::ColumnRecord))
+      { throw std::runtime_error("File with cell is corrupted. Wrong header of frame"); }
+
+      _columns.resize(_header.columns);
+      if (!_columns.empty())
+      { memcpy(&_columns[0], _data + sizeof(_header), _columns.size() * sizeof(FrameFormat::ColumnRecord)); }
+    }
+    FrameReader &operator =(const FrameReader &) = delete;
+
+    const FrameFormat::FrameHeader &Header() const
+    { return _header; }
+
+    template <class T>
+    void Load(FrameFormat::Column column, ArrayView<T> &arr) const
+    {
+      const FrameFormat::ColumnRecord *record = Find(column);
+      if (record->elementSize != sizeof(T) || record->size % sizeof(T) != 0)
+      { throw std::runtime_error("File with cell is corrupted. Wrong type of column"); }
+
+      arr = ArrayView<T>(_data + record->offset, (size_t)(record->size / sizeof(T)));
+    }
+
+    std::string LoadString(FrameFormat::Column column) const
+    {
+      const FrameFormat::ColumnRecord *record = Find(column);
+      return std::string((const char *)_data + record->offset, (size_t)record->size);
+    }
+
+  private:
+    const FrameFormat::ColumnRecord *Find(FrameFormat::Column column) const
+    {
+      for (size_t i = 0; i < _columns.size(); i++)
+      {
+        if (_columns[i].column == (uint32_t)column)
+        {
+          if (_columns[i].offset > _sizeInBytes || _columns[i].size > _sizeInBytes - _columns[i].offset)
+          { throw std::runtime_error("File with cell is corrupted. Column is out of frame"); }
+          return &_columns[i];
+        }
+      }
+      throw std::runtime_error("File with cell is corrupted. Cannot find column of frame");
+    }
+
+    const uint8_t *_data;
+    size_t _sizeInBytes;
+    FrameFormat::FrameHeader _header;
+    std::vector<FrameFormat::ColumnRecord> _columns;
+};
+
 } // unnamed namespace
 
 //--------------------
@@ -95,6 +258,8 @@ std::tuple<Version, std::string, int> DeSerializer::DeserializeVersion(uint64_t
     case 1: flags = "MICOSI_PRECISION_FP64; MICOSI_RNG_LCG"; break;
     case 2: flags = "MICOSI_PRECISION_FP32; MICOSI_RNG_MTG"; break;
     case 3: flags = "MICOSI_PRECISION_FP64; MICOSI_RNG_MTG"; break;
+    case 4: flags = "MICOSI_PRECISION_FP32; MICOSI_RNG_PHILOX"; break;
+    case 5: flags = "MICOSI_PRECISION_FP64; MICOSI_RNG_PHILOX"; break;
   }
 
   return std::make_tuple(Version((int)major, (int)minor, (int)build),
@@ -128,6 +293,23 @@ std::pair<Random::State, int64_t> DeSerializer::DeserializeRng(const TiXmlElemen
   return std::make_pair(state, seed);
 }
 
+bool DeSerializer::DeserializeDeterministic(const TiXmlElement *configuration)
+{
+  const TiXmlNode *node = nullptr;
+  const TiXmlElement *elem = nullptr;
+  if ((node = configuration->FirstChild("Parameters")) == nullptr ||
+      (elem = node->ToElement()) == nullptr)
+  { throw std::runtime_error("cannot open section with cell's parameters"); }
+
+  int deterministic = 0;
+  int res = elem->QueryIntAttribute("deterministic", &deterministic);
+  if (res == TIXML_NO_ATTRIBUTE)
+  { return false; }
+  if (res != TIXML_SUCCESS || (deterministic != 0 && deterministic != 1))
+  { throw std::runtime_error("cannot get record with mode of the run"); }
+  return deterministic != 0;
+}
+
 std::unique_ptr<Cell> DeSerializer::DeserializeCellConfiguration(const TiXmlElement *configuration,
                                                                  const void *data, size_t sizeInBytes)
 {
@@ -175,107 +357,55 @@ std::pair<double, Random::State> DeSerializer::DeserializeTimeLayer(const TiXmlE
   { throw std::runtime_error("File with cell is corrupted. Cannot get time"); }
   
   // Load cell's parameters
-  vec3d leftPole;
-  vec3d rightPole;
-  int springBroken;
+  CellState state;
   const TiXmlElement *cellSect = nullptr;
   if (timeLayer->FirstChild("Cell") == nullptr ||
       (cellSect = timeLayer->FirstChild("Cell")->ToElement()) == nullptr)
   { throw std::runtime_error("Cannot open section with cell configuration"); }
 
-  if (cellSect->QueryIntAttribute("SprBrkn", &springBroken) != TIXML_SUCCESS)
+  if (cellSect->QueryIntAttribute("SprBrkn", &state.springBroken) != TIXML_SUCCESS)
   { throw std::runtime_error("Cannot load cell configuration"); }
   if (cellSect->QueryIntAttribute("LPX0", doubleBuf) != TIXML_SUCCESS || 
       cellSect->QueryIntAttribute("LPX1", doubleBuf + 1) != TIXML_SUCCESS)
   { throw std::runtime_error("Cannot load cell configuration0"); }
-  leftPole.x = UintToDoubleConverter(doubleBuf);
+  state.leftPole.x = UintToDoubleConverter(doubleBuf);
   if (cellSect->QueryIntAttribute("LPY0", doubleBuf) != TIXML_SUCCESS || 
       cellSect->QueryIntAttribute("LPY1", doubleBuf + 1) != TIXML_SUCCESS)
   { throw std::runtime_error("Cannot load cell configuration1"); }
-  leftPole.y = UintToDoubleConverter(doubleBuf);
+  state.leftPole.y = UintToDoubleConverter(doubleBuf);
   if (cellSect->QueryIntAttribute("LPZ0", doubleBuf) != TIXML_SUCCESS || 
       cellSect->QueryIntAttribute("LPZ1", doubleBuf + 1) != TIXML_SUCCESS)
   { throw std::runtime_error("Cannot load cell configuration2"); }
-  leftPole.z = UintToDoubleConverter(doubleBuf);
+  state.leftPole.z = UintToDoubleConverter(doubleBuf);
   if (cellSect->QueryIntAttribute("RPX0", doubleBuf) != TIXML_SUCCESS || 
       cellSect->QueryIntAttribute("RPX1", doubleBuf+1) != TIXML_SUCCESS)
   { throw std::runtime_error("Cannot load cell configuration3"); }
-  rightPole.x = UintToDoubleConverter(doubleBuf);
+  state.rightPole.x = UintToDoubleConverter(doubleBuf);
   if (cellSect->QueryIntAttribute("RPY0", doubleBuf) != TIXML_SUCCESS || 
       cellSect->QueryIntAttribute("RPY1", doubleBuf + 1) != TIXML_SUCCESS)
   { throw std::runtime_error("Cannot load cell configuration4"); }
-  rightPole.y = UintToDoubleConverter(doubleBuf);
+  state.rightPole.y = UintToDoubleConverter(doubleBuf);
   if (cellSect->QueryIntAttribute("RPZ0", doubleBuf) != TIXML_SUCCESS || 
       cellSect->QueryIntAttribute("RPZ1", doubleBuf + 1) != TIXML_SUCCESS)
   { throw std::runtime_error("Cannot load cell configuration5"); }
-  rightPole.z = UintToDoubleConverter(doubleBuf);
-
-  cell.SetSpringFlag(springBroken != 0);
-  cell.GetPole(PoleType::Left)->Position() = vec3r((real)leftPole.x, (real)leftPole.y, (real)leftPole.z);
-  cell.GetPole(PoleType::Right)->Position() = vec3r((real)rightPole.x, (real)rightPole.y, (real)rightPole.z);
+  state.rightPole.z = UintToDoubleConverter(doubleBuf);
 
   // Load MT's parameters
-  int offset = -1, size = 0;
   const TiXmlElement *mts = nullptr;
   if (timeLayer->FirstChild("MTs") == nullptr ||
       (mts = timeLayer->FirstChild("MTs")->ToElement()) == nullptr)
   { throw std::runtime_error("File with cell is corrupted. Cannot open section with MTs"); }
-  
-  std::vector<real> lengthes;
-  std::vector<real> mtDirs_x;
-  std::vector<real> mtDirs_y;
-  std::vector<real> mtDirs_z;
-  std::vector<real> mtForces_x;
-  std::vector<real> mtForces_y;
-  std::vector<real> mtForces_z;
-  std::vector<int> states;
-  std::vector<int> boundIDs;
 
   Loader bin(data, sizeInBytes);
-  DeserializeArray<real>(mts, "Len", bin, lengthes);
-  DeserializeArray<real>(mts, "DX", bin, mtDirs_x);
-  DeserializeArray<real>(mts, "DY", bin, mtDirs_y);
-  DeserializeArray<real>(mts, "DZ", bin, mtDirs_z);
-  DeserializeArray<real>(mts, "FX", bin, mtForces_x);
-  DeserializeArray<real>(mts, "FY", bin, mtForces_y);
-  DeserializeArray<real>(mts, "FZ", bin, mtForces_z);
-  DeserializeArray<int>(mts, "St", bin, states);
-  DeserializeArray<int>(mts, "Bnd", bin, boundIDs);
-
-  if (cell.MTs().size() != lengthes.size() ||
-      cell.MTs().size() != mtDirs_x.size() ||
-      cell.MTs().size() != mtDirs_y.size() ||
-      cell.MTs().size() != mtDirs_z.size() ||
-      cell.MTs().size() != mtForces_x.size() ||
-      cell.MTs().size() != mtForces_y.size() ||
-      cell.MTs().size() != mtForces_z.size() ||
-      cell.MTs().size() != states.size() ||
-      cell.MTs().size() != boundIDs.size())
-  {
-    throw std::runtime_error(
-        "File with cell is corrupted. Count of MTs differs in initial configuration and time layer"
-    );
-  }
-
-  int chrSize = (int)cell.Chromosomes().size();
-  for (size_t i = 0; i < lengthes.size(); i++)
-  {
-    if (boundIDs[i] >= chrSize)
-    { throw std::runtime_error("File with cell is corrupted. Wrong indices of the bound MTs"); }
-  }
-
-  for (size_t i = 0; i < lengthes.size(); i++)
-  {
-    MT *mt = cell.MTs()[i];
-    mt->Length() = lengthes[i];
-    mt->Direction() = vec3r(mtDirs_x[i], mtDirs_y[i], mtDirs_z[i]);
-    mt->ForceOffset() = vec3r(mtForces_x[i], mtForces_y[i], mtForces_z[i]);
-    mt->State() = states[i] == 0 ? MTState::Polymerization : MTState::Depolymerization;
-    if (mt->BoundChromosome() != nullptr)
-    { mt->UnBind(); }
-    if (boundIDs[i] >= 0)
-    { mt->Bind(cell.Chromosomes()[boundIDs[i]]); }
-  }
+  DeserializeArray<real>(mts, "Len", bin, state.lengthes);
+  DeserializeArray<real>(mts, "DX", bin, state.mtDirs_x);
+  DeserializeArray<real>(mts, "DY", bin, state.mtDirs_y);
+  DeserializeArray<real>(mts, "DZ", bin, state.mtDirs_z);
+  DeserializeArray<real>(mts, "FX", bin, state.mtForces_x);
+  DeserializeArray<real>(mts, "FY", bin, state.mtForces_y);
+  DeserializeArray<real>(mts, "FZ", bin, state.mtForces_z);
+  DeserializeArray<int>(mts, "St", bin, state.states);
+  DeserializeArray<int>(mts, "Bnd", bin, state.boundIDs);
 
   // Load chromosomes
   const TiXmlElement *chrs = nullptr;
@@ -283,35 +413,12 @@ std::pair<double, Random::State> DeSerializer::DeserializeTimeLayer(const TiXmlE
       (chrs = timeLayer->FirstChild("Chrms")->ToElement()) == nullptr)
   { throw std::runtime_error("File with cell is corrupted. Cannot open section with chromosomes"); }
 
-  std::vector<real> x;
-  std::vector<real> y;
-  std::vector<real> z;
-  std::vector<real> mat;
+  DeserializeArray<real>(chrs, "X", bin, state.x);
+  DeserializeArray<real>(chrs, "Y", bin, state.y);
+  DeserializeArray<real>(chrs, "Z", bin, state.z);
+  DeserializeArray<real>(chrs, "Mat", bin, state.mat);
 
-  DeserializeArray<real>(chrs, "X", bin, x);
-  DeserializeArray<real>(chrs, "Y", bin, y);
-  DeserializeArray<real>(chrs, "Z", bin, z);
-  DeserializeArray<real>(chrs, "Mat", bin, mat);
-
-  if (cell.Chromosomes().size() != x.size() ||
-      cell.Chromosomes().size() != y.size() ||
-      cell.Chromosomes().size() != z.size() ||
-      cell.Chromosomes().size() != mat.size() / 9)
-  {
-    throw std::runtime_error(
-        "File with cell is corrupted. Count of Chromosomes differs in initial configuration and time layer"
-    );
-  }
-
-  const std::vector<Chromosome *> &chrsRef = cell.Chromosomes();
-  for (size_t i = 0; i < cell.Chromosomes().size(); i++)
-  {
-    Chromosome *chrRef = chrsRef[i];
-    chrRef->Position() = vec3r(x[i], y[i], z[i]);
-    chrRef->Orientation() = mat3x3r(mat[i * 9 + 0], mat[i * 9 + 1], mat[i * 9 + 2],
-                    mat[i * 9 + 3], mat[i * 9 + 4], mat[i * 9 + 5],
-                    mat[i * 9 + 6], mat[i * 9 + 7], mat[i * 9 + 8]);
-  }
+  ApplyCellState(state, cell);
 
   //Returning results.
   Random::State rngState;
@@ -337,6 +444,117 @@ double DeSerializer::DeserializeTime(const TiXmlElement *timeLayer)
   return time;
 }
 
+std::pair<double, Random::State> DeSerializer::DeserializeFrame(const void *data, size_t sizeInBytes, Cell &cell)
+{
+  FrameReader frame(data, sizeInBytes);
+  const FrameFormat::FrameHeader &header = frame.Header();
+  if (header.time < 0)
+  { throw std::runtime_error("File with cell is corrupted. Cannot get time"); }
+
+  CellState state;
+  state.leftPole = vec3d(header.leftPole[0], header.leftPole[1], header.leftPole[2]);
+  state.rightPole = vec3d(header.rightPole[0], header.rightPole[1], header.rightPole[2]);
+  state.springBroken = (int)header.springsBroken;
+  frame.Load(FrameFormat::MT_State, state.states);
+  frame.Load(FrameFormat::MT_Bound, state.boundIDs);
+  frame.Load(FrameFormat::Chr_X, state.x);
+  frame.Load(FrameFormat::Chr_Y, state.y);
+  frame.Load(FrameFormat::Chr_Z, state.z);
+  frame.Load(FrameFormat::Chr_Orientation, state.mat);
+
+  // Values of lossy profiles are restored here, views of the state point to these arrays
+  std::vector<real> lengthes, dir_x, dir_y, dir_z, zeros;
+  switch (header.profile)
+  {
+    case FrameFormat::Full:
+      frame.Load(FrameFormat::MT_Length, state.lengthes);
+      frame.Load(FrameFormat::MT_Dir_X, state.mtDirs_x);
+      frame.Load(FrameFormat::MT_Dir_Y, state.mtDirs_y);
+      frame.Load(FrameFormat::MT_Dir_Z, state.mtDirs_z);
+      frame.Load(FrameFormat::MT_Force_X, state.mtForces_x);
+      frame.Load(FrameFormat::MT_Force_Y, state.mtForces_y);
+      frame.Load(FrameFormat::MT_Force_Z, state.mtForces_z);
+      break;
+
+    case FrameFormat::Analysis:
+    {
+      ArrayView<uint16_t> q_lengthes, h_dir_x, h_dir_y, h_dir_z;
+      ArrayView<double> range;
+      frame.Load(FrameFormat::MT_Length_Q16, q_lengthes);
+      frame.Load(FrameFormat::MT_Length_Range, range);
+      frame.Load(FrameFormat::MT_Dir_X_F16, h_dir_x);
+      frame.Load(FrameFormat::MT_Dir_Y_F16, h_dir_y);
+      frame.Load(FrameFormat::MT_Dir_Z_F16, h_dir_z);
+      if (range.size() != 1 || h_dir_x.size() != q_lengthes.size() ||
+          h_dir_y.size() != q_lengthes.size() || h_dir_z.size() != q_lengthes.size())
+      { throw std::runtime_error("File with cell is corrupted. Wrong columns of frame"); }
+
+      for (size_t i = 0; i < q_lengthes.size(); i++)
+      {
+        lengthes.push_back((real)(q_lengthes[i] * range[0] / 65535.0));
+        dir_x.push_back((real)FrameFormat::HalfToFloat(h_dir_x[i]));
+        dir_y.push_back((real)FrameFormat::HalfToFloat(h_dir_y[i]));
+        dir_z.push_back((real)FrameFormat::HalfToFloat(h_dir_z[i]));
+      }
+      zeros.resize(q_lengthes.size(), (real)0.0);
+      break;
+    }
+
+    case FrameFormat::Topology:
+    {
+      // The cell may keep values of the previously loaded layer, so directions are reset as in a new cell
+      dir_x.resize(state.states.size(), vec3r::DEFAULT_DIRECT.x);
+      dir_y.resize(state.states.size(), vec3r::DEFAULT_DIRECT.y);
+      dir_z.resize(state.states.size(), vec3r::DEFAULT_DIRECT.z);
+      lengthes.resize(state.states.size(), (real)0.0);
+      zeros.resize(state.states.size(), (real)0.0);
+      break;
+    }
+
+    default:
+      throw std::runtime_error("File with cell is corrupted. Unknown profile of frame");
+  }
+  if (header.profile != FrameFormat::Full)
+  {
+    state.lengthes = ArrayView<real>(lengthes.empty() ? nullptr : &lengthes[0], lengthes.size());
+    state.mtDirs_x = ArrayView<real>(dir_x.empty() ? nullptr : &dir_x[0], dir_x.size());
+    state.mtDirs_y = ArrayView<real>(dir_y.empty() ? nullptr : &dir_y[0], dir_y.size());
+    state.mtDirs_z = ArrayView<real>(dir_z.empty() ? nullptr : &dir_z[0], dir_z.size());
+    state.mtForces_x = state.mtForces_y = state.mtForces_z =
+        ArrayView<real>(zeros.empty() ? nullptr : &zeros[0], zeros.size());
+  }
+  ApplyCellState(state, cell);
+
+  Random::State rngState = Random::State();
+  if (header.profile == FrameFormat::Full)
+  { Random::Deserialize(frame.LoadString(FrameFormat::Rng), rngState); }
+  return std::make_pair(header.time, rngState);
+}
+
+FrameFormat::Profile DeSerializer::DeserializeFrameProfile(const void *data, size_t sizeInBytes)
+{
+  FrameReader frame(data, sizeInBytes);
+  uint32_t profile = frame.Header().profile;
+  if (profile > FrameFormat::Topology)
+  { throw std::runtime_error("File with cell is corrupted. Unknown profile of frame"); }
+
+  return (FrameFormat::Profile)profile;
+}
+
+double DeSerializer::DeserializeFrameTime(const void *data, size_t sizeInBytes)
+{
+  FrameReader frame(data, sizeInBytes);
+  double time = frame.Header().time;
+  if (time < 0.0)
+  {
+    std::stringstream str;
+    str << "Unexpected value of time record: " << time;
+    throw std::runtime_error(str.str().c_str());
+  }
+
+  return time;
+}
+
 std::unique_ptr<SimParams> DeSerializer::DeserializeSimParams(const TiXmlElement *params,
                                                               const void *data, size_t sizeInBytes)
 {
@@ -7,6 +7,7 @@
 
 #include <tinyxml.h>
 #include "MemoryStream.h"
+#include "FrameFormat.h"
 
 
 // Static class that performs deserialization of the internal objects
@@ -29,6 +30,9 @@ class DeSerializer
     static std::pair<Random::State, int64_t> DeserializeRng(const TiXmlElement *configuration,
                                                             const void *data, size_t sizeInBytes);
 
+    // Deserializes mode of the run, files without the record were created in the usual mode
+    static bool DeserializeDeterministic(const TiXmlElement *configuration);
+
     // Deserializes cell structure only
     // The returned cell data object will be invalid until cell state deserialization
     static std::unique_ptr<Cell> DeserializeCellConfiguration(const TiXmlElement *configuration,
@@ -43,6 +47,17 @@ class DeSerializer
     // Deserializes only time of the layer
     static double DeserializeTime(const TiXmlElement *timeLayer);
 
+    // Version of 'DeserializeTimeLayer()' for the binary frames of the newer file formats (see 'FrameFormat')
+    // Values that are dropped by lossy profiles are set to zeros (directions of MTs to 'vec3r::DEFAULT_DIRECT'),
+    // such frames have no RNG, so the default state is returned
+    static std::pair<double, Random::State> DeserializeFrame(const void *data, size_t sizeInBytes, Cell &cell);
+
+    // Deserializes only time of the binary frame
+    static double DeserializeFrameTime(const void *data, size_t sizeInBytes);
+
+    // Deserializes only profile of the binary frame
+    static FrameFormat::Profile DeserializeFrameProfile(const void *data, size_t sizeInBytes);
+
     // Deserializes parameters and returns the configured object
     static std::unique_ptr<SimParams> DeserializeSimParams(const TiXmlElement *params,
                                                            const void *data, size_t sizeInBytes);
@@ -0,0 +1,125 @@
+#include "FrameFormat.h"
+
+//-------------------
+//--- FrameFormat ---
+//-------------------
+
+const char *FrameFormat::ProfileName(Profile profile)
+{
+  switch (profile)
+  {
+    case Full: return "full";
+    case Analysis: return "analysis";
+    case Topology: return "topology";
+    default: throw std::runtime_error("Unknown profile of frames");
+  }
+}
+
+bool FrameFormat::TryParseProfile(const std::string &name, Profile &profile)
+{
+  if (name == "full") { profile = Full; return true; }
+  else if (name == "analysis") { profile = Analysis; return true; }
+  else if (name == "topology") { profile = Topology; return true; }
+  else return false;
+}
+
+uint16_t FrameFormat::FloatToHalf(float value)
+{
+  uint32_t x;
+  memcpy(&x, &value, sizeof(x));
+  uint32_t sign = (x >> 16) & 0x8000;
+  uint32_t mantissa = x & 0x7fffff;
+  int exponent = (int)((x >> 23) & 0xff);
+
+  // Infinities and NaNs
+  if (exponent == 0xff)
+  { return (uint16_t)(sign | 0x7c00 | (mantissa != 0 ? 0x200 : 0)); }
+
+  exponent += 15 - 127;
+  if (exponent >= 31)
+  { return (uint16_t)(sign | 0x7c00); }
+
+  uint32_t half, rest, middle;
+  if (exponent <= 0)
+  {
+    // Subnormal values, the smallest one is 2^-24
+    if (exponent < -10)
+    { return (uint16_t)sign; }
+    mantissa |= 0x800000;
+    uint32_t shift = (uint32_t)(14 - exponent);
+    half = mantissa >> shift;
+    rest = mantissa & ((1u << shift) - 1);
+    middle = 1u << (shift - 1);
+  }
+  else
+  {
+    half = ((uint32_t)exponent << 10) | (mantissa >> 13);
+    rest = mantissa & 0x1fff;
+    middle = 0x1000;
+  }
+
+  // Carry of the rounding goes to the exponent, it's still the right value
+  if (rest > middle || (rest == middle && (half & 1) != 0))
+  { half++; }
+  return (uint16_t)(sign | half);
+}
+
+float FrameFormat::HalfToFloat(uint16_t value)
+{
+  uint32_t sign = ((uint32_t)value & 0x8000) << 16;
+  uint32_t exponent = ((uint32_t)value >> 10) & 0x1f;
+  uint32_t mantissa = (uint32_t)value & 0x3ff;
+
+  if (exponent == 0)
+  {
+    float res = std::ldexp((float)mantissa, -24);
+    return sign != 0 ? -res : res;
+  }
+
+  uint32_t x = exponent == 31
+    ? sign | 0x7f800000 | (mantissa << 13)
+    : sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+  float res;
+  memcpy(&res, &x, sizeof(res));
+  return res;
+}
+
+bool FrameFormat::ReadDirectory(const void *metaData, size_t metaDataSize, size_t binDataSize,
+                                std::vector<FrameRecord> &frames, uint32_t &codec, uint64_t &dataSize)
+{
+  frames.clear();
+  codec = 0;
+  dataSize = binDataSize;
+
+  ChunkDirectory dir;
+  if (metaData == nullptr || metaDataSize < sizeof(dir))
+  { return false; }
+  memcpy(&dir, metaData, sizeof(dir));
+
+  size_t recordsOffset = sizeof(dir);
+  if (dir.magic == CODEC_CHUNK_MAGIC)
+  {
+    ChunkCodecInfo info;
+    if (metaDataSize < sizeof(dir) + sizeof(info))
+    { return false; }
+    memcpy(&info, (const uint8_t *)metaData + sizeof(dir), sizeof(info));
+    codec = info.codec;
+    dataSize = info.dataSize;
+    recordsOffset += sizeof(info);
+  }
+  else if (dir.magic != CHUNK_MAGIC)
+  { return false; }
+  if (metaDataSize != recordsOffset + (size_t)dir.count * sizeof(FrameRecord))
+  { return false; }
+
+  frames.resize(dir.count);
+  if (dir.count > 0)
+  { memcpy(&frames[0], (const uint8_t *)metaData + recordsOffset, frames.size() * sizeof(FrameRecord)); }
+  for (size_t i = 0; i < frames.size(); i++)
+  {
+    if (frames[i].offset > dataSize || frames[i].size > dataSize - frames[i].offset)
+    { return false; }
+  }
+
+  return true;
+}
@@ -0,0 +1,112 @@
+#pragma once
+#include "MiCoSi.Core/Defs.h"
+
+// Binary layout of time layers that is used since the 3rd version of file format
+// Frame is a fixed header, a directory of columns and the columns themselves, columns are 8-byte aligned
+// Chunk with frames stores them one by one, its meta data is the directory of frames
+// Readers look columns up by their IDs, so new columns can be added without breaking them
+// Since the 4th version binary data of chunks is encoded, ID of the codec is written after the directory
+class FrameFormat
+{
+  public:
+    FrameFormat() = delete;
+    FrameFormat(const FrameFormat &) = delete;
+    FrameFormat &operator =(const FrameFormat &) = delete;
+
+    // The first version of file format with binary frames, older files keep time layers as XML
+    static const int FIRST_FILE_FORMAT = 3;
+
+    // The first version of file format with encoded chunks
+    static const int FIRST_CODEC_FILE_FORMAT = 4;
+
+    static const uint32_t FRAME_MAGIC = 0x4653434d;   // "MCSF"
+    static const uint32_t CHUNK_MAGIC = 0x4353434d;   // "MCSC"
+    static const uint32_t CODEC_CHUNK_MAGIC = 0x4443534d;   // "MCSD"
+
+    enum Column : uint32_t
+    {
+      MT_Length         = 0,
+      MT_Dir_X          = 1,
+      MT_Dir_Y          = 2,
+      MT_Dir_Z          = 3,
+      MT_Force_X        = 4,
+      MT_Force_Y        = 5,
+      MT_Force_Z        = 6,
+      MT_State          = 7,    // int, 0 - polymerization, 1 - depolymerization
+      MT_Bound          = 8,    // int, ID of the bound chromosome or -1
+      Chr_X             = 9,
+      Chr_Y             = 10,
+      Chr_Z             = 11,
+      Chr_Orientation   = 12,   // 9 values per chromosome
+      Rng               = 13,   // serialized state of RNG, without the trailing zero
+      MT_Length_Q16     = 14,   // uint16, 65535 corresponds to 'MT_Length_Range'
+      MT_Length_Range   = 15,   // double, the only value
+      MT_Dir_X_F16      = 16,   // half-precision floats
+      MT_Dir_Y_F16      = 17,
+      MT_Dir_Z_F16      = 18
+    };
+
+    // Defines columns of the frame, lossy profiles have no RNG and cannot be used to continue simulation
+    enum Profile : uint32_t
+    {
+      Full              = 0,    // all values as they are in memory
+      Analysis          = 1,    // MT_Length_Q16, MT_Length_Range, MT_Dir_*_F16, MT_State, MT_Bound, Chr_*
+      Topology          = 2     // MT_State, MT_Bound, Chr_*
+    };
+
+    struct FrameHeader
+    {
+      uint32_t magic;
+      uint32_t columns;         // count of records in the directory that follows the header
+      double time;
+      double leftPole[3];
+      double rightPole[3];
+      uint32_t springsBroken;
+      uint32_t profile;         // zero ("Full") in the frames that were written before profiles
+    };
+
+    struct ColumnRecord
+    {
+      uint32_t column;
+      uint32_t elementSize;     // in bytes, e.g. 'sizeof(real)' of the writer
+      uint64_t offset;          // from the beginning of the frame
+      uint64_t size;            // in bytes
+    };
+
+    struct ChunkDirectory
+    {
+      uint32_t magic;
+      uint32_t count;           // count of frames in the chunk, their records follow the directory
+    };
+
+    // Follows the directory with 'CODEC_CHUNK_MAGIC', records of frames describe the decoded data
+    struct ChunkCodecInfo
+    {
+      uint32_t codec;           // see 'IChunkCodec::Type'
+      uint32_t reserved;
+      uint64_t dataSize;        // size of the decoded data, in bytes
+    };
+
+    struct FrameRecord
+    {
+      double time;
+      uint64_t offset;          // from the beginning of the chunk's binary data
+      uint64_t size;
+    };
+
+    static inline size_t Align(size_t size)
+    { return (size + 7) & ~(size_t)7; }
+
+    // Names of profiles for command line, e.g. "analysis"
+    static const char *ProfileName(Profile profile);
+    static bool TryParseProfile(const std::string &name, Profile &profile);
+
+    // Conversions of IEEE 754 half-precision floats, values are rounded to the nearest even
+    static uint16_t FloatToHalf(float value);
+    static float HalfToFloat(uint16_t value);
+
+    // Parses and validates meta data of the chunk with frames, returns false if it isn't a directory of frames
+    // Chunks without codec info are reported as chunks with codec 0 ("None") and with their own size
+    static bool ReadDirectory(const void *metaData, size_t metaDataSize, size_t binDataSize,
+                              std::vector<FrameRecord> &frames, uint32_t &codec, uint64_t &dataSize);
+};
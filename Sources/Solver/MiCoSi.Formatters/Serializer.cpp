@@ -17,6 +17,8 @@ uint64_t Serializer::SerializeVersion(const Version &programVersion,
   { iflags |= 1; }
   if (flags.find("MICOSI_RNG_MTG", 0) != std::string::npos)
   { iflags |= 2; }
+  if (flags.find("MICOSI_RNG_PHILOX", 0) != std::string::npos)
+  { iflags |= 4; }
 
   uint64_t res = 0;
   uint16_t major = (uint16_t)programVersion.Major();
@@ -50,7 +52,8 @@ std::string HelperJoin(offset_t offset, offset_t size)
 TiXmlElement *Serializer::SerializeCellConfiguration(const Cell &cell,
                                                      const Random::State &rngState,
                                                      int64_t rngSeed,
-                                                     MemoryStream &stream)
+                                                     MemoryStream &stream,
+                                                     bool deterministic)
 {
   TiXmlElement *res = nullptr;
   try
@@ -66,6 +69,7 @@ TiXmlElement *Serializer::SerializeCellConfiguration(const Cell &cell,
     ss << rngSeed;
     params->SetAttribute("rng_seed", ss.str());
     params->SetAttribute("rng_state", Random::Serialize(rngState));
+    params->SetAttribute("deterministic", deterministic ? 1 : 0);
     params->SetAttribute("n_mt_total", (int)cell.MTs().size());
     params->SetAttribute("n_cr_total", (int)cell.Chromosomes().size());
 
@@ -93,6 +97,45 @@ void DoubleToUIntConverter(double value, int* buf)
   buf[1] = res[1];
 }
 
+// Changeable values of the cell's objects as arrays, are shared by the XML and binary versions
+struct CellColumns
+{
+  std::vector<real> lengthes, dir_x, dir_y, dir_z, force_x, force_y, force_z;
+  std::vector<int> states, boundIDs;
+  std::vector<real> x, y, z, mat;
+
+  CellColumns(const Cell &cell)
+  {
+    const std::vector<MT *> &mtsRefs = cell.MTs();
+    for (size_t i = 0; i < mtsRefs.size(); i++)
+    {
+      lengthes.push_back(mtsRefs[i]->Length());
+      vec3r dir = (vec3r)mtsRefs[i]->Direction();
+      dir_x.push_back(dir.x);
+      dir_y.push_back(dir.y);
+      dir_z.push_back(dir.z);
+      vec3r force = (vec3r)mtsRefs[i]->ForceOffset();
+      force_x.push_back(force.x);
+      force_y.push_back(force.y);
+      force_z.push_back(force.z);
+      states.push_back(mtsRefs[i]->State() == MTState::Polymerization ? 0 : 1);
+      boundIDs.push_back(mtsRefs[i]->BoundChromosome() == nullptr ? -1 : (int)mtsRefs[i]->BoundChromosome()->ID());
+    }
+
+    for (size_t i = 0; i < cell.Chromosomes().size(); i++)
+    {
+      Chromosome *chrRef = cell.Chromosomes()[i];
+      vec3r pos = (vec3r)chrRef->Position();
+      x.push_back(pos.x);
+      y.push_back(pos.y);
+      z.push_back(pos.z);
+      mat3x3r orient = (mat3x3r)chrRef->Orientation();
+      for (int j = 0; j < 9; j++)
+      { mat.push_back(orient.a[j]); }
+    }
+  }
+};
+
 } // unnamed namespace
 
 TiXmlElement *Serializer::SerializeTimeLayer(const Cell &cell, double time,
@@ -142,31 +185,11 @@ TiXmlElement *Serializer::SerializeTimeLayer(const Cell &cell, double time,
     cellSect->SetAttribute("SprBrkn", cell.AreSpringsBroken() ? 1 : 0);
 
     // Add states of MTs
-    const std::vector<MT *> &mtsRefs = cell.MTs();
-
-    std::vector<real> lengthes(mtsRefs.size());
-    std::vector<real> dir_x(mtsRefs.size());
-    std::vector<real> dir_y(mtsRefs.size());
-    std::vector<real> dir_z(mtsRefs.size());
-    std::vector<real> force_x(mtsRefs.size());
-    std::vector<real> force_y(mtsRefs.size());
-    std::vector<real> force_z(mtsRefs.size());
-    std::vector<int> states(mtsRefs.size());
-    std::vector<int> boundIDs(mtsRefs.size());
-    for (size_t i = 0; i < lengthes.size(); i++)
-    {
-      lengthes[i] = cell.MTs()[i]->Length();
-      vec3r dir = (vec3r)mtsRefs[i]->Direction();
-      dir_x[i] = dir.x;
-      dir_y[i] = dir.y;
-      dir_z[i] = dir.z;
-      vec3r force = (vec3r)mtsRefs[i]->ForceOffset();
-      force_x[i] = force.x;
-      force_y[i] = force.y;
-      force_z[i] = force.z;
-      states[i] = mtsRefs[i]->State() == MTState::Polymerization ? 0 : 1;
-      boundIDs[i] = mtsRefs[i]->BoundChromosome() == nullptr ? -1 : mtsRefs[i]->BoundChromosome()->ID();
-    }
+    CellColumns c(cell);
+    std::vector<real> &lengthes = c.lengthes;
+    std::vector<real> &dir_x = c.dir_x, &dir_y = c.dir_y, &dir_z = c.dir_z;
+    std::vector<real> &force_x = c.force_x, &force_y = c.force_y, &force_z = c.force_z;
+    std::vector<int> &states = c.states, &boundIDs = c.boundIDs;
 
     TiXmlElement *mts = new TiXmlElement("MTs");
     if (res->LinkEndChild(mts) == nullptr)
@@ -213,31 +236,7 @@ TiXmlElement *Serializer::SerializeTimeLayer(const Cell &cell, double time,
     if (res->LinkEndChild(chrs) == nullptr)
       throw std::runtime_error("Internal error at Serializer::SerializeTimeLayer() #2");
 
-    std::vector<real> x(cell.Chromosomes().size());
-    std::vector<real> y(cell.Chromosomes().size());
-    std::vector<real> z(cell.Chromosomes().size());
-    std::vector<real> mat(cell.Chromosomes().size() * 9);
-    std::vector<int> cnt(cell.Chromosomes().size());
-    std::vector<int> coff(cell.Chromosomes().size());
-
-    for (size_t i = 0; i < cell.Chromosomes().size(); i++)
-    {
-      Chromosome *chrRef = cell.Chromosomes()[i];
-      vec3r pos = (vec3r)chrRef->Position();
-      x[i] = pos.x;
-      y[i] = pos.y;
-      z[i] = pos.z;
-      mat3x3r orient = (mat3x3r)chrRef->Orientation();
-      mat[i * 9 + 0] = orient.a[0];
-      mat[i * 9 + 1] = orient.a[1];
-      mat[i * 9 + 2] = orient.a[2];
-      mat[i * 9 + 3] = orient.a[3];
-      mat[i * 9 + 4] = orient.a[4];
-      mat[i * 9 + 5] = orient.a[5];
-      mat[i * 9 + 6] = orient.a[6];
-      mat[i * 9 + 7] = orient.a[7];
-      mat[i * 9 + 8] = orient.a[8];
-    }
+    std::vector<real> &x = c.x, &y = c.y, &z = c.z, &mat = c.mat;
     if (mat.size() != 0)
     {
       chrs->SetAttribute("X", HelperJoin(stream.Position(), x.size() * sizeof(real)));
@@ -266,6 +265,134 @@ TiXmlElement *Serializer::SerializeTimeLayer(const Cell &cell, double time,
   }
 }
 
+namespace
+{
+
+// Column of the binary frame before it is written
+struct FrameColumn
+{
+  FrameFormat::Column column;
+  uint32_t elementSize;
+  const void *data;
+  size_t size;
+};
+
+template <class T>
+FrameColumn MakeColumn(FrameFormat::Column column, const std::vector<T> &arr)
+{
+  FrameColumn res = { column, (uint32_t)sizeof(T), arr.empty() ? nullptr : &arr[0], arr.size() * sizeof(T) };
+  return res;
+}
+
+void WritePadding(MemoryStream &stream, size_t size)
+{
+  static uint8_t zeros[8] = { 0 };
+  if (size > 0)
+  { stream.Write(zeros, size); }
+}
+
+} // unnamed namespace
+
+void Serializer::SerializeFrame(const Cell &cell, double time, const Random::State &rng, MemoryStream &stream,
+                                FrameFormat::Profile profile, double lengthRange)
+{
+  CellColumns c(cell);
+  std::string rngString;
+  std::vector<uint16_t> lengthes, dir_x, dir_y, dir_z;
+  std::vector<double> range;
+  std::vector<FrameColumn> columns;
+  switch (profile)
+  {
+    case FrameFormat::Full:
+      rngString = Random::Serialize(rng);
+      columns.push_back(MakeColumn(FrameFormat::MT_Length, c.lengthes));
+      columns.push_back(MakeColumn(FrameFormat::MT_Dir_X, c.dir_x));
+      columns.push_back(MakeColumn(FrameFormat::MT_Dir_Y, c.dir_y));
+      columns.push_back(MakeColumn(FrameFormat::MT_Dir_Z, c.dir_z));
+      columns.push_back(MakeColumn(FrameFormat::MT_Force_X, c.force_x));
+      columns.push_back(MakeColumn(FrameFormat::MT_Force_Y, c.force_y));
+      columns.push_back(MakeColumn(FrameFormat::MT_Force_Z, c.force_z));
+      break;
+
+    case FrameFormat::Analysis:
+    {
+      // MTs cannot leave the cell, so their lengths are less than its diameter
+      if (lengthRange <= 0.0)
+      { throw std::runtime_error("Internal error at Serializer::SerializeFrame() - wrong range of lengths"); }
+      range.push_back(lengthRange);
+      for (size_t i = 0; i < c.lengthes.size(); i++)
+      {
+        double q = std::floor(c.lengthes[i] / range[0] * 65535.0 + 0.5);
+        lengthes.push_back((uint16_t)std::min(std::max(q, 0.0), 65535.0));
+        dir_x.push_back(FrameFormat::FloatToHalf((float)c.dir_x[i]));
+        dir_y.push_back(FrameFormat::FloatToHalf((float)c.dir_y[i]));
+        dir_z.push_back(FrameFormat::FloatToHalf((float)c.dir_z[i]));
+      }
+      columns.push_back(MakeColumn(FrameFormat::MT_Length_Q16, lengthes));
+      columns.push_back(MakeColumn(FrameFormat::MT_Length_Range, range));
+      columns.push_back(MakeColumn(FrameFormat::MT_Dir_X_F16, dir_x));
+      columns.push_back(MakeColumn(FrameFormat::MT_Dir_Y_F16, dir_y));
+      columns.push_back(MakeColumn(FrameFormat::MT_Dir_Z_F16, dir_z));
+      break;
+    }
+
+    case FrameFormat::Topology:
+      break;
+
+    default:
+      throw std::runtime_error("Internal error at Serializer::SerializeFrame() - unknown profile");
+  }
+  columns.push_back(MakeColumn(FrameFormat::MT_State, c.states));
+  columns.push_back(MakeColumn(FrameFormat::MT_Bound, c.boundIDs));
+  columns.push_back(MakeColumn(FrameFormat::Chr_X, c.x));
+  columns.push_back(MakeColumn(FrameFormat::Chr_Y, c.y));
+  columns.push_back(MakeColumn(FrameFormat::Chr_Z, c.z));
+  columns.push_back(MakeColumn(FrameFormat::Chr_Orientation, c.mat));
+  if (profile == FrameFormat::Full)
+  {
+    FrameColumn rngColumn = { FrameFormat::Rng, 1, rngString.data(), rngString.size() };
+    columns.push_back(rngColumn);
+  }
+  const size_t count = columns.size();
+
+  // Fixed header, all values are written as they are in memory
+  FrameFormat::FrameHeader header;
+  memset(&header, 0, sizeof(header));
+  header.magic = FrameFormat::FRAME_MAGIC;
+  header.columns = (uint32_t)count;
+  header.time = time;
+  vec3r leftPole = (vec3r)cell.GetPole(PoleType::Left)->Position();
+  vec3r rightPole = (vec3r)cell.GetPole(PoleType::Right)->Position();
+  header.leftPole[0] = leftPole.x;
+  header.leftPole[1] = leftPole.y;
+  header.leftPole[2] = leftPole.z;
+  header.rightPole[0] = rightPole.x;
+  header.rightPole[1] = rightPole.y;
+  header.rightPole[2] = rightPole.z;
+  header.springsBroken = cell.AreSpringsBroken() ? 1 : 0;
+  header.profile = (uint32_t)profile;
+
+  // Offsets are relative to the frame, so frames can be moved between chunks as they are
+  size_t start = stream.Length();
+  stream.Write(&header, sizeof(header));
+  uint64_t offset = FrameFormat::Align(sizeof(header) + count * sizeof(FrameFormat::ColumnRecord));
+  for (size_t i = 0; i < count; i++)
+  {
+    FrameFormat::ColumnRecord record = { (uint32_t)columns[i].column, columns[i].elementSize,
+                                         offset, (uint64_t)columns[i].size };
+    stream.Write(&record, sizeof(record));
+    offset = FrameFormat::Align((size_t)(offset + columns[i].size));
+  }
+
+  for (size_t i = 0; i < count; i++)
+  {
+    WritePadding(stream, FrameFormat::Align(stream.Length() - start) - (stream.Length() - start));
+    if (columns[i].size > 0)
+    { stream.Write((void *)columns[i].data, columns[i].size); }
+  }
+  WritePadding(stream, FrameFormat::Align(stream.Length() - start) - (stream.Length() - start));
+}
+
 TiXmlElement *Serializer::SerializeSimParams(const SimParams &params, MemoryStream &stream)
 {
   TiXmlElement *res = nullptr;
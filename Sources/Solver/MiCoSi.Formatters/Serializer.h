@@ -7,6 +7,7 @@
 
 #include <tinyxml.h>
 #include "MemoryStream.h"
+#include "FrameFormat.h"
 
 // Static class that performs serialization into XML-nodes
 class Serializer
@@ -22,15 +23,24 @@ class Serializer
                                      int fileFormatVersion);
 
     // Serializes the unchangeabale information about cell
+    // The "deterministic" flag keeps the mode of the run, so it can be continued the same way
     static TiXmlElement *SerializeCellConfiguration(const Cell &cell,
                                                     const Random::State &rngState,
                                                     int64_t rngSeed,
-                                                    MemoryStream &stream);
+                                                    MemoryStream &stream,
+                                                    bool deterministic = false);
 
     // Serializes time layer (only changeable values of the Cell's parameters)
+    // Is used by files of the old formats, the newer ones store frames (see 'SerializeFrame()')
     static TiXmlElement *SerializeTimeLayer(const Cell &cell, double time,
                                             const Random::State &rng, MemoryStream &stream);
 
+    // Appends time layer to the stream as a binary frame, see 'FrameFormat'
+    // Lossy profiles quantize or drop some values, lengths of MTs are stored relative to 'lengthRange'
+    // (the cell's diameter, it's required by the "analysis" profile only)
+    static void SerializeFrame(const Cell &cell, double time, const Random::State &rng, MemoryStream &stream,
+                               FrameFormat::Profile profile = FrameFormat::Full, double lengthRange = 0.0);
+
     // Serializes simulation parameters
     static TiXmlElement *SerializeSimParams(const SimParams &params, MemoryStream &stream);
 };
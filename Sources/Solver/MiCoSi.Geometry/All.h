@@ -5,3 +5,6 @@
 #include "mat3x3x.h"
 #include "mat4x4x.h"
 #include "Geometry.h"
+#include "CapsuleGrid.h"
+#include "BatchGeometry.h"
+#include "BatchLinearSolver.h"
@@ -0,0 +1,190 @@
+#include "BatchGeometry.h"
+
+namespace
+{
+
+const int WIDTH = BatchGeometry::WIDTH;
+
+// Collects flags of the used lanes to the bit mask
+uint32_t ToMask(const int *ok, int count)
+{
+  uint32_t mask = 0;
+  for (int i = 0; i < count; i++)
+  { mask |= (uint32_t)(ok[i] != 0 ? 1 : 0) << i; }
+  return mask;
+}
+
+// Distances between the first points of segments and the intersection points
+void ComputeDistances(const BatchGeometry::Segments &segs, BatchGeometry::Hits &hits)
+{
+  for (int i = 0; i < WIDTH; i++)
+  {
+    real dx = hits.x[i] - segs.x1[i];
+    real dy = hits.y[i] - segs.y1[i];
+    real dz = hits.z[i] - segs.z1[i];
+    hits.dist[i] = std::sqrt(dx * dx + dy * dy + dz * dz);
+  }
+}
+
+// Intersection with the plane defined by point and normal, sets 'ok' for the lanes with collisions
+void IntersectPlane(const BatchGeometry::Segments &segs,
+                    const vec3r &p, const vec3r &n,
+                    BatchGeometry::Hits &hits, int *ok)
+{
+  // Constants are copied, otherwise the compiler expects aliasing with the results
+  const real offset = DotProduct(n, p);
+  const real nx = n.x, ny = n.y, nz = n.z;
+  for (int i = 0; i < WIDTH; i++)
+  {
+    real p1_proj = nx * segs.x1[i] + ny * segs.y1[i] + nz * segs.z1[i];
+    real p2_proj = nx * segs.x2[i] + ny * segs.y2[i] + nz * segs.z2[i];
+    int apart = (int)((p1_proj > offset) & (p2_proj > offset)) |
+                (int)((p1_proj < offset) & (p2_proj < offset));
+
+    real dx = segs.x2[i] - segs.x1[i];
+    real dy = segs.y2[i] - segs.y1[i];
+    real dz = segs.z2[i] - segs.z1[i];
+    real div = dx * nx + dy * ny + dz * nz;
+    real t = (offset - p1_proj) / div;    // inf or NaN for the parallel segments, they are masked
+    hits.x[i] = dx * t + segs.x1[i];
+    hits.y[i] = dy * t + segs.y1[i];
+    hits.z[i] = dz * t + segs.z1[i];
+    ok[i] = (1 - apart) & (int)(div != (real)0);
+  }
+}
+
+} // unnamed namespace
+
+//-------------------------------
+//--- BatchGeometry::Segments ---
+//-------------------------------
+
+void BatchGeometry::Segments::Clear()
+{
+  for (int i = 0; i < WIDTH; i++)
+  {
+    x1[i] = y1[i] = z1[i] = (real)0;
+    x2[i] = y2[i] = z2[i] = (real)0;
+  }
+  count = 0;
+}
+
+void BatchGeometry::Segments::Set(int lane, const vec3r &p1, const vec3r &p2)
+{
+  x1[lane] = p1.x; y1[lane] = p1.y; z1[lane] = p1.z;
+  x2[lane] = p2.x; y2[lane] = p2.y; z2[lane] = p2.z;
+  count = std::max(count, lane + 1);
+}
+
+//---------------------
+//--- BatchGeometry ---
+//---------------------
+
+uint32_t BatchGeometry::AreIntersected(const Segments &segs, const Geometry::Plane &plane, Hits &hits)
+{
+  alignas(64) int ok[WIDTH];
+  IntersectPlane(segs, plane.p, plane.n, hits, ok);
+  ComputeDistances(segs, hits);
+  return ToMask(ok, segs.count);
+}
+
+uint32_t BatchGeometry::AreIntersected(const Segments &segs, const Geometry::Rectangle &rect, Hits &hits)
+{
+  alignas(64) int ok[WIDTH];
+  IntersectPlane(segs, rect.p, CrossProduct(rect.v1, rect.v2).Normalize(), hits, ok);
+
+  const real v1_len2 = rect.v1.GetLength2();
+  const real v2_len2 = rect.v2.GetLength2();
+  const vec3r p = rect.p, v1 = rect.v1, v2 = rect.v2;
+  for (int i = 0; i < WIDTH; i++)
+  {
+    real dx = hits.x[i] - p.x;
+    real dy = hits.y[i] - p.y;
+    real dz = hits.z[i] - p.z;
+    real v1_proj = v1.x * dx + v1.y * dy + v1.z * dz;
+    real v2_proj = v2.x * dx + v2.y * dy + v2.z * dz;
+    ok[i] &= (int)(v1_proj >= (real)0.0) & (int)(v1_proj <= v1_len2) &
+             (int)(v2_proj >= (real)0.0) & (int)(v2_proj <= v2_len2);
+  }
+
+  ComputeDistances(segs, hits);
+  return ToMask(ok, segs.count);
+}
+
+uint32_t BatchGeometry::AreIntersected(const Segments &segs, const Geometry::SemiCircle &circle, Hits &hits)
+{
+  alignas(64) int ok[WIDTH];
+  IntersectPlane(segs, circle.p, CrossProduct(circle.r1, circle.r2).Normalize(), hits, ok);
+
+  const real r1_len2 = circle.r1.GetLength2();
+  const vec3r p = circle.p, r2 = circle.r2;
+  for (int i = 0; i < WIDTH; i++)
+  {
+    real dx = hits.x[i] - p.x;
+    real dy = hits.y[i] - p.y;
+    real dz = hits.z[i] - p.z;
+    real r2_proj = r2.x * dx + r2.y * dy + r2.z * dz;
+    ok[i] &= (int)(r2_proj >= (real)0.0) & (int)(dx * dx + dy * dy + dz * dz <= r1_len2);
+  }
+
+  ComputeDistances(segs, hits);
+  return ToMask(ok, segs.count);
+}
+
+uint32_t BatchGeometry::AreIntersected(const Segments &segs, const Geometry::SemiTube &tube, Hits &hits)
+{
+  alignas(64) int ok[WIDTH];
+  const real r_sqr = tube.r.GetLength2();
+  const vec3r handDir = (tube.p2 - tube.p1).Normalize();
+  const real hbeg_proj = DotProduct(tube.p1, handDir);
+  const vec3r p1 = tube.p1, p2 = tube.p2, r = tube.r;
+  const vec3r axis = tube.p2 - tube.p1;
+  const vec3r axisInv = tube.p1 - tube.p2;
+
+  // See the scalar version for the explanation of the equation
+  for (int i = 0; i < WIDTH; i++)
+  {
+    real ddx = segs.x2[i] - segs.x1[i];
+    real ddy = segs.y2[i] - segs.y1[i];
+    real ddz = segs.z2[i] - segs.z1[i];
+    real len = std::sqrt(ddx * ddx + ddy * ddy + ddz * ddz);
+    real dx = ddx / len, dy = ddy / len, dz = ddz / len;
+
+    real beg_proj = segs.x1[i] * handDir.x + segs.y1[i] * handDir.y + segs.z1[i] * handDir.z;
+    real fx = segs.x1[i] - p1.x - handDir.x * beg_proj + handDir.x * hbeg_proj;
+    real fy = segs.y1[i] - p1.y - handDir.y * beg_proj + handDir.y * hbeg_proj;
+    real fz = segs.z1[i] - p1.z - handDir.z * beg_proj + handDir.z * hbeg_proj;
+    real dir_proj = dx * handDir.x + dy * handDir.y + dz * handDir.z;
+    real sx = dx - handDir.x * dir_proj;
+    real sy = dy - handDir.y * dir_proj;
+    real sz = dz - handDir.z * dir_proj;
+
+    real a = sx * sx + sy * sy + sz * sz;
+    real b = 2 * (fx * sx + fy * sy + fz * sz);
+    real c = (fx * fx + fy * fy + fz * fz) - r_sqr;
+    real disc = b * b - 4 * a * c;
+    real sq = std::sqrt(disc);            // NaN for the negative discriminant, such lanes are masked
+    real t0 = (-b - sq) / (2 * a);
+    real t1 = (-b + sq) / (2 * a);
+
+    // The first root has priority, as in the scalar version
+    real ix0 = segs.x1[i] + dx * t0, iy0 = segs.y1[i] + dy * t0, iz0 = segs.z1[i] + dz * t0;
+    real ix1 = segs.x1[i] + dx * t1, iy1 = segs.y1[i] + dy * t1, iz1 = segs.z1[i] + dz * t1;
+    int ok0 = (int)(t0 >= 0) & (int)(t0 <= len) &
+              (int)((ix0 - p1.x) * r.x + (iy0 - p1.y) * r.y + (iz0 - p1.z) * r.z > 0) &
+              (int)((ix0 - p1.x) * axis.x + (iy0 - p1.y) * axis.y + (iz0 - p1.z) * axis.z >= 0) &
+              (int)((ix0 - p2.x) * axisInv.x + (iy0 - p2.y) * axisInv.y + (iz0 - p2.z) * axisInv.z >= 0);
+    int ok1 = (int)(t1 >= 0) & (int)(t1 <= len) &
+              (int)((ix1 - p1.x) * r.x + (iy1 - p1.y) * r.y + (iz1 - p1.z) * r.z > 0) &
+              (int)((ix1 - p1.x) * axis.x + (iy1 - p1.y) * axis.y + (iz1 - p1.z) * axis.z >= 0) &
+              (int)((ix1 - p2.x) * axisInv.x + (iy1 - p2.y) * axisInv.y + (iz1 - p2.z) * axisInv.z >= 0);
+
+    hits.x[i] = ok0 ? ix0 : ix1;
+    hits.y[i] = ok0 ? iy0 : iy1;
+    hits.z[i] = ok0 ? iz0 : iz1;
+    ok[i] = (int)(disc >= (real)0) & (ok0 | ok1);
+  }
+
+  ComputeDistances(segs, hits);
+  return ToMask(ok, segs.count);
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include "MiCoSi.Core/Defs.h"
+
+#include "Geometry.h"
+
+// Batched versions of the segment-vs-primitive checks from 'Geometry'
+// Each call checks WIDTH segments against one primitive, all lanes are processed by the same
+// branch-free code, so the compiler maps them to the vector registers (AVX2 - 8 floats, AVX-512 - 16 floats)
+// Arithmetic repeats the scalar checks step by step, so the results are bitwise equal
+class BatchGeometry
+{
+  public:
+#if defined(MICOSI_SIMD_AVX512)
+    static const int WIDTH = 16;
+#else
+    static const int WIDTH = 8;
+#endif
+
+    // Segments as SoA, only the first 'count' lanes are used
+    struct Segments
+    {
+      alignas(64) real x1[WIDTH];
+      alignas(64) real y1[WIDTH];
+      alignas(64) real z1[WIDTH];
+      alignas(64) real x2[WIDTH];
+      alignas(64) real y2[WIDTH];
+      alignas(64) real z2[WIDTH];
+      int count;
+
+      Segments() : count(0) { Clear(); }
+
+      // Fills all lanes by degenerate segments, such segments never intersect anything
+      void Clear();
+
+      // Sets the 'lane'-th segment, 'count' is extended if it is required
+      void Set(int lane, const vec3r &p1, const vec3r &p2);
+    };
+
+    // Intersection points and distances from the first points of segments
+    // Values are valid only for the lanes with the set bits of mask
+    struct Hits
+    {
+      alignas(64) real x[WIDTH];
+      alignas(64) real y[WIDTH];
+      alignas(64) real z[WIDTH];
+      alignas(64) real dist[WIDTH];
+
+      vec3r Point(int lane) const
+      { return vec3r(x[lane], y[lane], z[lane]); }
+    };
+
+    // Each method returns the mask, its i-th bit is set if the i-th segment collides with primitive
+    static uint32_t AreIntersected(const Segments &segs, const Geometry::Plane &plane, Hits &hits);
+    static uint32_t AreIntersected(const Segments &segs, const Geometry::Rectangle &rect, Hits &hits);
+    static uint32_t AreIntersected(const Segments &segs, const Geometry::SemiCircle &circle, Hits &hits);
+    static uint32_t AreIntersected(const Segments &segs, const Geometry::SemiTube &tube, Hits &hits);
+};
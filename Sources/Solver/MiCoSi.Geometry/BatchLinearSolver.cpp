@@ -0,0 +1,236 @@
+#include "BatchLinearSolver.h"
+
+namespace
+{
+
+const int WIDTH = BatchLinearSolver::WIDTH;
+const int ROWS = BatchLinearSolver::ROWS;
+const int COLS = BatchLinearSolver::COLS;
+
+} // unnamed namespace
+
+//----------------------------------
+//--- BatchLinearSolver::Systems ---
+//----------------------------------
+
+void BatchLinearSolver::Systems::Clear()
+{
+  for (int i = 0; i < ROWS; i++)
+  {
+    for (int j = 0; j < COLS; j++)
+    {
+      for (int l = 0; l < WIDTH; l++)
+      { m[i][j][l] = (real)(i == j ? 1 : 0); }
+    }
+  }
+  count = 0;
+}
+
+void BatchLinearSolver::Systems::Set(int lane, const real (&mat)[ROWS][COLS])
+{
+  for (int i = 0; i < ROWS; i++)
+  {
+    for (int j = 0; j < COLS; j++)
+    { m[i][j][lane] = mat[i][j]; }
+  }
+  count = std::max(count, lane + 1);
+}
+
+//-------------------------
+//--- BatchLinearSolver ---
+//-------------------------
+
+bool BatchLinearSolver::Solve(real (&mat)[ROWS][COLS])
+{
+  // Normalizing matrix
+  for (int i = 0; i < 6; i++)
+  {
+    real maxVal = 0;
+    for (int j = 0; j < 6; j++)
+      if (fabs(mat[i][j]) > maxVal)
+        maxVal = fabs(mat[i][j]);
+    if (maxVal > 0)
+    {
+      for (int j = 0; j < 7; j++)
+        mat[i][j] /= maxVal;
+    }
+    else
+      return false;
+  }
+
+  // Move forward
+  for (int line = 0; line < 5; line++)
+  {
+    int maxLine = line;
+    real maxVal = fabs(mat[line][line]);
+    for (int i = line + 1; i < 6; i++)
+      if (fabs(mat[i][line]) > maxVal)
+      {
+        maxVal = fabs(mat[i][line]);
+        maxLine = i;
+      }
+    if (maxVal > 0)
+    {
+      if (maxLine != line)
+        for (int j = 0; j < 7; j++)
+        {
+          real tmp = mat[line][j];
+          mat[line][j] = mat[maxLine][j];
+          mat[maxLine][j] = tmp;
+        }
+      for (int i = line + 1; i < 6; i++)
+      {
+        real denom = sqrt(mat[line][line] * mat[line][line] + mat[i][line] * mat[i][line]);
+        real c = mat[line][line] / denom;
+        real s = mat[i][line] / denom;
+        for (int j = line; j < 7; j++)
+        {
+          real fir = mat[line][j];
+          real sec = mat[i][j];
+          mat[line][j] = c * fir + s * sec;
+          mat[i][j] = - s * fir + c * sec;
+        }
+      }
+    }
+    else
+      return false;
+  }
+
+  // Move back
+  for (int line = 5; line >= 0; line--)
+  {
+    if (fabs(mat[line][line]) > 0)
+    {
+      mat[line][6] /= mat[line][line];
+      mat[line][line] = 1;
+      for (int i = 0; i < line; i++)
+      {
+        mat[i][6] -= mat[line][6] * mat[i][line];
+        mat[i][line] = 0;
+      }
+    }
+    else
+      return false;
+  }
+  return true;
+}
+
+uint32_t BatchLinearSolver::Solve(Systems &systems)
+{
+  // Degenerate lanes are marked and processed further, their values are garbage
+  alignas(64) int ok[WIDTH];
+  alignas(64) real maxVal[WIDTH];
+  alignas(64) int maxLine[WIDTH];
+  real (&m)[ROWS][COLS][WIDTH] = systems.m;
+  for (int l = 0; l < WIDTH; l++)
+  { ok[l] = 1; }
+
+  // Normalizing matrices
+  for (int i = 0; i < ROWS; i++)
+  {
+    for (int l = 0; l < WIDTH; l++)
+    { maxVal[l] = (real)0; }
+    for (int j = 0; j < ROWS; j++)
+    {
+      for (int l = 0; l < WIDTH; l++)
+      {
+        real a = fabs(m[i][j][l]);
+        maxVal[l] = a > maxVal[l] ? a : maxVal[l];
+      }
+    }
+    for (int l = 0; l < WIDTH; l++)
+    {
+      ok[l] &= (int)(maxVal[l] > 0);
+      maxVal[l] = maxVal[l] > 0 ? maxVal[l] : (real)1;
+    }
+    for (int j = 0; j < COLS; j++)
+    {
+      for (int l = 0; l < WIDTH; l++)
+      { m[i][j][l] /= maxVal[l]; }
+    }
+  }
+
+  // Move forward
+  for (int line = 0; line < ROWS - 1; line++)
+  {
+    for (int l = 0; l < WIDTH; l++)
+    {
+      maxLine[l] = line;
+      maxVal[l] = fabs(m[line][line][l]);
+    }
+    for (int i = line + 1; i < ROWS; i++)
+    {
+      for (int l = 0; l < WIDTH; l++)
+      {
+        real a = fabs(m[i][line][l]);
+        bool better = a > maxVal[l];
+        maxVal[l] = better ? a : maxVal[l];
+        maxLine[l] = better ? i : maxLine[l];
+      }
+    }
+    for (int l = 0; l < WIDTH; l++)
+    { ok[l] &= (int)(maxVal[l] > 0); }
+
+    // Swapping by selects, each lane has its own pivot
+    for (int i = line + 1; i < ROWS; i++)
+    {
+      for (int j = 0; j < COLS; j++)
+      {
+        for (int l = 0; l < WIDTH; l++)
+        {
+          bool swap = maxLine[l] == i;
+          real fir = m[line][j][l];
+          real sec = m[i][j][l];
+          m[line][j][l] = swap ? sec : fir;
+          m[i][j][l] = swap ? fir : sec;
+        }
+      }
+    }
+
+    for (int i = line + 1; i < ROWS; i++)
+    {
+      alignas(64) real c[WIDTH];
+      alignas(64) real s[WIDTH];
+      for (int l = 0; l < WIDTH; l++)
+      {
+        real denom = sqrt(m[line][line][l] * m[line][line][l] + m[i][line][l] * m[i][line][l]);
+        c[l] = m[line][line][l] / denom;
+        s[l] = m[i][line][l] / denom;
+      }
+      for (int j = line; j < COLS; j++)
+      {
+        for (int l = 0; l < WIDTH; l++)
+        {
+          real fir = m[line][j][l];
+          real sec = m[i][j][l];
+          m[line][j][l] = c[l] * fir + s[l] * sec;
+          m[i][j][l] = - s[l] * fir + c[l] * sec;
+        }
+      }
+    }
+  }
+
+  // Move back
+  for (int line = ROWS - 1; line >= 0; line--)
+  {
+    for (int l = 0; l < WIDTH; l++)
+    {
+      ok[l] &= (int)(fabs(m[line][line][l]) > 0);
+      m[line][COLS - 1][l] /= m[line][line][l];
+      m[line][line][l] = 1;
+    }
+    for (int i = 0; i < line; i++)
+    {
+      for (int l = 0; l < WIDTH; l++)
+      {
+        m[i][COLS - 1][l] -= m[line][COLS - 1][l] * m[i][line][l];
+        m[i][line][l] = 0;
+      }
+    }
+  }
+
+  uint32_t mask = 0;
+  for (int l = 0; l < systems.count; l++)
+  { mask |= (uint32_t)ok[l] << l; }
+  return mask;
+}
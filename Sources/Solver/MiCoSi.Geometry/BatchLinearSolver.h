@@ -0,0 +1,42 @@
+#pragma once
+#include "MiCoSi.Core/Defs.h"
+
+#include "BatchGeometry.h"
+
+// Solver of small dense systems (6x6, given as the extended 6x7 matrices) by the method of rotations
+// The batched version processes WIDTH independent systems in lockstep, one system per lane
+// Pivoting and degenerate systems are handled by masks, the arithmetic repeats the scalar version
+// step by step, so the results are bitwise equal
+class BatchLinearSolver
+{
+  public:
+    static const int WIDTH = BatchGeometry::WIDTH;
+    static const int ROWS = 6;
+    static const int COLS = 7;
+
+    // Extended matrices as SoA, only the first 'count' lanes are used
+    struct Systems
+    {
+      alignas(64) real m[ROWS][COLS][WIDTH];
+      int count;
+
+      Systems() : count(0) { Clear(); }
+
+      // Fills all lanes by identity systems, such lanes are always solvable
+      void Clear();
+
+      // Sets the 'lane'-th system, 'count' is extended if it is required
+      void Set(int lane, const real (&mat)[ROWS][COLS]);
+
+      // The 'row'-th component of the answer, valid only after solving
+      real Answer(int lane, int row) const
+      { return m[row][COLS - 1][lane]; }
+    };
+
+    // Rows are normalized first, the answer is stored in the last column
+    // Returns false if the system is degenerate, the matrix is garbage in this case
+    static bool Solve(real (&mat)[ROWS][COLS]);
+
+    // Returns the mask, its i-th bit is set if the i-th system was solved
+    static uint32_t Solve(Systems &systems);
+};
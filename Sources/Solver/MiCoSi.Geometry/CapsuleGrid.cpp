@@ -0,0 +1,219 @@
+#include "CapsuleGrid.h"
+
+namespace
+{
+
+// Limits memory consumption for extremely stretched sets of capsules
+const int MAX_CELLS_PER_AXIS = 64;
+
+} // unnamed namespace
+
+//-------------------
+//--- CapsuleGrid ---
+//-------------------
+
+CapsuleGrid::CapsuleGrid(real eps)
+  : _eps(eps), _cellSize(0)
+{
+  for (int i = 0; i < 3; i++)
+  {
+    _lo[i] = _hi[i] = 0;
+    _dims[i] = 0;
+  }
+}
+
+void CapsuleGrid::Clear()
+{
+  _min_x.clear(); _min_y.clear(); _min_z.clear();
+  _max_x.clear(); _max_y.clear(); _max_z.clear();
+  _cellStart.clear();
+  _items.clear();
+  for (int i = 0; i < 3; i++)
+  { _dims[i] = 0; }
+}
+
+void CapsuleGrid::Add(const vec3r &p1, const vec3r &p2, real radius)
+{
+  real ext = std::abs(radius) + _eps;
+  _min_x.push_back(std::min(p1.x, p2.x) - ext);
+  _min_y.push_back(std::min(p1.y, p2.y) - ext);
+  _min_z.push_back(std::min(p1.z, p2.z) - ext);
+  _max_x.push_back(std::max(p1.x, p2.x) + ext);
+  _max_y.push_back(std::max(p1.y, p2.y) + ext);
+  _max_z.push_back(std::max(p1.z, p2.z) + ext);
+}
+
+void CapsuleGrid::Build()
+{
+  _cellStart.clear();
+  _items.clear();
+  size_t count = Count();
+  if (count == 0)
+  { return; }
+
+  // Bounding box of all capsules and the size of the largest one
+  // Cells are not smaller than capsules, so each capsule is stored by a few cells only
+  real largest = 0;
+  _lo[0] = _min_x[0]; _lo[1] = _min_y[0]; _lo[2] = _min_z[0];
+  _hi[0] = _max_x[0]; _hi[1] = _max_y[0]; _hi[2] = _max_z[0];
+  for (size_t i = 0; i < count; i++)
+  {
+    _lo[0] = std::min(_lo[0], _min_x[i]); _hi[0] = std::max(_hi[0], _max_x[i]);
+    _lo[1] = std::min(_lo[1], _min_y[i]); _hi[1] = std::max(_hi[1], _max_y[i]);
+    _lo[2] = std::min(_lo[2], _min_z[i]); _hi[2] = std::max(_hi[2], _max_z[i]);
+    largest = std::max(largest, _max_x[i] - _min_x[i]);
+    largest = std::max(largest, _max_y[i] - _min_y[i]);
+    largest = std::max(largest, _max_z[i] - _min_z[i]);
+  }
+
+  _cellSize = largest > 0 ? largest : (real)1;
+  for (int a = 0; a < 3; a++)
+  {
+    real extent = _hi[a] - _lo[a];
+    _dims[a] = (int)std::ceil(extent / _cellSize);
+    _dims[a] = std::max(1, std::min(MAX_CELLS_PER_AXIS, _dims[a]));
+    _cellSize = std::max(_cellSize, extent / _dims[a]);
+  }
+
+  // Counting sort of capsules by cells
+  auto cellIndex = [this](int a, real v) -> int
+  {
+    int idx = (int)std::floor((v - _lo[a]) / _cellSize);
+    return std::max(0, std::min(_dims[a] - 1, idx));
+  };
+  const std::vector<real> *mins[3] = { &_min_x, &_min_y, &_min_z };
+  const std::vector<real> *maxs[3] = { &_max_x, &_max_y, &_max_z };
+
+  _cellStart.assign((size_t)_dims[0] * _dims[1] * _dims[2] + 1, 0);
+  for (int pass = 0; pass < 2; pass++)
+  {
+    std::vector<int> fill;
+    if (pass == 1)
+    {
+      for (size_t c = 1; c < _cellStart.size(); c++)
+      { _cellStart[c] += _cellStart[c - 1]; }
+      _items.resize(_cellStart.back());
+      fill.assign(_cellStart.begin(), _cellStart.end() - 1);
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+      int from[3], to[3];
+      for (int a = 0; a < 3; a++)
+      {
+        from[a] = cellIndex(a, (*mins[a])[i]);
+        to[a]   = cellIndex(a, (*maxs[a])[i]);
+      }
+      for (int z = from[2]; z <= to[2]; z++)
+        for (int y = from[1]; y <= to[1]; y++)
+          for (int x = from[0]; x <= to[0]; x++)
+          {
+            size_t c = ((size_t)z * _dims[1] + y) * _dims[0] + x;
+            if (pass == 0)
+            { _cellStart[c + 1] += 1; }
+            else
+            { _items[fill[c]++] = (int)i; }
+          }
+    }
+  }
+}
+
+bool CapsuleGrid::ClipSegment(const real *beg, const real *dir,
+                              const real *lo, const real *hi,
+                              real &t0, real &t1)
+{
+  t0 = 0;
+  t1 = 1;
+  for (int a = 0; a < 3; a++)
+  {
+    if (dir[a] == 0)
+    {
+      if (beg[a] < lo[a] || beg[a] > hi[a])
+      { return false; }
+    }
+    else
+    {
+      real ta = (lo[a] - beg[a]) / dir[a];
+      real tb = (hi[a] - beg[a]) / dir[a];
+      if (ta > tb)
+      { std::swap(ta, tb); }
+      t0 = std::max(t0, ta);
+      t1 = std::min(t1, tb);
+      if (t0 > t1)
+      { return false; }
+    }
+  }
+  return true;
+}
+
+void CapsuleGrid::Query(const vec3r &beg, const vec3r &end, std::vector<int> &res) const
+{
+  res.clear();
+  if (_cellStart.empty())
+  { return; }
+
+  real p[3] = { beg.x, beg.y, beg.z };
+  real d[3] = { end.x - beg.x, end.y - beg.y, end.z - beg.z };
+  real t0, t1;
+  if (!ClipSegment(p, d, _lo, _hi, t0, t1))
+  { return; }
+
+  // 3D-DDA: walk through the cells that are crossed by the clipped segment
+  const real inf = std::numeric_limits<real>::max();
+  int idx[3], step[3];
+  real tMax[3], tDelta[3];
+  for (int a = 0; a < 3; a++)
+  {
+    int i = (int)std::floor((p[a] + d[a] * t0 - _lo[a]) / _cellSize);
+    idx[a] = std::max(0, std::min(_dims[a] - 1, i));
+    if (d[a] > 0)
+    {
+      step[a] = 1;
+      tMax[a] = (_lo[a] + (idx[a] + 1) * _cellSize - p[a]) / d[a];
+      tDelta[a] = _cellSize / d[a];
+    }
+    else if (d[a] < 0)
+    {
+      step[a] = -1;
+      tMax[a] = (_lo[a] + idx[a] * _cellSize - p[a]) / d[a];
+      tDelta[a] = -_cellSize / d[a];
+    }
+    else
+    {
+      step[a] = 0;
+      tMax[a] = inf;
+      tDelta[a] = inf;
+    }
+  }
+
+  int maxSteps = _dims[0] + _dims[1] + _dims[2];
+  for (int s = 0; s <= maxSteps; s++)
+  {
+    size_t c = ((size_t)idx[2] * _dims[1] + idx[1]) * _dims[0] + idx[0];
+    res.insert(res.end(), _items.begin() + _cellStart[c], _items.begin() + _cellStart[c + 1]);
+
+    int a = tMax[0] < tMax[1] ? (tMax[0] < tMax[2] ? 0 : 2) : (tMax[1] < tMax[2] ? 1 : 2);
+    if (tMax[a] > t1)
+    { break; }
+    idx[a] += step[a];
+    if (idx[a] < 0 || idx[a] >= _dims[a])
+    { break; }
+    tMax[a] += tDelta[a];
+  }
+
+  std::sort(res.begin(), res.end());
+  res.erase(std::unique(res.begin(), res.end()), res.end());
+
+  // Capsules can occupy only a part of the crossed cell, so check their own boxes as well
+  size_t n = 0;
+  for (size_t i = 0; i < res.size(); i++)
+  {
+    int k = res[i];
+    real lo[3] = { _min_x[k], _min_y[k], _min_z[k] };
+    real hi[3] = { _max_x[k], _max_y[k], _max_z[k] };
+    real s0, s1;
+    if (ClipSegment(p, d, lo, hi, s0, s1))
+    { res[n++] = k; }
+  }
+  res.resize(n);
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include "MiCoSi.Core/Defs.h"
+
+#include "vec3x.h"
+
+// Uniform grid over the set of capsules (segment + radius)
+// It's a broad phase for the segment-vs-object checks: the query returns only those capsules,
+// whose bounding boxes are crossed by the segment, so the exact checks may skip the others
+class CapsuleGrid
+{
+  public:
+    // Bounding boxes are extended by 'eps' in order to tolerate the rounding errors of exact checks
+    CapsuleGrid(real eps = std::numeric_limits<real>::min());
+    CapsuleGrid(const CapsuleGrid &) = delete;
+    CapsuleGrid &operator =(const CapsuleGrid &) = delete;
+
+    // Removes all capsules, must be called before adding the new ones
+    void Clear();
+
+    // Adds capsule, its index equals to the count of the previously added capsules
+    void Add(const vec3r &p1, const vec3r &p2, real radius);
+
+    // Distributes the added capsules between cells of the grid
+    // Must be called after the last 'Add()' and before the first 'Query()'
+    void Build();
+
+    // Returns count of the added capsules
+    size_t Count() const
+    { return _min_x.size(); }
+
+    // Collects indices of capsules that may intersect the [beg, end] segment
+    // Indices are sorted in the ascending order, previous content of 'res' is removed
+    // Method is thread-safe, so the same grid can be shared between threads
+    void Query(const vec3r &beg, const vec3r &end, std::vector<int> &res) const;
+
+  private:
+    // Returns true, if the segment crosses the box, and sets the range of parameter (in [0, 1])
+    static bool ClipSegment(const real *beg, const real *dir,
+                            const real *lo, const real *hi,
+                            real &t0, real &t1);
+
+    real _eps;
+
+    // Bounding boxes of capsules (SoA)
+    std::vector<real> _min_x, _min_y, _min_z;
+    std::vector<real> _max_x, _max_y, _max_z;
+
+    // Grid: bounding box of all capsules, size of a single cell and count of cells along each axis
+    real _lo[3], _hi[3];
+    real _cellSize;
+    int _dims[3];
+
+    // Capsules of the i-th cell are stored as '_items[_cellStart[i] ... _cellStart[i + 1] - 1]'
+    std::vector<int> _cellStart;
+    std::vector<int> _items;
+};
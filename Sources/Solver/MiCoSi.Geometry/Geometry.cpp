@@ -173,7 +173,7 @@ bool Geometry::AreIntersected(const Geometry::Segment &seg,
   real disc = b * b - 4 * a * c;
   if (disc >= (real)0)
   {
-    real t[2] = { (-b - sqrt(disc)) / (2 * a), (-b + sqrt(disc)) / (2 * a) };
+    real t[2] = { (-b - std::sqrt(disc)) / (2 * a), (-b + std::sqrt(disc)) / (2 * a) };
     bool cond[2] = { t[0] >= 0 && t[0] <= len, t[1] >= 0 && t[1] <= len };
     
     for (int i = 0 + (cond[0] ? 0 : 1); i < 2 - (cond[1] ? 0 : 1); i++)
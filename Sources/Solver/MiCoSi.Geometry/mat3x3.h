@@ -179,11 +179,7 @@ class mat3x3
       { a[i] = (T)0.0; }
     }
 
-    inline mat3x3(const mat3x3<T> &mat)
-    {
-      for (int i = 0; i < 9; i++)
-      { a[i] = mat.a[i]; }
-    }
+    mat3x3(const mat3x3<T> &mat) = default;
 
     inline mat3x3(T _11, T _12, T _13,
                   T _21, T _22, T _23,
@@ -271,12 +267,7 @@ class mat3x3
       return (*this) * ((T)1.0 / val);
     }
 
-    inline mat3x3<T> &operator =(const mat3x3<T> &mat)
-    {
-      for (int i = 0; i < 9; i++)
-      { a[i] = mat.a[i]; }
-      return *this;
-    }
+    mat3x3<T> &operator =(const mat3x3<T> &mat) = default;
 };
 
 template <class T>
@@ -302,7 +293,7 @@ class mat3x3_assigner
       return mat;
     }
 
-    inline operator mat3x3<T>()
+    inline operator mat3x3<T>() const
     {
       return mat3x3<T>(*(_pa[0]), *(_pa[1]), *(_pa[2]),
                *(_pa[3]), *(_pa[4]), *(_pa[5]),
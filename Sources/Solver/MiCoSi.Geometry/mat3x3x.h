@@ -60,3 +60,6 @@ typedef mat3x3d_assigner mat3x3r_assigner;
 typedef mat3x3f mat3x3r;
 typedef mat3x3f_assigner mat3x3r_assigner;
 #endif
+
+static_assert(std::is_trivially_copyable<mat3x3r>::value && sizeof(mat3x3r) == 9 * sizeof(real),
+              "mat3x3r must be a trivially copyable array");
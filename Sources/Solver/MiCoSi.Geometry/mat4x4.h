@@ -53,11 +53,7 @@ class mat4x4
         a[i] = 0.0;
     }
 
-    inline mat4x4(const mat4x4<T> &mat)
-    {
-      for (int i = 0; i < 16; i++)
-        a[i] = mat.a[i];
-    }
+    mat4x4(const mat4x4<T> &mat) = default;
 
     inline mat4x4(T _11, T _12, T _13, T _14,
             T _21, T _22, T _23, T _24,
@@ -142,10 +138,5 @@ class mat4x4
       return (*this) * (1.0 / val);
     }
       
-    inline const mat4x4<T> &operator =(const mat4x4<T> &mat)
-    {
-      for (int i = 0; i < 16; i++)
-        this->a[i] = mat.a[i];
-      return *this;
-    }
+    mat4x4<T> &operator =(const mat4x4<T> &mat) = default;
 };
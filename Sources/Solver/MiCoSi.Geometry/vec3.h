@@ -17,46 +17,30 @@ static inline vec3<T> CrossProduct(const vec3<T> &a, const vec3<T> &b)
                    a.x * b.y - a.y * b.x);
 }
 
+// Plain triple of values, trivially copyable, so temporaries live in registers
 template <class T>
 class vec3
 {
-  private:
-    T vals[3];
-
   public:
-    T &x;
-    T &y;
-    T &z;
+    T x;
+    T y;
+    T z;
 
     // Constructors
 
-    inline vec3<T>(): x(vals[0]), y(vals[1]), z(vals[2])
-    {
-      x = (T)0.0;
-      y = (T)0.0;
-      z = (T)0.0;
-    }
+    inline vec3<T>()
+      : x((T)0.0), y((T)0.0), z((T)0.0)
+    { /*nothing*/ }
 
-    inline vec3<T>(const vec3<T> &vec): x(vals[0]), y(vals[1]), z(vals[2])
-    {
-      x = vec.x;
-      y = vec.y;
-      z = vec.z;
-    }
+    vec3<T>(const vec3<T> &vec) = default;
 
-    inline vec3<T>(const vec4<T> &vec): x(vals[0]), y(vals[1]), z(vals[2])
-    {
-      x = vec.x;
-      y = vec.y;
-      z = vec.z;
-    }
-      
-    inline vec3<T>(T x, T y, T z): x(vals[0]), y(vals[1]), z(vals[2])
-    {
-      this->x = x;
-      this->y = y;
-      this->z = z;
-    }
+    inline vec3<T>(const vec4<T> &vec)
+      : x(vec.x), y(vec.y), z(vec.z)
+    { /*nothing*/ }
+
+    inline vec3<T>(T x, T y, T z)
+      : x(x), y(y), z(z)
+    { /*nothing*/ }
 
     // Operators
       
@@ -109,15 +93,9 @@ class vec3
                this->z/vec.z);
     }
       
-    inline const vec3<T> &operator =(const vec3<T> &vec)
-    {
-      this->x = vec.x;
-      this->y = vec.y;
-      this->z = vec.z;
-      return *this;
-    }
+    vec3<T> &operator =(const vec3<T> &vec) = default;
       
-    inline const vec3<T> operator +=(const vec3<T> &vec)
+    inline vec3<T> &operator +=(const vec3<T> &vec)
     {
       this->x += vec.x;
       this->y += vec.y;
@@ -125,7 +103,7 @@ class vec3
       return *this;
     }
       
-    inline const vec3<T> operator -=(const vec3<T> &vec)
+    inline vec3<T> &operator -=(const vec3<T> &vec)
     {
       this->x -= vec.x;
       this->y -= vec.y;
@@ -135,18 +113,18 @@ class vec3
       
     inline T &operator[](const int n)
     {
-      return vals[n];
+      return n == 0 ? x : (n == 1 ? y : z);
     }
       
     inline const T &operator[](const int n) const
     {
-      return vals[n];
+      return n == 0 ? x : (n == 1 ? y : z);
     }
 
-    inline bool operator ==(const vec3<T> &vec)
+    inline bool operator ==(const vec3<T> &vec) const
     { return x == vec.x && y == vec.y && z == vec.z; }
 
-    inline bool operator !=(const vec3<T> &vec)
+    inline bool operator !=(const vec3<T> &vec) const
     { return !(*this == vec); }
 
     inline T GetLength() const
@@ -175,25 +153,21 @@ class vec3
 template <class T>
 class vec3_assigner
 {
-  private:
-    T *_x, *_y, *_z;
-
   public:
     T &x, &y, &z;
     inline vec3_assigner(T *px, T *py, T *pz)
-      : _x(px), _y(py), _z(pz),
-        x(*px), y(*py), z(*pz)
+      : x(*px), y(*py), z(*pz)
     { /*nothing*/ }
 
     inline const vec3<T> &operator=(const vec3<T> &vec)
     {
-      *_x = vec.x;
-      *_y = vec.y;
-      *_z = vec.z;
+      x = vec.x;
+      y = vec.y;
+      z = vec.z;
       
       return vec;
     }
 
-    inline operator vec3<T>()
-    { return vec3<T>(*_x, *_y, *_z); }
+    inline operator vec3<T>() const
+    { return vec3<T>(x, y, z); }
 };
@@ -75,3 +75,7 @@ typedef vec3d_assigner vec3r_assigner;
 typedef vec3f vec3r;
 typedef vec3f_assigner vec3r_assigner;
 #endif
+
+// Vectors are copied as plain memory and kept in registers, see the arrays in 'CellData'
+static_assert(std::is_trivially_copyable<vec3r>::value && sizeof(vec3r) == 3 * sizeof(real),
+              "vec3r must be a trivially copyable triple");
@@ -22,48 +22,27 @@ inline vec4<T> CrossProduct(const vec4<T> &a, const vec4<T> &b)
 template <class T>
 class vec4
 {
-  private:
-    T vals[4];
-
   public:
-    T &x;
-    T &y;
-    T &z;
-    T &w;
+    T x;
+    T y;
+    T z;
+    T w;
 
     // Constructors
 
-    inline vec4<T>(): x(vals[0]), y(vals[1]), z(vals[2]), w(vals[3])
-    {
-      this->x = (T)0.0;
-      this->y = (T)0.0;
-      this->z = (T)0.0;
-      this->w = (T)1.0;
-    }
+    inline vec4<T>()
+      : x((T)0.0), y((T)0.0), z((T)0.0), w((T)1.0)
+    { /*nothing*/ }
 
-    inline vec4<T>(const vec4<T> &vec): x(vals[0]), y(vals[1]), z(vals[2]), w(vals[3])
-    {
-      this->x = vec.x;
-      this->y = vec.y;
-      this->z = vec.z;
-      this->w = vec.w;
-    }
+    vec4<T>(const vec4<T> &vec) = default;
 
-    inline vec4<T>(const vec3<T> &vec): x(vals[0]), y(vals[1]), z(vals[2]), w(vals[3])
-    {
-      this->x = vec.x;
-      this->y = vec.y;
-      this->z = vec.z;
-      this->w = (T)1.0;
-    }
+    inline vec4<T>(const vec3<T> &vec)
+      : x(vec.x), y(vec.y), z(vec.z), w((T)1.0)
+    { /*nothing*/ }
       
-    inline vec4<T>(T x, T y, T z, T w): x(vals[0]), y(vals[1]), z(vals[2]), w(vals[3])
-    {
-      this->x = x;
-      this->y = y;
-      this->z = z;
-      this->w = w;
-    }
+    inline vec4<T>(T x, T y, T z, T w)
+      : x(x), y(y), z(z), w(w)
+    { /*nothing*/ }
 
     // Operators
       
@@ -125,16 +104,9 @@ class vec4
                this->w / vec.w);
     }
       
-    inline const vec4<T> &operator =(const vec4<T> &vec)
-    {
-      this->x = vec.x;
-      this->y = vec.y;
-      this->z = vec.z;
-      this->w = vec.w;
-      return *this;
-    }
+    vec4<T> &operator =(const vec4<T> &vec) = default;
       
-    inline const vec4<T> operator +=(const vec4<T> &vec)
+    inline vec4<T> &operator +=(const vec4<T> &vec)
     {
       this->x += vec.x;
       this->y += vec.y;
@@ -143,7 +115,7 @@ class vec4
       return *this;
     }
       
-    inline const vec4<T> operator -=(const vec4<T> &vec)
+    inline vec4<T> &operator -=(const vec4<T> &vec)
     {
       this->x -= vec.x;
       this->y -= vec.y;
@@ -154,12 +126,12 @@ class vec4
       
     inline T &operator[](const int n)
     {
-      return vals[n];
+      return n == 0 ? x : (n == 1 ? y : (n == 2 ? z : w));
     }
       
     inline const T &operator[](const int n) const
     {
-      return vals[n];
+      return n == 0 ? x : (n == 1 ? y : (n == 2 ? z : w));
     }
 
     inline T GetLength() const
@@ -4,6 +4,7 @@
 #include "CellData.h"
 #include "CellOps.h"
 #include "Chromosome.h"
+#include "ChromosomeGeometry.h"
 #include "ChromosomePair.h"
 #include "Interfaces.h"
 #include "MT.h"
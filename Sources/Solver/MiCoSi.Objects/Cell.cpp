@@ -27,6 +27,9 @@ void Cell::CreateObjects(CellData *data)
     { _MTs[i] = new MT(i, this, _data.get()); }
   }
 
+  // Create cache for chromosomes, it will be filled by solver
+  _geometry.reset(new ChromosomeGeometry(_data->ChromosomePairs() * 2));
+
   // Create chromosomes
   if (_data->ChromosomePairs() != 0)
   {
@@ -75,6 +78,9 @@ Cell::Cell(ICellInitializer *initializer, IPoleUpdater *updater, Random::State &
     }
   }
 
+  // No MTs are bound, so lists of KMTs are empty
+  _data->RebuildKMTIndex();
+
   // Set chromosomes
   if (_data->ChromosomePairs() != 0)
   {
@@ -4,6 +4,7 @@
 #include "MiCoSi.Core/Random.h"
 #include "Interfaces.h"
 #include "CellData.h"
+#include "ChromosomeGeometry.h"
 #include "Pole.h"
 
 // Object-oriented wrapper that describes the whole cell
@@ -36,6 +37,10 @@ class Cell : public ICell, public IClonnable, private ICellObjectProvider
     const CellData &Data() const
     { return *_data.get(); }
 
+    // Derived geometry of chromosomes, solvers update it after moving chromosomes
+    ChromosomeGeometry &GeometryCache() const
+    { return *_geometry.get(); }
+
     virtual IClonnable *Clone() const override;
 
     virtual ~Cell();
@@ -61,6 +66,7 @@ class Cell : public ICell, public IClonnable, private ICellObjectProvider
     void CreateObjects(CellData *data);
 
     std::unique_ptr<CellData> _data;
+    std::unique_ptr<ChromosomeGeometry> _geometry;
     Pole *_poles[2];
     std::vector<MT *> _MTs;
     std::vector<Chromosome *> _chromosomes;
@@ -25,6 +25,10 @@ size_t CellArray::GetSize(CellArray::Type type, size_t chrPairs, size_t mtsPerPo
     case CHR_PAIR_LEFF_CHROMOSOME:   return sizeof(uint32_t) * chrPairs;
     case CHR_PAIR_RIGHT_CHROMOSOME:  return sizeof(uint32_t) * chrPairs;
     case SPRINGS_BROKEN:             return sizeof(uint32_t);
+    case CHR_KMT_COUNT:              return sizeof(uint32_t) * chrPairs * 2;
+    case CHR_KMT_FIRST:              return sizeof(int32_t) * chrPairs * 2;
+    case MT_KMT_NEXT:                return sizeof(int32_t) * mtsPerPole * 2;
+    case MT_KMT_PREV:                return sizeof(int32_t) * mtsPerPole * 2;
     default: throw std::runtime_error("Internal error at CellArray::GetSize(): unknown value");
   }
 }
@@ -50,6 +54,10 @@ std::vector<CellArray::Type> CellArray::AllTypes()
   res.push_back(CHR_PAIR_LEFF_CHROMOSOME);
   res.push_back(CHR_PAIR_RIGHT_CHROMOSOME);
   res.push_back(SPRINGS_BROKEN);
+  res.push_back(CHR_KMT_COUNT);
+  res.push_back(CHR_KMT_FIRST);
+  res.push_back(MT_KMT_NEXT);
+  res.push_back(MT_KMT_PREV);
 
   return res;
 }
@@ -84,6 +92,41 @@ CellData::CellData(size_t chrPairs, size_t mtsPerPole)
   memset(_data, 0, _dataSize);
 }
 
+void CellData::RebuildKMTIndex()
+{
+  size_t chrs = _chrPairs * 2, mts = _mtsPerPole * 2;
+  const int32_t *boundChr = (const int32_t *)GetArray(CellArray::MT_BOUND_CHROMOSOME);
+  uint32_t *count = (uint32_t *)GetArray(CellArray::CHR_KMT_COUNT);
+  int32_t *first = (int32_t *)GetArray(CellArray::CHR_KMT_FIRST);
+  int32_t *next = (int32_t *)GetArray(CellArray::MT_KMT_NEXT);
+  int32_t *prev = (int32_t *)GetArray(CellArray::MT_KMT_PREV);
+
+  // MTs are appended in ascending order of IDs, so lists are sorted
+  std::vector<int32_t> last(chrs, -1);
+  for (size_t i = 0; i < chrs; i++)
+  {
+    count[i] = 0;
+    first[i] = -1;
+  }
+  for (size_t i = 0; i < mts; i++)
+  {
+    next[i] = prev[i] = -1;
+    int32_t chr = boundChr[i];
+    if (chr < 0)
+      continue;
+
+    if (last[chr] < 0)
+      first[chr] = (int32_t)i;
+    else
+    {
+      next[last[chr]] = (int32_t)i;
+      prev[i] = last[chr];
+    }
+    last[chr] = (int32_t)i;
+    count[chr] += 1;
+  }
+}
+
 IClonnable *CellData::Clone() const
 {
   CellData *res = nullptr;
@@ -29,7 +29,13 @@ class CellArray
       CHR_ORIENTATION           = 13,  // real * 9
       CHR_PAIR_LEFF_CHROMOSOME  = 14,  // uint32
       CHR_PAIR_RIGHT_CHROMOSOME = 15,  // uint32
-      SPRINGS_BROKEN            = 16   // single uint32
+      SPRINGS_BROKEN            = 16,  // single uint32
+      // Index of MTs that are bound to kinetochores, is derived from MT_BOUND_CHROMOSOME
+      // Each chromosome has a list of its MTs, sorted by IDs and linked via MT_KMT_NEXT/MT_KMT_PREV
+      CHR_KMT_COUNT             = 17,  // uint32
+      CHR_KMT_FIRST             = 18,  // int32, -1 for the empty list
+      MT_KMT_NEXT               = 19,  // int32, -1 for the last MT
+      MT_KMT_PREV               = 20   // int32, -1 for the first MT
     };
 
     // Returns size (in bytes) of the required array
@@ -80,6 +86,10 @@ class CellData : public IClonnable
     void *GetArray(CellArray::Type type) const
     { return _data + _offsets[type]; }
 
+    // Recreates index of the bound MTs using the MT_BOUND_CHROMOSOME array
+    // MT::Bind() and MT::UnBind() maintain index, so it's required only after direct changes of the array
+    void RebuildKMTIndex();
+
     // IClonnable member
     virtual IClonnable *Clone() const override;
 
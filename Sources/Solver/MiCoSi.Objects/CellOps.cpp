@@ -2,6 +2,26 @@
 
 #include "MT.h"
 #include "Chromosome.h"
+#include "ChromosomePair.h"
+
+namespace
+{
+
+// Returns the pole that holds all KMTs of the kinetochore, -1 if there are no KMTs or they come from both poles
+int KinetochorePole(const Chromosome *chr)
+{
+  int res = -1;
+  for (MT *mt : chr->KMTs())
+  {
+    int pole = (int)mt->GetPole()->Type();
+    if (res >= 0 && res != pole)
+    { return -1; }
+    res = pole;
+  }
+  return res;
+}
+
+} // unnamed namespace
 
 CellOps::CellOps(const Cell *cell)
   : _cell(cell)
@@ -11,50 +31,27 @@ CellOps::CellOps(const Cell *cell)
 
 std::vector<size_t> CellOps::CountKMTs() const
 {
-  const auto &mts = _cell->MTs();
   const auto &chrs = _cell->Chromosomes();
 
   std::vector<size_t> res(chrs.size());
-  for (size_t i = 0; i < mts.size(); i++)
-  {
-    auto chr = mts[i]->BoundChromosome();
-    if (chr != nullptr)
-    { res[chr->ID()] += 1; }
-  }
+  for (size_t i = 0; i < chrs.size(); i++)
+  { res[i] = chrs[i]->KMTCount(); }
 
 	return res;
 }
 
 size_t CellOps::CountKMTs(const Chromosome *chr) const
 {
-  size_t res = 0;
-
-  if (chr != nullptr)
-  {
-    const auto &mts = _cell->MTs();
-    for (size_t i = 0; i < mts.size(); i++)
-    {
-      auto chr_i = mts[i]->BoundChromosome();
-      if (chr_i != chr)
-      { res += 1; }
-    }
-  }
-
-	return res;
+  return chr != nullptr ? chr->KMTCount() : 0;
 }
 
 std::vector<std::vector<MT *> > CellOps::ExtractKMTs() const
 {
-  const auto &mts = _cell->MTs();
   const auto &chrs = _cell->Chromosomes();
 
   std::vector<std::vector<MT *> > res(chrs.size());
-  for (size_t i = 0; i < mts.size(); i++)
-  {
-    auto chr = mts[i]->BoundChromosome();
-    if (chr != nullptr)
-    { res[chr->ID()].emplace_back(mts[i]); }
-  }
+  for (size_t i = 0; i < chrs.size(); i++)
+  { res[i] = ExtractKMTs(chrs[i]); }
 
 	return res;
 }
@@ -64,14 +61,23 @@ std::vector<MT *> CellOps::ExtractKMTs(const Chromosome *chr) const
   std::vector<MT *> res;
   if (chr != nullptr)
   {
-    const auto &mts = _cell->MTs();
-    for (size_t i = 0; i < mts.size(); i++)
-    {
-      auto chr_i = mts[i]->BoundChromosome();
-      if (chr_i == chr)
-      { res.emplace_back(mts[i]); }
-    }
+    res.reserve(chr->KMTCount());
+    for (MT *mt : chr->KMTs())
+    { res.emplace_back(mt); }
   }
 
 	return res;
 }
+
+bool CellOps::AreAllAmphitelic() const
+{
+  for (ChromosomePair *pair : _cell->ChromosomePairs())
+  {
+    int left = KinetochorePole(pair->LeftChromosome());
+    int right = KinetochorePole(pair->RightChromosome());
+    if (left < 0 || right < 0 || left == right)
+    { return false; }
+  }
+
+  return !_cell->ChromosomePairs().empty();
+}
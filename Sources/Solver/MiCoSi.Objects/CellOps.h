@@ -15,22 +15,25 @@ class CellOps
 
     // Counts the number of MTs that are bound to kinetochores
     // Enumeration corresponds to the vector with chromosomes
-    // Note: this operation is not fast, do not abuse it
+    // Note: allocates memory, solvers should use 'Chromosome::KMTCount()' instead
     std::vector<size_t> CountKMTs() const;
 
     // Version that counts KMTs for single chromosome
-    // Note: this operation is not fast, do not abuse it
     size_t CountKMTs(const Chromosome *chr) const;
 
     // Extracts MT objects that are bound to kinetochores
     // Enumeration corresponds to the vector with chromosomes
-    // Note: this operation is not fast, do not abuse it
+    // Note: allocates memory, solvers should use 'Chromosome::KMTs()' instead
     std::vector<std::vector<MT *> > ExtractKMTs() const;
 
     // Version that extracts KMTs for single chromosome
-    // Note: this operation is not fast, do not abuse it
+    // Note: allocates memory, solvers should use 'Chromosome::KMTs()' instead
     std::vector<MT *> ExtractKMTs(const Chromosome *chr) const;
 
+    // True, if each pair of sister kinetochores is bound to the opposite poles and only to them
+    // Doesn't allocate memory, so solvers may call it after each iteration
+    bool AreAllAmphitelic() const;
+
   private:
     const Cell *_cell;
 };
@@ -9,5 +9,8 @@ Chromosome::Chromosome(uint32_t ID, const ICellObjectProvider *objects, const Ce
 	: _ID(ID), _objects(objects), _mtsPerPole(data->MTsPerPole()),
 	  _arr_pos((real *)data->GetArray(CellArray::CHR_POSITION)),
 	  _arr_orient((real *)data->GetArray(CellArray::CHR_ORIENTATION)),
-	  _arr_bound_mts((int32_t *)data->GetArray(CellArray::MT_BOUND_CHROMOSOME))
+	  _arr_bound_mts((int32_t *)data->GetArray(CellArray::MT_BOUND_CHROMOSOME)),
+	  _arr_kmt_count((uint32_t *)data->GetArray(CellArray::CHR_KMT_COUNT)),
+	  _arr_kmt_first((int32_t *)data->GetArray(CellArray::CHR_KMT_FIRST)),
+	  _arr_kmt_next((int32_t *)data->GetArray(CellArray::MT_KMT_NEXT))
 { /*nothing*/ }
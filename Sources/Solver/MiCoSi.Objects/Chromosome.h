@@ -5,6 +5,62 @@
 #include "Interfaces.h"
 #include "CellData.h"
 
+// View of MTs that are bound to the chromosome, in ascending order of IDs
+// Walks through the index from 'CellData', doesn't allocate memory
+class KMTList
+{
+  public:
+    class Iterator
+    {
+      public:
+        Iterator(const ICellObjectProvider *objects, const int32_t *next, int32_t ID)
+          : _objects(objects), _next(next), _ID(ID)
+        { /*nothing*/ }
+
+        MT *operator *() const
+        { return _objects->GetMT((uint32_t)_ID); }
+
+        Iterator &operator ++()
+        { _ID = _next[_ID]; return *this; }
+
+        Iterator operator ++(int)
+        { Iterator res = *this; _ID = _next[_ID]; return res; }
+
+        bool operator ==(const Iterator &other) const
+        { return _ID == other._ID; }
+
+        bool operator !=(const Iterator &other) const
+        { return _ID != other._ID; }
+
+      private:
+        const ICellObjectProvider *_objects;
+        const int32_t *_next;
+        int32_t _ID;
+    };
+
+    KMTList(const ICellObjectProvider *objects, const int32_t *next, int32_t first, uint32_t count)
+      : _objects(objects), _next(next), _first(first), _count(count)
+    { /*nothing*/ }
+
+    Iterator begin() const
+    { return Iterator(_objects, _next, _first); }
+
+    Iterator end() const
+    { return Iterator(_objects, _next, -1); }
+
+    size_t size() const
+    { return _count; }
+
+    bool empty() const
+    { return _count == 0; }
+
+  private:
+    const ICellObjectProvider *_objects;
+    const int32_t *_next;
+    int32_t _first;
+    uint32_t _count;
+};
+
 class Chromosome
 {
   public:
@@ -28,6 +84,14 @@ class Chromosome
     const mat3x3r Orientation() const
     { real *p = _arr_orient + _ID * 9; return mat3x3r(p[0], p[1], p[2], p[3], p[4], p[5], p[6], p[7], p[8]); }
 
+    // Count of MTs that are bound to the kinetochore
+    uint32_t KMTCount() const
+    { return _arr_kmt_count[_ID]; }
+
+    // MTs that are bound to the kinetochore, the list must not be changed during iteration
+    KMTList KMTs() const
+    { return KMTList(_objects, _arr_kmt_next, _arr_kmt_first[_ID], _arr_kmt_count[_ID]); }
+
   private:
     const ICellObjectProvider *_objects;
 
@@ -36,4 +100,6 @@ class Chromosome
     real *_arr_pos;
     real *_arr_orient;
     int32_t *_arr_bound_mts;
+    uint32_t *_arr_kmt_count;
+    int32_t *_arr_kmt_first, *_arr_kmt_next;
 };
@@ -0,0 +1,75 @@
+#include "ChromosomeGeometry.h"
+
+#include "MiCoSi.Geometry/mat3x3x.h"
+#include "Chromosome.h"
+
+//--------------------------
+//--- ChromosomeGeometry ---
+//--------------------------
+
+ChromosomeGeometry::ChromosomeGeometry(size_t chromosomes)
+  : _count(chromosomes), _boundRadius(0), _valid(false)
+{
+  // Each array is padded, so all of them are aligned
+  const size_t perLine = ALIGNMENT / sizeof(real);
+  _stride = std::max((size_t)1, (_count + perLine - 1) / perLine) * perLine;
+
+  size_t size = sizeof(real) * _stride * 3 * FIELD_COUNT;
+  _raw = (uint8_t *)malloc(size + ALIGNMENT);
+  if (_raw == nullptr)
+  { throw std::runtime_error("failed to allocate memory for chromosome geometry"); }
+  _data = (real *)(_raw + (ALIGNMENT - (uintptr_t)_raw % ALIGNMENT) % ALIGNMENT);
+  memset(_data, 0, size);
+}
+
+void ChromosomeGeometry::Update(const std::vector<Chromosome *> &chrs,
+                                real cr_l, real cr_kin_l, real cr_hand_r, real cr_kin_r)
+{
+  if (chrs.size() != _count)
+  { throw std::runtime_error("internal error, wrong count of chromosomes"); }
+
+  // Small reserve for the orientation matrices that are not exactly orthogonal
+  real boundHalfLen = std::max(cr_l, cr_kin_l) / 2 * (real)1.001;
+  _boundRadius = std::max(cr_hand_r, cr_kin_r) * (real)1.001;
+
+  for (size_t i = 0; i < _count; i++)
+  {
+    Chromosome *cr = chrs[i];
+    vec3r pos = (vec3r)cr->Position();
+    mat3x3r chrOrient = (mat3x3r)cr->Orientation();
+    vec3r ortX = (chrOrient * vec3r(1, 0, 0)).Normalize();
+    vec3r ortY = (chrOrient * vec3r(0, 1, 0)).Normalize();
+    vec3r ortZ = (chrOrient * vec3r(0, 0, 1)).Normalize();
+
+    Set(POSITION, i, pos);
+    Set(ORT_X, i, ortX);
+    Set(ORT_Y, i, ortY);
+    Set(ORT_Z, i, ortZ);
+
+    Set(UPPER_HAND_BEG, i, pos + ortY * (real)(cr_kin_l / 2));
+    Set(UPPER_HAND_END, i, pos + ortY * (real)(cr_l / 2));
+    Set(LOWER_HAND_BEG, i, pos + ortY * (real)(-cr_kin_l / 2));
+    Set(LOWER_HAND_END, i, pos + ortY * (real)(-cr_l / 2));
+    Set(HAND_R1, i, ortZ * -cr_hand_r);
+    Set(HAND_R2, i, ortX *  cr_hand_r);
+
+    Set(KIN_BEG, i, pos + chrOrient * vec3r((real)0, (real)(-cr_kin_l / 2), (real)0));
+    Set(KIN_END, i, pos + chrOrient * vec3r((real)0, (real)(cr_kin_l / 2), (real)0));
+    Set(KIN_R, i, ortX * cr_kin_r);
+
+    Set(BOUND_BEG, i, pos - ortY * boundHalfLen);
+    Set(BOUND_END, i, pos + ortY * boundHalfLen);
+  }
+
+  _valid = true;
+}
+
+ChromosomeGeometry::~ChromosomeGeometry()
+{
+  if (_raw != nullptr)
+  {
+    free(_raw);
+    _raw = nullptr;
+    _data = nullptr;
+  }
+}
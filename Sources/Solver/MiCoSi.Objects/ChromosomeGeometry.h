@@ -0,0 +1,88 @@
+#pragma once
+#include "MiCoSi.Core/Defs.h"
+
+#include "MiCoSi.Geometry/vec3x.h"
+
+class Chromosome;
+
+// Per-step cache with derived geometry of chromosomes: axes, hands, kinetochores and bounds
+// Values are stored as aligned SoA arrays (one array per coordinate of each field)
+// It's not a part of CellData, must be updated after each movement of chromosomes
+class ChromosomeGeometry
+{
+  public:
+    enum Field
+    {
+      POSITION          = 0,
+      ORT_X             = 1,    // normalized axes of chromosome
+      ORT_Y             = 2,
+      ORT_Z             = 3,
+      UPPER_HAND_BEG    = 4,    // segments of hands, from kinetochore to the end of hand
+      UPPER_HAND_END    = 5,
+      LOWER_HAND_BEG    = 6,
+      LOWER_HAND_END    = 7,
+      HAND_R1           = 8,    // radiuses of hand, as "-ortZ * r" and "ortX * r"
+      HAND_R2           = 9,
+      KIN_BEG           = 10,   // axis of kinetochore's semi-tube
+      KIN_END           = 11,
+      KIN_R             = 12,   // radius of kinetochore's semi-tube, as "ortX * r"
+      BOUND_BEG         = 13,   // axis of bounding capsule
+      BOUND_END         = 14,
+      FIELD_COUNT       = 15
+    };
+
+    ChromosomeGeometry(size_t chromosomes);
+    ChromosomeGeometry(const ChromosomeGeometry &) = delete;
+    ChromosomeGeometry &operator =(const ChromosomeGeometry &) = delete;
+
+    // Recomputes all values using the current positions and orientations of chromosomes
+    void Update(const std::vector<Chromosome *> &chrs,
+                real cr_l, real cr_kin_l, real cr_hand_r, real cr_kin_r);
+
+    // False, if cache was not updated yet
+    bool IsValid() const
+    { return _valid; }
+
+    // Marks cache as obsolete (e.g. after loading a new cell state)
+    void Invalidate()
+    { _valid = false; }
+
+    // Count of chromosomes
+    size_t Count() const
+    { return _count; }
+
+    // Returns aligned array with one coordinate (0 - x, 1 - y, 2 - z) of the field for all chromosomes
+    const real *GetArray(Field field, int axis) const
+    { return _data + (field * 3 + axis) * _stride; }
+
+    // Returns value of the field for the required chromosome
+    vec3r Get(Field field, size_t chr) const
+    {
+      const real *p = _data + field * 3 * _stride + chr;
+      return vec3r(p[0], p[_stride], p[2 * _stride]);
+    }
+
+    // Radius of bounding capsules, the same for all chromosomes
+    real BoundRadius() const
+    { return _boundRadius; }
+
+    ~ChromosomeGeometry();
+
+  private:
+    static const int ALIGNMENT = 64;  // in bytes
+
+    void Set(Field field, size_t chr, const vec3r &val)
+    {
+      real *p = _data + field * 3 * _stride + chr;
+      p[0] = val.x;
+      p[_stride] = val.y;
+      p[2 * _stride] = val.z;
+    }
+
+    size_t _count;
+    size_t _stride;         // distance between arrays, in elements
+    uint8_t *_raw;
+    real *_data;
+    real _boundRadius;
+    bool _valid;
+};
@@ -18,7 +18,11 @@ MT::MT(uint32_t ID, const ICellObjectProvider *objects, const CellData *data)
 	  _arr_force_z((real *)data->GetArray(CellArray::MT_FORCE_OFFSET_Z)),
 	  _arr_lengthes((real *)data->GetArray(CellArray::MT_LENGTH)),
 	  _arr_states((uint32_t *)data->GetArray(CellArray::MT_STATE)),
-	  _arr_bound_chrs((int32_t *)data->GetArray(CellArray::MT_BOUND_CHROMOSOME))
+	  _arr_bound_chrs((int32_t *)data->GetArray(CellArray::MT_BOUND_CHROMOSOME)),
+	  _arr_kmt_count((uint32_t *)data->GetArray(CellArray::CHR_KMT_COUNT)),
+	  _arr_kmt_first((int32_t *)data->GetArray(CellArray::CHR_KMT_FIRST)),
+	  _arr_kmt_next((int32_t *)data->GetArray(CellArray::MT_KMT_NEXT)),
+	  _arr_kmt_prev((int32_t *)data->GetArray(CellArray::MT_KMT_PREV))
 { /*nothing*/ }
 
 Chromosome *MT::BoundChromosome()
@@ -29,5 +33,47 @@ Chromosome *MT::BoundChromosome()
 
 void MT::Bind(Chromosome *cr)
 {
-	_arr_bound_chrs[_ID] = cr->ID();
+	int32_t chr = (int32_t)cr->ID();
+	if (_arr_bound_chrs[_ID] == chr)
+		return;
+	UnBind();
+
+	// Lists are sorted by IDs, so the order of iteration doesn't depend on the order of binding
+	int32_t id = (int32_t)_ID, prev = -1, next = _arr_kmt_first[chr];
+	while (next >= 0 && next < id)
+	{
+		prev = next;
+		next = _arr_kmt_next[next];
+	}
+
+	_arr_kmt_prev[id] = prev;
+	_arr_kmt_next[id] = next;
+	if (prev < 0)
+		_arr_kmt_first[chr] = id;
+	else
+		_arr_kmt_next[prev] = id;
+	if (next >= 0)
+		_arr_kmt_prev[next] = id;
+
+	_arr_kmt_count[chr] += 1;
+	_arr_bound_chrs[_ID] = chr;
+}
+
+void MT::UnBind()
+{
+	int32_t chr = _arr_bound_chrs[_ID];
+	if (chr < 0)
+		return;
+
+	int32_t prev = _arr_kmt_prev[_ID], next = _arr_kmt_next[_ID];
+	if (prev < 0)
+		_arr_kmt_first[chr] = next;
+	else
+		_arr_kmt_next[prev] = next;
+	if (next >= 0)
+		_arr_kmt_prev[next] = prev;
+	_arr_kmt_prev[_ID] = _arr_kmt_next[_ID] = -1;
+
+	_arr_kmt_count[chr] -= 1;
+	_arr_bound_chrs[_ID] = -1;
 }
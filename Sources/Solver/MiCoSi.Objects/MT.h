@@ -60,6 +60,7 @@ class MT
     // The 'nullptr' value means that MT is not bound
     Chromosome *BoundChromosome();
 
+    // Updates index of the bound MTs as well, takes O(count of MTs bound to the chromosome)
     void Bind(Chromosome *cr);
 
     // Defines the point which the MT tail is located in
@@ -70,8 +71,12 @@ class MT
     vec3r ForcePoint() const
     { return EndPoint() + ForceOffset(); }
 
-    void UnBind()
-    { _arr_bound_chrs[_ID] = -1; }
+    // Updates index of the bound MTs as well, takes O(1)
+    void UnBind();
+
+    // ID of the next MT bound to the same chromosome (see 'Chromosome::KMTs()'), -1 for the last one
+    int32_t NextKMT() const
+    { return _arr_kmt_next[_ID]; }
 
   private:
     const ICellObjectProvider *_objects;
@@ -83,4 +88,6 @@ class MT
     real *_arr_lengthes;
     uint32_t *_arr_states;
     int32_t *_arr_bound_chrs;
+    uint32_t *_arr_kmt_count;
+    int32_t *_arr_kmt_first, *_arr_kmt_next, *_arr_kmt_prev;
 };
@@ -31,14 +31,13 @@ CellStats CellStats::Create(const Cell *cell)
     polyMTs += mt->State() == MTState::Polymerization ? 1 : 0;
   }
 
-  CellOps ops(cell);
-  auto kmts_per_chr = ops.CountKMTs();
+  const auto &chrs = cell->Chromosomes();
   int maxBoundMTsPerChr = -1;
   int minBoundMTsPerChr = -1;
 
-  for (size_t i = 0; i < kmts_per_chr.size(); i++)
+  for (size_t i = 0; i < chrs.size(); i++)
   {
-    int boundMTs = (int)kmts_per_chr[i];
+    int boundMTs = (int)chrs[i]->KMTCount();
     maxBoundMTsPerChr = std::max(maxBoundMTsPerChr, boundMTs);
     if (minBoundMTsPerChr < 0)
     { minBoundMTsPerChr = boundMTs; }
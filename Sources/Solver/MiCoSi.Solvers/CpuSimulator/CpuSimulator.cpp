@@ -1,67 +1,292 @@
 #include "CpuSimulator.h"
 
+#include "MiCoSi.Core/ThreadAffinity.h"
+#include "FreeMTSchedule.h"
+
 #include <omp.h>
 
 //--------------------
 //--- CpuSimulator ---
 //--------------------
 
-CpuSimulator::CpuSimulator(IPoleUpdater &updater, size_t num_threads)
-  : _updater(updater.CloneTemplated<IPoleUpdater>()), _omp_num_threads((int)num_threads)
+CpuSimulator::CpuSimulator(IPoleUpdater &updater, size_t num_threads, Mode mode, bool deterministic)
+  : _updater(updater.CloneTemplated<IPoleUpdater>()), _omp_num_threads((int)num_threads),
+    _mode(mode), _deterministic(deterministic), _pinThreads(false), _firstTouch(false)
 {
   if (_omp_num_threads <= 0)
   { _omp_num_threads = std::max(1, omp_get_num_procs()); }
 }
 
+void CpuSimulator::SetPlacement(bool pinThreads, bool firstTouch)
+{
+  _pinThreads = pinThreads;
+  _firstTouch = firstTouch;
+}
+
 void CpuSimulator::Import(CpuSimulator::CellEnsemble &cells)
 {
   _cells = std::move(cells);
+  _schedules.clear();
+  _costs.assign(_cells.size(), 0.0);
+  UpdateActiveCells();
+
+  if (_pinThreads)
+  {
+    // Threads of OpenMP are reused by the next regions, so they stay on their processors
+    // Teams of steps never exceed '_omp_num_threads' (intra-cell steps use all of them), so all threads are pinned
+#pragma omp parallel num_threads(_omp_num_threads)
+    { ThreadAffinity::PinCurrentThread(omp_get_thread_num()); }
+  }
+
+  if (_firstTouch)
+  {
+    // Cells were created by the main thread, so their pages are on its node
+    // Copies are made with the same static schedule as the steps, pages of each copy are local to its owner
+#pragma omp parallel for schedule(static) num_threads(NumThreads())
+    for (int i = 0; i < (int)_cells.size(); i++)
+    { _cells[i] = std::make_unique<CellWithRng>(_cells[i]->CellObject(), _cells[i]->Rng()); }
+  }
+}
+
+void CpuSimulator::UpdateActiveCells()
+{
+  _active.clear();
+  for (size_t i = 0; i < _cells.size(); i++)
+  {
+    if (!IsRetired(i))
+    { _active.push_back((int)i); }
+  }
+}
+
+void CpuSimulator::MaterializeFreeMTs()
+{
+  for (size_t i = 0; i < _schedules.size(); i++)
+  {
+    if (_schedules[i] != nullptr)
+    { _schedules[i]->Materialize(_cells[i]->CellObject()); }
+  }
+}
+
+bool CpuSimulator::PrepareFreeMTs(const SimParamsSnapshot &params)
+{
+  if (params[SimParameter::Int::Free_MT_Engine] != 0)
+  {
+    if (_schedules.empty())
+    {
+      for (size_t i = 0; i < _cells.size(); i++)
+      {
+        if (_cells[i] != nullptr)
+        { _schedules.push_back(std::make_unique<FreeMTSchedule>(_cells[i]->CellObject().MTs().size())); }
+        else
+        { _schedules.emplace_back(); }
+      }
+    }
+    return true;
+  }
+
+  // The engine was switched, lengths must be actual for the fixed-step versions
+  MaterializeFreeMTs();
+  _schedules.clear();
+  return false;
+}
+
+bool CpuSimulator::DoPhase(size_t cell, const Phase &phase, bool eventDriven)
+{
+  Cell &obj = _cells[cell]->CellObject();
+  Random::State &rng = _cells[cell]->Rng();
+  switch (phase.type)
+  {
+    case Phase::PoleUpdating:
+      DoPoleUpdatingStep(obj, rng, *phase.params, _updater.get(), phase.time);
+      break;
+
+    case Phase::Macro:
+      DoMacroStep(obj, rng, *phase.params);
+      break;
+
+    case Phase::Micro:
+      if (eventDriven)
+      { DoEventMicroStep(obj, rng, *phase.params, *_schedules[cell]); }
+      else if (_deterministic)
+      { DoMicroStep(obj, rng, *phase.params, 1); }
+      else
+      { DoMicroStep(obj, rng, *phase.params); }
+      break;
+
+    case Phase::SpringBreaking:
+      DoSpringBreakingStep(obj, *phase.params);
+      return !TryRetire(cell, obj, *phase.params, phase.end);
+  }
+  return true;
 }
 
-void CpuSimulator::DoMacroStep(double time)
+void CpuSimulator::DoMacroStep(double time, const SimParamsSnapshot &params)
 {
-#pragma omp parallel for num_threads(NumThreads())
-  for (int i = 0; i < (int)_cells.size(); i++)
+#pragma omp parallel for schedule(static) num_threads(NumThreads())
+  for (int k = 0; k < (int)_active.size(); k++)
   {
-    DoMacroStep(_cells[i]->CellObject(), _cells[i]->Rng());
+    int i = _active[k];
+    DoMacroStep(_cells[i]->CellObject(), _cells[i]->Rng(), params);
   }
 }
 
-void CpuSimulator::DoMicroStep(double time)
+void CpuSimulator::DoMicroStep(double time, const SimParamsSnapshot &params)
 {
-#pragma omp parallel for num_threads(NumThreads())
-  for (int i = 0; i < (int)_cells.size(); i++)
+  if (PrepareFreeMTs(params))
+  {
+    // Each cell has its own schedule, so cells are still processed concurrently
+#pragma omp parallel for schedule(static) num_threads(NumThreads())
+    for (int k = 0; k < (int)_active.size(); k++)
+    {
+      int i = _active[k];
+      DoEventMicroStep(_cells[i]->CellObject(), _cells[i]->Rng(), params, *_schedules[i]);
+    }
+    return;
+  }
+
+  if (_mode == IntraCell)
   {
-    DoMicroStep(_cells[i]->CellObject(), _cells[i]->Rng());
+    // Cells are processed one by one, all threads share MTs of the current cell
+    for (size_t k = 0; k < _active.size(); k++)
+    {
+      size_t i = (size_t)_active[k];
+      DoMicroStep(_cells[i]->CellObject(), _cells[i]->Rng(), params, _omp_num_threads);
+    }
+    return;
+  }
+
+#pragma omp parallel for schedule(static) num_threads(NumThreads())
+  for (int k = 0; k < (int)_active.size(); k++)
+  {
+    int i = _active[k];
+    if (_deterministic)
+    { DoMicroStep(_cells[i]->CellObject(), _cells[i]->Rng(), params, 1); }
+    else
+    { DoMicroStep(_cells[i]->CellObject(), _cells[i]->Rng(), params); }
   }
 }
 
-void CpuSimulator::DoPoleUpdatingStep(double time)
+void CpuSimulator::DoPoleUpdatingStep(double time, const SimParamsSnapshot &params)
 {
-#pragma omp parallel for num_threads(NumThreads())
-  for (int i = 0; i < (int)_cells.size(); i++)
+#pragma omp parallel for schedule(static) num_threads(NumThreads())
+  for (int k = 0; k < (int)_active.size(); k++)
   {
-    DoPoleUpdatingStep(_cells[i]->CellObject(), _cells[i]->Rng(), _updater.get(), time);
+    int i = _active[k];
+    DoPoleUpdatingStep(_cells[i]->CellObject(), _cells[i]->Rng(), params, _updater.get(), time);
   }
 }
 
-void CpuSimulator::DoSpringBreakingStep(double time)
+void CpuSimulator::DoSpringBreakingStep(double time, const SimParamsSnapshot &params)
 {
-#pragma omp parallel for num_threads(NumThreads())
-  for (int i = 0; i < (int)_cells.size(); i++)
+#pragma omp parallel for schedule(static) num_threads(NumThreads())
+  for (int k = 0; k < (int)_active.size(); k++)
   {
-    DoSpringBreakingStep(_cells[i]->CellObject(), _cells[i]->Rng());
+    int i = _active[k];
+    DoSpringBreakingStep(_cells[i]->CellObject(), params);
   }
 }
 
+void CpuSimulator::DoIterationBatch(const StepParams &params, const std::vector<IterationPlan> &plans)
+{
+  if (_mode == IntraCell)
+  {
+    Simulator::DoIterationBatch(params, plans);
+    return;
+  }
+
+  // Cells are independent, so each of them does all steps of the batch without synchronization
+  std::vector<Phase> phases;
+  for (size_t k = 0; k < plans.size(); k++)
+  {
+    const IterationPlan &plan = plans[k];
+    double end = plan.time + params.dt;
+    Phase pole = { Phase::PoleUpdating, plan.time, &params.common, end };
+    phases.push_back(pole);
+    if (plan.macro)
+    {
+      Phase macro = { Phase::Macro, plan.time, &params.macro, end };
+      phases.push_back(macro);
+    }
+    for (int i = 0; i < params.substeps; i++)
+    {
+      Phase micro = { Phase::Micro, plan.time + params.dt * i / params.substeps, &params.micro, end };
+      phases.push_back(micro);
+    }
+    Phase spring = { Phase::SpringBreaking, plan.time, &params.common, end };
+    phases.push_back(spring);
+  }
+  bool eventDriven = PrepareFreeMTs(params.micro);
+
+  // Retired cells skip the rest of the batch, their threads take the remaining cells
+  // from the next batch on (the dynamic versions - at once)
+  if (_mode == CellSteps)
+  {
+    // Each thread keeps the same cells, so their data stays in its cache
+#pragma omp parallel for schedule(static) num_threads(NumThreads())
+    for (int k = 0; k < (int)_active.size(); k++)
+    {
+      for (size_t j = 0; j < phases.size(); j++)
+      {
+        if (!DoPhase((size_t)_active[k], phases[j], eventDriven))
+        { break; }
+      }
+    }
+    UpdateActiveCells();
+    return;
+  }
+
+  // Costs of cells change slowly, the longest tasks of the last batch are started first
+  // and the free threads take the rest one by one
+  std::vector<int> order(_active);
+  std::stable_sort(order.begin(), order.end(), [this](int a, int b) { return _costs[a] > _costs[b]; });
+
+#pragma omp parallel for schedule(dynamic, 1) num_threads(NumThreads())
+  for (int k = 0; k < (int)order.size(); k++)
+  {
+    int i = order[k];
+    double start = omp_get_wtime();
+    for (size_t j = 0; j < phases.size(); j++)
+    {
+      if (!DoPhase((size_t)i, phases[j], eventDriven))
+      { break; }
+    }
+    _costs[i] = omp_get_wtime() - start;
+  }
+  UpdateActiveCells();
+}
+
+void CpuSimulator::RetireCells(double time, const SimParamsSnapshot &params)
+{
+  for (size_t k = 0; k < _active.size(); k++)
+  { TryRetire((size_t)_active[k], _cells[_active[k]]->CellObject(), params, time); }
+  UpdateActiveCells();
+}
+
+std::unique_ptr<CellWithRng> CpuSimulator::DetachCell(size_t cell)
+{
+  if (!_schedules.empty() && _schedules[cell] != nullptr)
+  {
+    _schedules[cell]->Materialize(_cells[cell]->CellObject());
+    _schedules[cell].reset();
+  }
+  return std::move(_cells[cell]);
+}
+
 const CpuSimulator::CellEnsemble &CpuSimulator::SynchronizeCells()
 {
+  MaterializeFreeMTs();
   return _cells;
 }
 
 void CpuSimulator::FormatStats(std::vector<CellStats> &stats)
 {
+  MaterializeFreeMTs();
   stats.clear();
   for (size_t i = 0; i < _cells.size(); i++)
-  { stats.push_back(CellStats::Create(&_cells[i]->CellObject())); }
+  {
+    if (_cells[i] != nullptr)
+    { stats.push_back(CellStats::Create(&_cells[i]->CellObject())); }
+    else
+    { stats.push_back(ReleasedStats(i)); }
+  }
 }
@@ -4,42 +4,111 @@
 #include "MiCoSi.Objects/Interfaces.h"
 #include "../Simulator.h"
 
+class FreeMTSchedule;
+
 // Parallel gold version of the algorithm that supports all available features
 class CpuSimulator : public Simulator
 {
   public:
+    // Distribution of work between threads
+    enum Mode
+    {
+      CellSteps,    // cells are split between threads statically, each thread keeps its cells for the whole batch
+      IntraCell,    // cells are processed one by one, MTs of the cell are split between threads
+      CellTasks     // threads take cells dynamically, the expensive cells are started first
+    };
+
     CpuSimulator() = delete;
-    CpuSimulator(IPoleUpdater &updater, size_t num_threads);
+    // In the deterministic mode all versions use the per-MT RNG substreams of the intra-cell micro step,
+    // so results don't depend on the mode and on the count of threads
+    CpuSimulator(IPoleUpdater &updater, size_t num_threads, Mode mode = CellSteps, bool deterministic = false);
     CpuSimulator &operator =(const CpuSimulator &) = delete;
 
+    // Placement of cells on NUMA machines, must be set before the cells are imported
+    // Each thread owns the same cells in all steps, except the "cpu-tasks" version that distributes cells dynamically
+    // 'pinThreads' binds threads to processors, 'firstTouch' copies each cell by the thread that owns it
+    void SetPlacement(bool pinThreads, bool firstTouch);
+
     // Versions for debugging - can be called from other simulators
 
-    static void DoMacroStep(Cell &cell, Random::State &state);
+    static void DoMacroStep(Cell &cell, Random::State &state, const SimParamsSnapshot &params);
+
+    static void DoMicroStep(Cell &cell, Random::State &state, const SimParamsSnapshot &params);
 
-    static void DoMicroStep(Cell &cell, Random::State &state);
+    // Splits MTs of the single cell between threads, each MT uses its own RNG substream
+    // Collisions with chromosomes are checked by batches of MTs (see 'BatchGeometry')
+    // Results don't depend on the count of threads but differ from the sequential version
+    static void DoMicroStep(Cell &cell, Random::State &state, const SimParamsSnapshot &params, int num_threads);
 
-    static void DoPoleUpdatingStep(Cell &cell, Random::State &state, IPoleUpdater *updater, double time);
+    // Event-driven version: free MTs are touched only by their events (catastrophes, rescues,
+    // collisions with the cell's boundary) and while they are near chromosomes
+    // Lengths of free MTs in the cell are updated lazily, see 'FreeMTSchedule::Materialize()'
+    static void DoEventMicroStep(Cell &cell, Random::State &state, const SimParamsSnapshot &params,
+                                 FreeMTSchedule &schedule);
 
-    static void DoSpringBreakingStep(Cell &cell, Random::State &state);
+    static void DoPoleUpdatingStep(Cell &cell, Random::State &state, const SimParamsSnapshot &params,
+                                   IPoleUpdater *updater, double time);
+
+    static void DoSpringBreakingStep(Cell &cell, const SimParamsSnapshot &params);
+
+    // Recomputes the cached geometry of chromosomes, is called by the macro step
+    // Other steps use the cache and don't touch positions and orientations of chromosomes
+    static void UpdateChromosomeGeometry(Cell &cell, const SimParamsSnapshot &params);
 
   private:
     virtual void Import(CellEnsemble &cells) override;
 
-    virtual void DoMacroStep(double time) override;
+    virtual void DoMacroStep(double time, const SimParamsSnapshot &params) override;
+
+    virtual void DoMicroStep(double time, const SimParamsSnapshot &params) override;
+
+    virtual void DoPoleUpdatingStep(double time, const SimParamsSnapshot &params) override;
 
-    virtual void DoMicroStep(double time) override;
+    virtual void DoSpringBreakingStep(double time, const SimParamsSnapshot &params) override;
 
-    virtual void DoPoleUpdatingStep(double time) override;
+    // Each cell runs all steps of the batch at once, cells don't wait for each other
+    virtual void DoIterationBatch(const StepParams &params, const std::vector<IterationPlan> &plans) override;
 
-    virtual void DoSpringBreakingStep(double time) override;
+    virtual void RetireCells(double time, const SimParamsSnapshot &params) override;
+
+    virtual std::unique_ptr<CellWithRng> DetachCell(size_t cell) override;
 
     virtual const CellEnsemble &SynchronizeCells() override;
 
     virtual void FormatStats(std::vector<CellStats> &stats) override;
 
-    int NumThreads() const { return std::max(1, std::min((int)_cells.size(), _omp_num_threads)); }
+    int NumThreads() const { return std::max(1, std::min((int)_active.size(), _omp_num_threads)); }
+
+    // Collects the cells that aren't retired, all steps distribute only them between threads
+    void UpdateActiveCells();
+
+    // Writes lazily updated lengths of free MTs to the cells
+    void MaterializeFreeMTs();
+
+    // Creates or drops schedules of free MTs according to the engine, returns true for the event-driven one
+    bool PrepareFreeMTs(const SimParamsSnapshot &params);
+
+    // Step of the batch for a single cell
+    struct Phase
+    {
+      enum Type { PoleUpdating, Macro, Micro, SpringBreaking };
+
+      Type type;
+      double time;
+      const SimParamsSnapshot *params;
+      double end;     // end of the iteration, the cell is checked for retirement after its spring breaking phase
+    };
+
+    // Returns false, if the cell is retired by this phase and must skip the rest of the batch
+    bool DoPhase(size_t cell, const Phase &phase, bool eventDriven);
 
     int _omp_num_threads;
-    CellEnsemble _cells;
+    Mode _mode;
+    bool _deterministic;
+    bool _pinThreads, _firstTouch;
+    CellEnsemble _cells;                                         // entries of the released cells are empty
+    std::vector<int> _active;                                    // indices of the cells that aren't retired
+    std::vector<std::unique_ptr<FreeMTSchedule> > _schedules;   // one per cell, only for the event-driven engine
+    std::vector<double> _costs;                                  // time of the last batch per cell, only for tasks
     std::unique_ptr<IPoleUpdater> _updater;
 };
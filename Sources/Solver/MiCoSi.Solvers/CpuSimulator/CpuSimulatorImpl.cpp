@@ -3,6 +3,12 @@
 #include "MiCoSi.Core/All.h"
 #include "MiCoSi.Objects/All.h"
 #include "MiCoSi.Geometry/Geometry.h"
+#include "MiCoSi.Geometry/CapsuleGrid.h"
+#include "MiCoSi.Geometry/BatchGeometry.h"
+#include "MiCoSi.Geometry/BatchLinearSolver.h"
+#include "FreeMTSchedule.h"
+
+#include <omp.h>
 
 //--------------------
 //--- CpuSimulator ---
@@ -18,600 +24,1200 @@ static inline double GetStandardNormal(Random::State &state, int n = 12)
   return sum;
 }
 
-void CpuSimulator::DoMacroStep(Cell &cell, Random::State &state)
+namespace
+{
+
+// Flags of the macro step, each combination has its own specialization of 'MacroStepKernel()'
+const int MACRO_MT_WRAPPING       = 1;
+const int MACRO_MOVING_SPRING     = 2;
+const int MACRO_MOVE_NON_BROKEN   = 4;
+const int MACRO_SPRINGS_BROKEN    = 8;
+const int MACRO_FLAG_COMBINATIONS = 16;
+
+template <int FLAGS>
+void MacroStepKernel(Cell &cell, Random::State &state, const SimParamsSnapshot &params)
 {
-  real r_cell          = (real)GlobalSimParams::GetRef()->GetParameter(SimParameter::Double::R_Cell, true);
-  real dt              = (real)GlobalSimParams::GetRef()->GetParameter(SimParameter::Double::Dt, true);
-  real A               = (real)GlobalSimParams::GetRef()->GetParameter(SimParameter::Double::Const_A, true);
-  real b               = (real)GlobalSimParams::GetRef()->GetParameter(SimParameter::Double::Const_B, true);
-  real Dtrans          = (real)GlobalSimParams::GetRef()->GetParameter(SimParameter::Double::D_Trans, true);
-  real Drot            = (real)GlobalSimParams::GetRef()->GetParameter(SimParameter::Double::D_Rot, true);
-  real gamma           = (real)GlobalSimParams::GetRef()->GetParameter(SimParameter::Double::Gamma, true);
-  real ieta            = (real)GlobalSimParams::GetRef()->GetParameter(SimParameter::Double::Ieta, true);
-  real cr_spring_l     = (real)GlobalSimParams::GetRef()->GetParameter(SimParameter::Double::Spring_Length, true);
-  real cr_kin_r        = (real)GlobalSimParams::GetRef()->GetParameter(SimParameter::Double::Cr_Kin_D, true) / 2;
-  real cr_kin_l        = (real)GlobalSimParams::GetRef()->GetParameter(SimParameter::Double::Cr_Kin_L, true);
-  real v_pol           = (real)GlobalSimParams::GetRef()->GetParameter(SimParameter::Double::V_Pol, true);
-  real v_dep           = (real)GlobalSimParams::GetRef()->GetParameter(SimParameter::Double::V_Dep, true);
-  bool moving_spring   = GlobalSimParams::GetRef()->GetParameter(SimParameter::Int::Spring_Type) == 1;
-  bool move_non_broken = !GlobalSimParams::GetRef()->GetParameter(SimParameter::Int::Frozen_Coords);
-  bool mt_wrapping     = GlobalSimParams::GetRef()->GetParameter(SimParameter::Int::MT_Wrapping) != 0;
-  real cr_spring_k     = (real)GlobalSimParams::GetRef()->GetParameter(SimParameter::Double::Spring_K, true);
-
-  CellOps cellOps(&cell);
-  auto kmts = cellOps.ExtractKMTs();
-  
+  real r_cell          = params[SimParameter::Double::R_Cell];
+  real dt              = params[SimParameter::Double::Dt];
+  real A               = params[SimParameter::Double::Const_A];
+  real b               = params[SimParameter::Double::Const_B];
+  real Dtrans          = params[SimParameter::Double::D_Trans];
+  real Drot            = params[SimParameter::Double::D_Rot];
+  real gamma           = params[SimParameter::Double::Gamma];
+  real ieta            = params[SimParameter::Double::Ieta];
+  real cr_spring_l     = params[SimParameter::Double::Spring_Length];
+  real cr_kin_r        = params[SimParameter::Double::Cr_Kin_D] / 2;
+  real cr_kin_l        = params[SimParameter::Double::Cr_Kin_L];
+  real cr_spring_k     = params[SimParameter::Double::Spring_K];
+  bool box_muller      = params[SimParameter::Int::Normal_Sampler] != 0;
+
+  // Known at compile time, the unused branches are removed
+  const bool mt_wrapping     = (FLAGS & MACRO_MT_WRAPPING) != 0;
+  const bool moving_spring   = (FLAGS & MACRO_MOVING_SPRING) != 0;
+  const bool move_non_broken = (FLAGS & MACRO_MOVE_NON_BROKEN) != 0;
+  const bool springs_broken  = (FLAGS & MACRO_SPRINGS_BROKEN) != 0;
+
   Geometry geom(r_cell * (real)1e-5f);
   const std::vector<Chromosome *> &chrs = cell.Chromosomes();
-  for (int cri = 0; cri < chrs.size(); cri += (1 + !cell.AreSpringsBroken()))
-  {
-    Chromosome *crs[2];
-    crs[0] = chrs[cri];
-    crs[1] = chrs[cri ^ 1];
-    vec3r V = vec3r::ZERO;
-    vec3r w = vec3r::ZERO;
-    real mat[6][7]; //Vx, Wx, Vy, Wy, Vz, Wz
-    // Filling extended matrix
-    for (int i = 0; i < 6; i++)
-      for (int j = 0; j < 7; j++)
-        mat[i][j] = 0;
-    for (int i = 0; i < 3; i++)
-    {
-      mat[2 * i][2 * i] = -gamma;
-      mat[2 * i + 1][2 * i + 1] = -ieta;
-    }
-    bool move_flag;
-    if (cell.AreSpringsBroken())
-    { move_flag = !kmts[crs[0]->ID()].empty(); }
-    else
-    { move_flag = move_non_broken && (!kmts[crs[0]->ID()].empty() || !kmts[crs[1]->ID()].empty()); }
 
-    for (int pairI = 0; pairI < 1 + !cell.AreSpringsBroken(); pairI++)
+  // Pairs don't share chromosomes and bound MTs, so their systems are assembled and solved together
+  // The rest (springs, Langevin's members) is applied in the original order of pairs
+  BatchLinearSolver::Systems systems;
+  const int WIDTH = BatchLinearSolver::WIDTH;
+  const int pairStep = 1 + !springs_broken;
+  const int pairCount = (int)chrs.size() / pairStep;
+  for (int firstPair = 0; firstPair < pairCount; firstPair += WIDTH)
+  {
+    const int lanes = std::min(WIDTH, pairCount - firstPair);
+    systems.Clear();
+    for (int lane = 0; lane < lanes; lane++)
     {
-      Chromosome *cr = crs[pairI];
-      const auto &boundMTs = kmts[cr->ID()];
-      for (auto it = boundMTs.begin(); it != boundMTs.end(); it++)
+      const int cri = (firstPair + lane) * pairStep;
+      Chromosome *crs[2];
+      crs[0] = chrs[cri];
+      crs[1] = chrs[cri ^ 1];
+      real mat[6][7]; //Vx, Wx, Vy, Wy, Vz, Wz
+      // Filling extended matrix
+      for (int i = 0; i < 6; i++)
+        for (int j = 0; j < 7; j++)
+          mat[i][j] = 0;
+      for (int i = 0; i < 3; i++)
       {
-        MT *mt = *it;
-        real len = mt->Length();
-
-        // The following condition should be replaced by another condition - this one is wrong.
-        // if (len > cr_kin_r * 2 && len > cr_kin_l * 2)
+        mat[2 * i][2 * i] = -gamma;
+        mat[2 * i + 1][2 * i + 1] = -ieta;
+      }
+      for (int pairI = 0; pairI < 1 + !springs_broken; pairI++)
+      {
+        Chromosome *cr = crs[pairI];
+        const KMTList boundMTs = cr->KMTs();
+        for (auto it = boundMTs.begin(); it != boundMTs.end(); it++)
         {
-          // Calculating and applying force point.
-          if (mt_wrapping)
+          MT *mt = *it;
+
+          // The following condition should be replaced by another condition - this one is wrong.
+          // if (mt->Length() > cr_kin_r * 2 && mt->Length() > cr_kin_l * 2)
           {
-            vec3r force_point;
-            real refScale = r_cell;
-            vec3r mt_end = mt->EndPoint();
-            vec3r pole = mt->GetPole()->Position();
+            // Calculating and applying force point.
+            if (mt_wrapping)
+            {
+              vec3r force_point;
+              vec3r mt_end = mt->EndPoint();
+              vec3r pole = mt->GetPole()->Position();
             
-            vec3r chr_pos = (vec3r)cr->Position();
-            mat3x3r orient = (mat3x3r)cr->Orientation();
-            vec3r ortZ = (orient * vec3r((real)0.0, (real)1.0, (real)0.0)).Normalize();    // need to normalize due to
-                                                    // single precision!
+              vec3r chr_pos = (vec3r)cr->Position();
+              mat3x3r orient = (mat3x3r)cr->Orientation();
+              vec3r ortZ = (orient * vec3r((real)0.0, (real)1.0, (real)0.0)).Normalize();    // need to normalize due to
+                                                      // single precision!
             
-            // Projecting.
-            vec3r mt_end_proj = mt_end + ortZ * DotProduct(ortZ, chr_pos - mt_end);
-            vec3r pole_proj   = pole + ortZ * DotProduct(ortZ, chr_pos - pole);
-
-            // Intersection check.
-            if (geom.Distance(chr_pos, Geometry::Segment(mt_end_proj, pole_proj)) > cr_kin_r * (real)0.99)
-            {
-              force_point = mt->EndPoint();
-            }
-            else
-            {
-              vec3r p1, p2;
-
-              // Getting vectors for new coordinate system.
-              vec3r r1 = orient * vec3r((real)0.0, (real)0.0, -(real)cr_kin_r);
-              vec3r r2 = orient * vec3r((real)cr_kin_r, (real)0.0, (real)0.0);
+              // Projecting.
+              vec3r mt_end_proj = mt_end + ortZ * DotProduct(ortZ, chr_pos - mt_end);
+              vec3r pole_proj   = pole + ortZ * DotProduct(ortZ, chr_pos - pole);
 
-              // No tangent points, pole located inside sphere.
-              if ((pole_proj - chr_pos).GetLength() < cr_kin_r * (real)1.01)
+              // Intersection check.
+              if (geom.Distance(chr_pos, Geometry::Segment(mt_end_proj, pole_proj)) > cr_kin_r * (real)0.99)
               {
-                p1 = chr_pos + r1;
-                p2 = chr_pos - r1;
+                force_point = mt->EndPoint();
               }
-              // Have tangent points.
               else
               {
-                // Computing tangent points.
-                vec3r c = chr_pos - pole_proj;
-                double cl = c.GetLength();
-                double bl = cr_kin_r * cl / std::sqrt(cl * cl - cr_kin_r * cr_kin_r);
-                vec3r b = CrossProduct(c.Normalize(), ortZ) * bl;
-                vec3r nd1 = (c + b).Normalize(), nd2 = (c - b).Normalize();
-                p1 = nd1 * DotProduct(nd1, c) + pole_proj;
-                p2 = nd2 * DotProduct(nd2, c) + pole_proj;
-
-                // Rounding tangent points.
-                if (DotProduct(p1 - chr_pos, r2) < 0)
-                  p1 = chr_pos + (DotProduct(pole_proj - chr_pos, r2) > 0 ? r1 : -r1);
-
-                if (DotProduct(p2 - chr_pos, r2) < 0)
-                  p2 = chr_pos + (DotProduct(pole_proj - chr_pos, r2) > 0 ? -r1 : r1);
-              }
+                vec3r p1, p2;
 
-              // Selecting the closed variant.
-              double dist1 = geom.ArcLength(chr_pos, cr_kin_r, mt_end_proj, p1);
-              dist1 = std::min(dist1, (real)PI * cr_kin_r - dist1 + 2 * cr_kin_r);
-              dist1 = (p1 - pole_proj).GetLength() + dist1;
-              double dist2 = geom.ArcLength(chr_pos, cr_kin_r, mt_end_proj, p2);
-              dist2 = std::min(dist2, (real)PI * cr_kin_r - dist2 + 2 * cr_kin_r);
-              dist2 = (p2 - pole_proj).GetLength() + dist2;
-              force_point = dist1 < dist2 ? p1 : p2;
-
-              // Preparing multiplier for height detection.
-              vec3r my_ort = (mt_end_proj - pole_proj);      // We will project force_point onto my_ort X ortZ plane
-              real pole_mt_x = my_ort.GetLength();
-              my_ort = my_ort / pole_mt_x;
-              real y_mult = pole_mt_x;
-              real height_eps = cr_kin_l * (real)1e-3;
-              if (std::abs(y_mult) < height_eps ) y_mult = (y_mult >= 0 ? height_eps : -height_eps);
-              y_mult = DotProduct(mt_end - pole, ortZ) / y_mult;
-
-              // Constructing non-projected force point.
-              real height = DotProduct(mt_end_proj - force_point, my_ort);      // first part, getting height without
-                                                // scale multiplier and direction
+                // Getting vectors for new coordinate system.
+                vec3r r1 = orient * vec3r((real)0.0, (real)0.0, -(real)cr_kin_r);
+                vec3r r2 = orient * vec3r((real)cr_kin_r, (real)0.0, (real)0.0);
+
+                // No tangent points, pole located inside sphere.
+                if ((pole_proj - chr_pos).GetLength() < cr_kin_r * (real)1.01)
+                {
+                  p1 = chr_pos + r1;
+                  p2 = chr_pos - r1;
+                }
+                // Have tangent points.
+                else
+                {
+                  // Computing tangent points.
+                  vec3r c = chr_pos - pole_proj;
+                  double cl = c.GetLength();
+                  double bl = cr_kin_r * cl / std::sqrt(cl * cl - cr_kin_r * cr_kin_r);
+                  vec3r b = CrossProduct(c.Normalize(), ortZ) * bl;
+                  vec3r nd1 = (c + b).Normalize(), nd2 = (c - b).Normalize();
+                  p1 = nd1 * DotProduct(nd1, c) + pole_proj;
+                  p2 = nd2 * DotProduct(nd2, c) + pole_proj;
+
+                  // Rounding tangent points.
+                  if (DotProduct(p1 - chr_pos, r2) < 0)
+                    p1 = chr_pos + (DotProduct(pole_proj - chr_pos, r2) > 0 ? r1 : -r1);
+
+                  if (DotProduct(p2 - chr_pos, r2) < 0)
+                    p2 = chr_pos + (DotProduct(pole_proj - chr_pos, r2) > 0 ? -r1 : r1);
+                }
+
+                // Selecting the closed variant.
+                double dist1 = geom.ArcLength(chr_pos, cr_kin_r, mt_end_proj, p1);
+                dist1 = std::min(dist1, (real)PI * cr_kin_r - dist1 + 2 * cr_kin_r);
+                dist1 = (p1 - pole_proj).GetLength() + dist1;
+                double dist2 = geom.ArcLength(chr_pos, cr_kin_r, mt_end_proj, p2);
+                dist2 = std::min(dist2, (real)PI * cr_kin_r - dist2 + 2 * cr_kin_r);
+                dist2 = (p2 - pole_proj).GetLength() + dist2;
+                force_point = dist1 < dist2 ? p1 : p2;
+
+                // Preparing multiplier for height detection.
+                vec3r my_ort = (mt_end_proj - pole_proj);      // We will project force_point onto my_ort X ortZ plane
+                real pole_mt_x = my_ort.GetLength();
+                my_ort = my_ort / pole_mt_x;
+                real y_mult = pole_mt_x;
+                real height_eps = cr_kin_l * (real)1e-3;
+                if (std::abs(y_mult) < height_eps ) y_mult = (y_mult >= 0 ? height_eps : -height_eps);
+                y_mult = DotProduct(mt_end - pole, ortZ) / y_mult;
+
+                // Constructing non-projected force point.
+                real height = DotProduct(mt_end_proj - force_point, my_ort);      // first part, getting height without
+                                                  // scale multiplier and direction
               
-              height *= pole_mt_x * height > 0.0 ? -y_mult : y_mult;        // adding multiplier with direction.
-                                                // It depends on [mt_end, pole].x
-                                                // and [mt_end, force_point].x segments
+                height *= pole_mt_x * height > 0.0 ? -y_mult : y_mult;        // adding multiplier with direction.
+                                                  // It depends on [mt_end, pole].x
+                                                  // and [mt_end, force_point].x segments
 
-              height += DotProduct(mt_end - chr_pos, ortZ);            // shifting projected plane up/down
+                height += DotProduct(mt_end - chr_pos, ortZ);            // shifting projected plane up/down
               
-              height = std::min(std::max(height, - cr_kin_l / 2), cr_kin_l / 2);  // and finally rounding
-              force_point += ortZ * height;
+                height = std::min(std::max(height, - cr_kin_l / 2), cr_kin_l / 2);  // and finally rounding
+                force_point += ortZ * height;
+              }
+              mt->ForceOffset() = force_point - mt->EndPoint();
             }
-            mt->ForceOffset() = force_point - mt->EndPoint();
-          }
-          else
-            mt->ForceOffset() = vec3r::ZERO;
+            else
+              mt->ForceOffset() = vec3r::ZERO;
 
-          // Updating matrix.
-          vec3r beg = mt->GetPole()->Position();
-          vec3r end = mt->ForcePoint();
-          vec3r r = end - cr->Position();
-          vec3r R = (beg - end).Normalize();
-          vec3r rR = CrossProduct(r, R);
+            // Updating matrix.
+            vec3r beg = mt->GetPole()->Position();
+            vec3r end = mt->ForcePoint();
+            vec3r r = end - cr->Position();
+            vec3r R = (beg - end).Normalize();
+            vec3r rR = CrossProduct(r, R);
 
-          for (int i = 0; i < 3; i++)
-          {
-            for (int j = 0; j < 3; j++)
+            for (int i = 0; i < 3; i++)
             {
-              mat[2 * i][2 * j] -= R[i] * R[j] * b;
-              mat[2 * i][2 * j + 1] -= R[i] * rR[j] * b;
-            }
-            mat[2 * i][6] -= R[i] * A;
-            for (int j = 0; j < 3; j++)
-            {
-              mat[2 * i + 1][2 * j] -= rR[i] * R[j] * b;
-              mat[2 * i + 1][2 * j + 1] -= rR[i] * rR[j] * b;
+              for (int j = 0; j < 3; j++)
+              {
+                mat[2 * i][2 * j] -= R[i] * R[j] * b;
+                mat[2 * i][2 * j + 1] -= R[i] * rR[j] * b;
+              }
+              mat[2 * i][6] -= R[i] * A;
+              for (int j = 0; j < 3; j++)
+              {
+                mat[2 * i + 1][2 * j] -= rR[i] * R[j] * b;
+                mat[2 * i + 1][2 * j + 1] -= rR[i] * rR[j] * b;
+              }
+              mat[2 * i + 1][6] -= rR[i] * A;
             }
-            mat[2 * i + 1][6] -= rR[i] * A;
           }
         }
       }
+      systems.Set(lane, mat);
     }
-    bool badFlag = false;
+    const uint32_t solved = BatchLinearSolver::Solve(systems);
 
-    // Normalizing matrix
-    for (int i = 0; !badFlag && i < 6; i++)
+    for (int lane = 0; lane < lanes; lane++)
     {
-      real maxVal = 0;
-      for (int j = 0; j < 6; j++)
-        if (fabs(mat[i][j]) > maxVal)
-          maxVal = fabs(mat[i][j]);
-      if (maxVal > 0)
-      {
-        for (int j = 0; j < 7; j++)
-          mat[i][j] /= maxVal;
-      }
+      const int cri = (firstPair + lane) * pairStep;
+      Chromosome *crs[2];
+      crs[0] = chrs[cri];
+      crs[1] = chrs[cri ^ 1];
+      vec3r V = vec3r::ZERO;
+      vec3r w = vec3r::ZERO;
+      bool move_flag;
+      if (springs_broken)
+      { move_flag = !crs[0]->KMTs().empty(); }
       else
-      {
-        badFlag = true;
-      }
-    }
+      { move_flag = move_non_broken && (!crs[0]->KMTs().empty() || !crs[1]->KMTs().empty()); }
 
-    // Solve using method of rotations
-    // Move forward
-    for (int line = 0; !badFlag && line < 5; line++)
-    {
-      int maxLine = line;
-      real maxVal = fabs(mat[line][line]);
-      for (int i = line + 1; i < 6; i++)
-        if (fabs(mat[i][line]) > maxVal)
-        {
-          maxVal = fabs(mat[i][line]);
-          maxLine = i;
-        }
-      if (maxVal > 0)
+      bool badFlag = ((solved >> lane) & 1) == 0;
+
+      // The same - wrong stabilizer, must to be replaced.
+      // if (!badFlag)
+      // {
+      //   if (v_pol > 0 || v_dep > 0)
+      //     if (vec3r(systems.Answer(lane, 0), systems.Answer(lane, 2), systems.Answer(lane, 4)).GetLength() > std::max(v_pol, v_dep) * 10)
+      //       badFlag = true;
+      //   if (vec3r(systems.Answer(lane, 1), systems.Answer(lane, 3), systems.Answer(lane, 5)).GetLength() > 1)
+      //     badFlag = true;
+      // }
+      if (!badFlag)
       {
-        if (maxLine != line)
-          for (int j = 0; j < 7; j++)
-          {
-            real tmp = mat[line][j];
-            mat[line][j] = mat[maxLine][j];
-            mat[maxLine][j] = tmp;
-          }
-        for (int i = line + 1; i < 6; i++)
+        // Now matrices are identity and the answers are in the last column
+        w = vec3r(systems.Answer(lane, 1), systems.Answer(lane, 3), systems.Answer(lane, 5));
+
+        if (move_flag)
         {
-          real denom = sqrt(mat[line][line] * mat[line][line] + mat[i][line] * mat[i][line]);
-          real c = mat[line][line] / denom;
-          real s = mat[i][line] / denom;
-          for (int j = line; j < 7; j++)
+          V = vec3r(systems.Answer(lane, 0), systems.Answer(lane, 2), systems.Answer(lane, 4));
+          if (!springs_broken)
           {
-            real fir = mat[line][j];
-            real sec = mat[i][j];
-            mat[line][j] = c * fir + s * sec;
-            mat[i][j] = - s * fir + c * sec;
+            // Need to project velocity on the plane orthogonal to Pole-Pole line. And poles can be located in the same point!
+            vec3r dir = (vec3r)cell.GetPole(PoleType::Left)->Position() - (vec3r)cell.GetPole(PoleType::Right)->Position();
+            real dir_len = dir.GetLength();
+            V = dir_len > r_cell * 1e-5 ? (vec3r)(V - dir * DotProduct(V, dir / dir_len) / dir_len) : vec3r::ZERO;
+
           }
         }
       }
-      else
-      {
-        badFlag = true;
-      }
-    }
-    // Move back
-    for (int line = 5; !badFlag && line >= 0; line--)
-    {
-      if (fabs(mat[line][line]) > 0)
-      {
-        mat[line][6] /= mat[line][line];
-        mat[line][line] = 1;
-        for (int i = 0; i < line; i++)
-        {
-          mat[i][6] -= mat[line][6] * mat[i][line];
-          mat[i][line] = 0;
-        }
-      }
-      else
-      {
-        badFlag = true;
-      }
-    }
-    // The same - wrong stabilizer, must to be replaced.
-    // if (!badFlag)
-    // {
-    //   if (v_pol > 0 || v_dep > 0)
-    //     if (vec3r(mat[0][6], mat[2][6], mat[4][6]).GetLength() > std::max(v_pol, v_dep) * 10)
-    //       badFlag = true;
-    //   if (vec3r(mat[1][6], mat[3][6], mat[5][6]).GetLength() > 1)
-    //     badFlag = true;
-    // }
-    if (!badFlag)
-    {
-      // Now matrix is identity and the answer is in mat[*][6]
-      w = vec3r(mat[1][6], mat[3][6], mat[5][6]);
-
-      if (move_flag)
+      if (!springs_broken)
       {
-        V = vec3r(mat[0][6], mat[2][6], mat[4][6]);
-        if (!cell.AreSpringsBroken())
+        // Need to update spring length
+        vec3r center = ((vec3r)crs[0]->Position() + (vec3r)crs[1]->Position()) / (real)2.0;
+        real prevLen = ((vec3r)crs[0]->Position() - (vec3r)crs[1]->Position()).GetLength();
+        real newLen = cr_spring_l;
+        if (moving_spring)
         {
-          // Need to project velocity on the plane orthogonal to Pole-Pole line. And poles can be located in the same point!
-          vec3r dir = (vec3r)cell.GetPole(PoleType::Left)->Position() - (vec3r)cell.GetPole(PoleType::Right)->Position();
-          real dir_len = dir.GetLength();
-          V = dir_len > r_cell * 1e-5 ? (vec3r)(V - dir * DotProduct(V, dir / dir_len) / dir_len) : vec3r::ZERO;
-
+          real totalForce = 0;
+          for (int i = 0; i < 2; i++)
+          {
+            Chromosome *cr = crs[i];
+            mat3x3r chrOrient = (mat3x3r)cr->Orientation();
+            const KMTList boundMTs = cr->KMTs();
+            for (auto it = boundMTs.begin(); it != boundMTs.end(); it++)
+            {
+              MT *mt = *it;
+              vec3r beg = mt->GetPole()->Position();
+              vec3r end = beg + (vec3r)mt->Direction() * mt->Length();
+              vec3r r = end - cr->Position();
+              vec3r R = (beg - end).Normalize();
+              vec3r crAxis = (chrOrient * vec3r(0.0, 1.0, 0.0)).Normalize();
+              vec3r endPrj = (vec3r)cr->Position() + crAxis * DotProduct(r, crAxis);
+              vec3r normAxis = (endPrj - end).Normalize();
+              vec3r k = vec3r::ZERO;
+              if (DotProduct(R, normAxis) <= 0)
+                k = R;
+              else
+              {
+                k = R - normAxis * DotProduct(R, normAxis);
+                if (k.GetLength() > 1e-8)
+                  k = k.Normalize();
+                else
+                  k = vec3r::ZERO;
+              }
+              vec3r springAxis = (chrOrient * vec3r(1.0, 0.0, 0.0)).Normalize();
+              real ourForce = DotProduct(k * A, springAxis);
+              totalForce += ourForce;
+            }
+          }
+          if (totalForce < 0)
+            newLen = 0;
+          else
+            newLen = cr_spring_l + (totalForce / 2) / cr_spring_k;
         }
-      }
-    }
-    if (!cell.AreSpringsBroken())
-    {
-      // Need to update spring length
-      vec3r center = ((vec3r)crs[0]->Position() + (vec3r)crs[1]->Position()) / (real)2.0;
-      real prevLen = ((vec3r)crs[0]->Position() - (vec3r)crs[1]->Position()).GetLength();
-      real newLen = cr_spring_l;
-      if (moving_spring)
-      {
-        real totalForce = 0;
         for (int i = 0; i < 2; i++)
         {
           Chromosome *cr = crs[i];
-          mat3x3r chrOrient = (mat3x3r)cr->Orientation();
-          const auto &boundMTs = kmts[cr->ID()];
+          vec3r springAxis = ((mat3x3r)cr->Orientation() * vec3r(1.0, 0.0, 0.0)).Normalize();
+          cr->Position() = center + springAxis * (newLen / 2);
+          const KMTList boundMTs = cr->KMTs();
           for (auto it = boundMTs.begin(); it != boundMTs.end(); it++)
           {
             MT *mt = *it;
             vec3r beg = mt->GetPole()->Position();
             vec3r end = beg + (vec3r)mt->Direction() * mt->Length();
-            vec3r r = end - cr->Position();
-            vec3r R = (beg - end).Normalize();
-            vec3r crAxis = (chrOrient * vec3r(0.0, 1.0, 0.0)).Normalize();
-            vec3r endPrj = (vec3r)cr->Position() + crAxis * DotProduct(r, crAxis);
-            vec3r normAxis = (endPrj - end).Normalize();
-            vec3r k = vec3r::ZERO;
-            if (DotProduct(R, normAxis) <= 0)
-              k = R;
-            else
-            {
-              k = R - normAxis * DotProduct(R, normAxis);
-              if (k.GetLength() > 1e-8)
-                k = k.Normalize();
-              else
-                k = vec3r::ZERO;
-            }
-            vec3r springAxis = (chrOrient * vec3r(1.0, 0.0, 0.0)).Normalize();
-            real ourForce = DotProduct(k * A, springAxis);
-            totalForce += ourForce;
+            end -= springAxis * (prevLen / 2);
+            end += springAxis * (newLen / 2);
+            mt->Direction() = (end - beg).Normalize();
+            mt->Length() = (end - beg).GetLength();
           }
         }
-        if (totalForce < 0)
-          newLen = 0;
-        else
-          newLen = cr_spring_l + (totalForce / 2) / cr_spring_k;
       }
-      for (int i = 0; i < 2; i++)
+      // Langevin's members
+      real rnd[6];
+      if (box_muller)
+      { Random::NextNormals(state, rnd, 6); }
+      else
+      {
+        for (int i = 0; i < 6; i++)
+        { rnd[i] = (real)GetStandardNormal(state); }
+      }
+      vec3r transAdd = vec3r(rnd[0] * sqrt(2 * Dtrans * dt), rnd[1] * sqrt(2 * Dtrans * dt), rnd[2] * sqrt(2 * Dtrans * dt));
+      vec3r rotateAdd = vec3r(real(rnd[3] * sqrt(2 * Drot * dt)), rnd[4] * sqrt(2 * Drot * dt), rnd[5] * sqrt(2 * Drot * dt));
+    
+      // Applying velocities and Langevin's members
+      vec3r trans = V * dt + transAdd;
+      mat3x3r rotate = MatrixRotationXYZ<real>(w[0] * dt + rotateAdd[0], w[1] * dt + rotateAdd[1], w[2] * dt + rotateAdd[2]);
+
+      //Updating chromosome states.
+      vec3r rotatePoint = ((vec3r)crs[0]->Position() + (vec3r)crs[1]->Position()) / 2;
+      for (int i = 0; i < 1 + !springs_broken; i++)
       {
         Chromosome *cr = crs[i];
-        vec3r springAxis = ((mat3x3r)cr->Orientation() * vec3r(1.0, 0.0, 0.0)).Normalize();
-        cr->Position() = center + springAxis * (newLen / 2);
-        const auto &boundMTs = kmts[cr->ID()];
+
+        // Setting chromosome's position and orientation.
+        vec3r prevPos = (vec3r)cr->Position();
+        if (springs_broken)
+        {
+          rotatePoint = (vec3r)cr->Position();
+        }
+
+        cr->Position() = rotatePoint + (rotate * (prevPos - rotatePoint) + trans);
+        mat3x3r orient = rotate * cr->Orientation();
+        cr->Orientation() = orient;
+
+        // Updating bound MTs
+        vec3r ort = (orient * vec3r((real)0.0, (real)1.0, (real)0.0)).Normalize();
+        vec3r springOffset = (vec3r)cr->Position() - (rotatePoint + trans);
+        const KMTList boundMTs = cr->KMTs();
         for (auto it = boundMTs.begin(); it != boundMTs.end(); it++)
         {
           MT *mt = *it;
+
+          // Getting direction from chromosome's center to MT's end, updating it.
           vec3r beg = mt->GetPole()->Position();
           vec3r end = beg + (vec3r)mt->Direction() * mt->Length();
-          end -= springAxis * (prevLen / 2);
-          end += springAxis * (newLen / 2);
+          vec3r r = end - rotatePoint;
+          r = rotate * r;
+        
+          // Fighting with float-based errors.
+          real height = DotProduct(r, ort);
+          r = (r - springOffset - ort * height).Normalize() * cr_kin_r;
+          r = r + springOffset + ort * std::max(-cr_kin_l / 2, std::min(cr_kin_l / 2, height));
+
+          // Applying new MT's end point. Force point is the same due to small dt values and future recalculating.
+          end = rotatePoint + r + trans;
           mt->Direction() = (end - beg).Normalize();
           mt->Length() = (end - beg).GetLength();
         }
       }
     }
-    // Langevin's members
-    real rnd1 = (real)GetStandardNormal(state);
-    real rnd2 = (real)GetStandardNormal(state);
-    real rnd3 = (real)GetStandardNormal(state);
-    vec3r transAdd = vec3r(rnd1 * sqrt(2 * Dtrans * dt), rnd2 * sqrt(2 * Dtrans * dt), rnd3 * sqrt(2 * Dtrans * dt));
-    rnd1 = (real)GetStandardNormal(state);
-    rnd2 = (real)GetStandardNormal(state);
-    rnd3 = (real)GetStandardNormal(state);
-    vec3r rotateAdd = vec3r(real(rnd1 * sqrt(2 * Drot * dt)), rnd2 * sqrt(2 * Drot * dt), rnd3 * sqrt(2 * Drot * dt));
-    
-    // Applying velocities and Langevin's members
-    vec3r trans = V * dt + transAdd;
-    mat3x3r rotate = MatrixRotationXYZ<real>(w[0] * dt + rotateAdd[0], w[1] * dt + rotateAdd[1], w[2] * dt + rotateAdd[2]);
+  }
+}
+
+typedef void (*MacroStepKernelPtr)(Cell &cell, Random::State &state, const SimParamsSnapshot &params);
+
+// Index is the combination of flags
+const MacroStepKernelPtr MACRO_STEP_KERNELS[MACRO_FLAG_COMBINATIONS] =
+{
+  MacroStepKernel<0>,  MacroStepKernel<1>,  MacroStepKernel<2>,  MacroStepKernel<3>,
+  MacroStepKernel<4>,  MacroStepKernel<5>,  MacroStepKernel<6>,  MacroStepKernel<7>,
+  MacroStepKernel<8>,  MacroStepKernel<9>,  MacroStepKernel<10>, MacroStepKernel<11>,
+  MacroStepKernel<12>, MacroStepKernel<13>, MacroStepKernel<14>, MacroStepKernel<15>
+};
+
+} // unnamed namespace
+
+void CpuSimulator::DoMacroStep(Cell &cell, Random::State &state, const SimParamsSnapshot &params)
+{
+  // Flags don't change during the step, so the specialized kernel is selected once
+  int flags = 0;
+  if (params[SimParameter::Int::MT_Wrapping] != 0)
+    flags |= MACRO_MT_WRAPPING;
+  if (params[SimParameter::Int::Spring_Type] == 1)
+    flags |= MACRO_MOVING_SPRING;
+  if (!params[SimParameter::Int::Frozen_Coords])
+    flags |= MACRO_MOVE_NON_BROKEN;
+  if (cell.AreSpringsBroken())
+    flags |= MACRO_SPRINGS_BROKEN;
+  MACRO_STEP_KERNELS[flags](cell, state, params);
+
+  // Chromosomes were moved, so the cache is obsolete
+  UpdateChromosomeGeometry(cell, params);
+}
+
+void CpuSimulator::UpdateChromosomeGeometry(Cell &cell, const SimParamsSnapshot &params)
+{
+  real cr_l          = params[SimParameter::Double::Cr_L];
+  real cr_kin_l      = params[SimParameter::Double::Cr_Kin_L];
+  real cr_hand_r     = params[SimParameter::Double::Cr_Hand_D] / 2;
+  real cr_kin_r      = params[SimParameter::Double::Cr_Kin_D] / 2;
+
+  cell.GeometryCache().Update(cell.Chromosomes(), cr_l, cr_kin_l, cr_hand_r, cr_kin_r);
+}
+
+namespace
+{
+
+// Parameters of the micro step, taken from the snapshot
+struct MicroStepParams
+{
+  real r_cell, dt, v_pol, v_dep, f_cat, f_res;
+  real cr_hand_r, cr_kin_r, cr_kin_cosa, cr_l, cr_kin_l, cr_hand_l;
+  real k_on, k_off;
+  int n_kmt_max;
+
+  MicroStepParams(const SimParamsSnapshot &params)
+  {
+    r_cell        = params[SimParameter::Double::R_Cell];
+    dt            = params[SimParameter::Double::Dt];
+    v_pol         = params[SimParameter::Double::V_Pol];
+    v_dep         = params[SimParameter::Double::V_Dep];
+    f_cat         = params[SimParameter::Double::F_Cat];
+    f_res         = params[SimParameter::Double::F_Res];
+    cr_hand_r     = params[SimParameter::Double::Cr_Hand_D] / 2;
+    cr_kin_r      = params[SimParameter::Double::Cr_Kin_D] / 2;
+    cr_kin_cosa   = (real)std::cos(params.Exact(SimParameter::Double::Cr_Kin_Angle) / 2);
+    cr_l          = params[SimParameter::Double::Cr_L];
+    cr_kin_l      = params[SimParameter::Double::Cr_Kin_L];
+    k_on          = params[SimParameter::Double::K_On];
+    k_off         = params[SimParameter::Double::K_Off];
+    n_kmt_max     = params[SimParameter::Int::N_KMT_Max];
+    cr_hand_l     = (cr_l - cr_kin_l) / 2;
+  }
+};
+
+// Returns geometry of chromosomes, recomputes it if the macro step has not done it yet
+const ChromosomeGeometry &GetChromosomeGeometry(Cell &cell, const SimParamsSnapshot &params)
+{
+  ChromosomeGeometry &cg = cell.GeometryCache();
+  if (!cg.IsValid())
+  { CpuSimulator::UpdateChromosomeGeometry(cell, params); }
+  return cg;
+}
+
+// Puts bounding capsules of chromosomes (hands and kinetochore) to the grid
+// Capsule's index equals to the chromosome's index
+void BuildChromosomeGrid(const ChromosomeGeometry &cg, CapsuleGrid &grid)
+{
+  grid.Clear();
+  for (size_t j = 0; j < cg.Count(); j++)
+  {
+    grid.Add(cg.Get(ChromosomeGeometry::BOUND_BEG, j),
+             cg.Get(ChromosomeGeometry::BOUND_END, j),
+             cg.BoundRadius());
+  }
+  grid.Build();
+}
+
+// Direction of the new MT, it grows towards the opposite pole
+// Sign is 1 for MTs of the left pole and -1 for the right one
+template <class STATE>
+vec3r RandomDirection(int sign, STATE &state)
+{
+  double alpha = Random::NextReal(state) * PI * 2;
+  real dx = Random::NextReal(state) * sign;
+  real dy = (real)(std::sqrt(1.0 - dx * dx) * std::cos(alpha));
+  real dz = (real)(std::sqrt(1.0 - dx * dx) * std::sin(alpha));
+  return vec3r(dx, dy, dz);
+}
+
+template <class STATE>
+vec3r RandomDirection(const MT *mt, STATE &state)
+{
+  return RandomDirection(mt->GetPole()->Type() == PoleType::Left ? 1 : -1, state);
+}
 
-    //Updating chromosome states.
-    vec3r rotatePoint = ((vec3r)crs[0]->Position() + (vec3r)crs[1]->Position()) / 2;
-    for (int i = 0; i < 1 + !cell.AreSpringsBroken(); i++)
+// Updates the free MT: dynamic instability and collision with the cell's boundary
+// Returns the new segment of MT, it must be checked for collisions with chromosomes
+template <class STATE>
+void UpdateFreeMTDynamics(MT *mt, const MicroStepParams &p,
+                          vec3r &beg, vec3r &end,
+                          STATE &state)
+{
+  if (mt->State() == MTState::Polymerization)
+  {
+    mt->Length() += p.v_pol * p.dt;
+    if (Random::NextReal(state) < p.f_cat * p.dt)
     {
-      Chromosome *cr = crs[i];
-      Chromosome *pairedCr = crs[1 - i];
+      mt->State() = MTState::Depolymerization;
+    }
+  }
+  else
+  {
+    mt->Length() = std::max((real)0, mt->Length() - p.v_dep * p.dt);
+    if (mt->Length() == (real)0 || Random::NextReal(state) < p.f_res * p.dt)
+    {
+      mt->State() = MTState::Polymerization;
+      if (mt->Length() == (real)0)
+      {
+        mt->Direction() = RandomDirection(mt, state);
+      }
+    }
+  }
+
+  beg = mt->GetPole()->Position();
+  vec3r dir = (vec3r)mt->Direction();
+  real len = mt->Length();
+  end = beg + dir * len;
+  if (mt->State() == MTState::Polymerization)
+  {
+    // Check cell boundaries
+    if (end.GetLength() >= p.r_cell)
+    {
+      mt->State() = MTState::Depolymerization;
+    }
+  }
+}
+
+// Collisions of the free MT given as [beg, end] segment with chromosomes
+// Only chromosomes that are reported by the grid are checked, 'candidates' is a reusable buffer
+// Returns index of the chromosome that can capture MT by its kinetochore or -1
+// Touches only the given MT, so different MTs can be processed concurrently
+int CollideFreeMT(MT *mt, const vec3r &beg, const vec3r &end,
+                  const ChromosomeGeometry &cg,
+                  const MicroStepParams &p, const Geometry &geom,
+                  const CapsuleGrid &grid, std::vector<int> &candidates)
+{
+  // Candidates are sorted, so the results are the same as for the full enumeration
+  grid.Query(beg, end, candidates);
+
+  vec3r interPoint;
+  if(mt->State() == MTState::Polymerization)
+  {
+    // Intersect with hands or plain side
+    bool intersects = false;
+    bool pls = false;
+    for (size_t c = 0; c < candidates.size(); c++)
+    {
+      int j = candidates[c];
+      vec3r ortY = cg.Get(ChromosomeGeometry::ORT_Y, j);
+      vec3r ortZ = cg.Get(ChromosomeGeometry::ORT_Z, j);
+      vec3r plR1 = cg.Get(ChromosomeGeometry::HAND_R1, j);
+      vec3r plR2 = cg.Get(ChromosomeGeometry::HAND_R2, j);
+      // Hands
+      // Upper hand
+      Geometry::Segment seg(beg, end);
+      vec3r handBeg = cg.Get(ChromosomeGeometry::UPPER_HAND_BEG, j);
+      vec3r handEnd = cg.Get(ChromosomeGeometry::UPPER_HAND_END, j);
 
-      // Setting chromosome's position and orientation.
-      vec3r prevPos = (vec3r)cr->Position();
-      if (cell.AreSpringsBroken())
+      if (geom.AreIntersected(seg, Geometry::SemiTube(handBeg, handEnd, plR2), interPoint) ||
+          geom.AreIntersected(seg, Geometry::Rectangle(handBeg - plR1, plR1 * 2, handEnd - handBeg), interPoint) ||
+          geom.AreIntersected(seg, Geometry::SemiCircle(handBeg, plR1, plR2), interPoint) ||
+          geom.AreIntersected(seg, Geometry::SemiCircle(handEnd, plR1, plR2), interPoint))
       {
-        rotatePoint = (vec3r)cr->Position();
+        intersects = true;
+        break;
       }
 
-      cr->Position() = rotatePoint + (rotate * (prevPos - rotatePoint) + trans);
-      mat3x3r orient = rotate * cr->Orientation();
-      cr->Orientation() = orient;
+      // Lower hand
+      handBeg = cg.Get(ChromosomeGeometry::LOWER_HAND_BEG, j);
+      handEnd = cg.Get(ChromosomeGeometry::LOWER_HAND_END, j);
+      if (geom.AreIntersected(seg, Geometry::SemiTube(handBeg, handEnd, plR2), interPoint) ||
+          geom.AreIntersected(seg, Geometry::Rectangle(handBeg - plR1, plR1 * 2, handEnd - handBeg), interPoint) ||
+          geom.AreIntersected(seg, Geometry::SemiCircle(handBeg, plR1, plR2), interPoint) ||
+          geom.AreIntersected(seg, Geometry::SemiCircle(handEnd, plR1, plR2), interPoint))
+      {
+        intersects = true;
+        break;
+      }
 
-      // Updating bound MTs
-      vec3r ort = (orient * vec3r((real)0.0, (real)1.0, (real)0.0)).Normalize();
-      vec3r springOffset = (vec3r)cr->Position() - (rotatePoint + trans);
-      const auto &boundMTs = kmts[cr->ID()];
-      for (auto it = boundMTs.begin(); it != boundMTs.end(); it++)
+      // Kinetchore back plane.
+      if (geom.AreIntersected(seg,
+                              Geometry::Rectangle(handBeg - ortZ * p.cr_kin_r,
+                                                  ortZ * (2 * p.cr_kin_r),
+                                                  ortY * p.cr_kin_l),
+                              interPoint))
       {
-        MT *mt = *it;
+        intersects = true;
+        break;
+      }
+    }
 
-        // Getting direction from chromosome's center to MT's end, updating it.
-        vec3r beg = mt->GetPole()->Position();
-        vec3r end = beg + (vec3r)mt->Direction() * mt->Length();
-        vec3r r = end - rotatePoint;
-        r = rotate * r;
-        
-        // Fighting with float-based errors.
-        real height = DotProduct(r, ort);
-        r = (r - springOffset - ort * height).Normalize() * cr_kin_r;
-        r = r + springOffset + ort * std::max(-cr_kin_l / 2, std::min(cr_kin_l / 2, height));
-
-        // Applying new MT's end point. Force point is the same due to small dt values and future recalculating.
-        end = rotatePoint + r + trans;
-        mt->Direction() = (end - beg).Normalize();
-        mt->Length() = (end - beg).GetLength();
+    if (intersects)
+    {
+      mt->State() = MTState::Depolymerization;
+    }
+  }
+
+  // Intersect with kinetochore (e.g. semi-cylinder)
+  int minKinIdx = -1;
+  real minKinLen = mt->Length();
+  for (size_t c = 0; c < candidates.size(); c++)
+  {
+    int j = candidates[c];
+    vec3r ortX = cg.Get(ChromosomeGeometry::ORT_X, j);
+    vec3r ortY = cg.Get(ChromosomeGeometry::ORT_Y, j);
+    vec3r plNorm = cg.Get(ChromosomeGeometry::KIN_R, j);
+    vec3r kinBeg = cg.Get(ChromosomeGeometry::KIN_BEG, j);
+    vec3r kinEnd = cg.Get(ChromosomeGeometry::KIN_END, j);
+    if (geom.AreIntersected(Geometry::Segment(beg, end),
+                            Geometry::SemiTube(kinBeg, kinEnd, plNorm),
+                            interPoint))
+    {
+      // Collided, but we need to check the angle as well
+      vec3r dp = interPoint - kinBeg;
+      dp = dp - ortY * DotProduct(dp, ortY);
+      
+      if (DotProduct(dp, ortX) >= p.cr_kin_cosa * p.cr_kin_r &&
+          (interPoint - beg).GetLength() <= minKinLen)
+      {
+        // Ok, MT can be attached.
+        minKinIdx = j;
+        minKinLen = (interPoint-beg).GetLength();
       }
+      mt->State() = MTState::Depolymerization;
     }
   }
+  if (minKinIdx != -1)
+  {
+    mt->Length() = minKinLen;
+  }
+  return minKinIdx;
 }
 
-void CpuSimulator::DoMicroStep(Cell &cell, Random::State &state)
+// Updates the free MT: dynamic instability, collisions with the cell's boundary and with chromosomes
+// Returns index of the chromosome that can capture MT by its kinetochore or -1
+template <class STATE>
+int UpdateFreeMT(MT *mt, const ChromosomeGeometry &cg,
+                 const MicroStepParams &p, const Geometry &geom,
+                 const CapsuleGrid &grid, std::vector<int> &candidates,
+                 STATE &state)
 {
-  real r_cell        = (real)GlobalSimParams::GetRef()->GetParameter(SimParameter::Double::R_Cell, true);
-  real dt            = (real)GlobalSimParams::GetRef()->GetParameter(SimParameter::Double::Dt, true);
-  real radius        = (real)GlobalSimParams::GetRef()->GetParameter(SimParameter::Double::R_Cell, true);
-  real v_pol         = (real)GlobalSimParams::GetRef()->GetParameter(SimParameter::Double::V_Pol, true);
-  real v_dep         = (real)GlobalSimParams::GetRef()->GetParameter(SimParameter::Double::V_Dep, true);
-  real f_cat         = (real)GlobalSimParams::GetRef()->GetParameter(SimParameter::Double::F_Cat, true);
-  real f_res         = (real)GlobalSimParams::GetRef()->GetParameter(SimParameter::Double::F_Res, true);
-  real cr_hand_r     = (real)GlobalSimParams::GetRef()->GetParameter(SimParameter::Double::Cr_Hand_D, true) / 2;
-  real cr_kin_r      = (real)GlobalSimParams::GetRef()->GetParameter(SimParameter::Double::Cr_Kin_D, true) / 2;
-  real cr_kin_cosa   = (real)std::cos(GlobalSimParams::GetRef()->GetParameter(SimParameter::Double::Cr_Kin_Angle, true) / 2);
-  real cr_l          = (real)GlobalSimParams::GetRef()->GetParameter(SimParameter::Double::Cr_L, true);
-  real cr_kin_l      = (real)GlobalSimParams::GetRef()->GetParameter(SimParameter::Double::Cr_Kin_L, true);
-  real k_on          = (real)GlobalSimParams::GetRef()->GetParameter(SimParameter::Double::K_On, true);
-  real k_off         = (real)GlobalSimParams::GetRef()->GetParameter(SimParameter::Double::K_Off, true);
-  bool mt_lateral    = GlobalSimParams::GetRef()->GetParameter(SimParameter::Int::MT_Lateral_Attachments) != 0;
-  int n_kmt_max      = GlobalSimParams::GetRef()->GetParameter(SimParameter::Int::N_KMT_Max);
-  real cr_hand_l     = (cr_l - cr_kin_l) / 2;
-  int wi             = -1;
+  vec3r beg, end;
+  UpdateFreeMTDynamics(mt, p, beg, end, state);
+  return CollideFreeMT(mt, beg, end, cg, p, geom, grid, candidates);
+}
 
-  Geometry geom(r_cell * (real)1e-5f);
-  CellOps ops(&cell);
+// Flags of the batched checks, one set per pair of MT and chromosome
+const uint8_t HAND_COLLISION    = 1;    // with hands or plain side, matters only for the growing MTs
+const uint8_t KIN_COLLISION     = 2;    // with kinetochore
+const uint8_t KIN_ATTACHMENT    = 4;    // with kinetochore and the angle allows attachment
+
+// Batched version of the chromosome checks from 'UpdateFreeMT()', all segments are checked against one chromosome
+// Primitives and the following arithmetic are the same, so the results are bitwise equal
+void CollideWithChromosome(const BatchGeometry::Segments &segs,
+                           const ChromosomeGeometry &cg, int j,
+                           const MicroStepParams &p,
+                           uint8_t *flags, real *kinLen)
+{
+  BatchGeometry::Hits hits;
+  vec3r ortX = cg.Get(ChromosomeGeometry::ORT_X, j);
+  vec3r ortY = cg.Get(ChromosomeGeometry::ORT_Y, j);
+  vec3r ortZ = cg.Get(ChromosomeGeometry::ORT_Z, j);
+  vec3r plR1 = cg.Get(ChromosomeGeometry::HAND_R1, j);
+  vec3r plR2 = cg.Get(ChromosomeGeometry::HAND_R2, j);
+
+  // Hands
+  uint32_t handMask = 0;
+  vec3r handBeg, handEnd;
+  for (int h = 0; h < 2; h++)
+  {
+    handBeg = cg.Get(h == 0 ? ChromosomeGeometry::UPPER_HAND_BEG : ChromosomeGeometry::LOWER_HAND_BEG, j);
+    handEnd = cg.Get(h == 0 ? ChromosomeGeometry::UPPER_HAND_END : ChromosomeGeometry::LOWER_HAND_END, j);
+    handMask |= BatchGeometry::AreIntersected(segs, Geometry::SemiTube(handBeg, handEnd, plR2), hits);
+    handMask |= BatchGeometry::AreIntersected(segs, Geometry::Rectangle(handBeg - plR1, plR1 * 2, handEnd - handBeg), hits);
+    handMask |= BatchGeometry::AreIntersected(segs, Geometry::SemiCircle(handBeg, plR1, plR2), hits);
+    handMask |= BatchGeometry::AreIntersected(segs, Geometry::SemiCircle(handEnd, plR1, plR2), hits);
+  }
+
+  // Kinetchore back plane, is anchored to the lower hand
+  handMask |= BatchGeometry::AreIntersected(segs,
+                                            Geometry::Rectangle(handBeg - ortZ * p.cr_kin_r,
+                                                                ortZ * (2 * p.cr_kin_r),
+                                                                ortY * p.cr_kin_l),
+                                            hits);
+
+  // Kinetochore
+  vec3r plNorm = cg.Get(ChromosomeGeometry::KIN_R, j);
+  vec3r kinBeg = cg.Get(ChromosomeGeometry::KIN_BEG, j);
+  vec3r kinEnd = cg.Get(ChromosomeGeometry::KIN_END, j);
+  uint32_t kinMask = BatchGeometry::AreIntersected(segs, Geometry::SemiTube(kinBeg, kinEnd, plNorm), hits);
+
+  for (int l = 0; l < segs.count; l++)
+  {
+    uint8_t f = 0;
+    if ((handMask >> l) & 1)
+    { f |= HAND_COLLISION; }
+    if ((kinMask >> l) & 1)
+    {
+      f |= KIN_COLLISION;
+      vec3r dp = hits.Point(l) - kinBeg;
+      dp = dp - ortY * DotProduct(dp, ortY);
+      if (DotProduct(dp, ortX) >= p.cr_kin_cosa * p.cr_kin_r)
+      { f |= KIN_ATTACHMENT; }
+      kinLen[l] = hits.dist[l];
+    }
+    flags[l] = f;
+  }
+}
+
+} // unnamed namespace
 
-  auto kmts = ops.CountKMTs();
+void CpuSimulator::DoMicroStep(Cell &cell, Random::State &state, const SimParamsSnapshot &params)
+{
+  MicroStepParams p(params);
+  Geometry geom(p.r_cell * (real)1e-5f);
   const std::vector<MT *> &mts = cell.MTs();
-  for (int i = 0; i < mts.size(); i++)
+  const std::vector<Chromosome *> &chrs = cell.Chromosomes();
+  const ChromosomeGeometry &cg = GetChromosomeGeometry(cell, params);
+  CapsuleGrid grid(geom.GetEpsilon() * 2);
+  BuildChromosomeGrid(cg, grid);
+  std::vector<int> candidates;
+  for (size_t i = 0; i < mts.size(); i++)
   {
     MT *mt = mts[i];
     if (mt->BoundChromosome() == nullptr)
     {
-      if (mt->State() == MTState::Polymerization)
+      int minKinIdx = UpdateFreeMT(mt, cg, p, geom, grid, candidates, state);
+      if (minKinIdx != -1 &&
+          (int)chrs[minKinIdx]->KMTCount() < p.n_kmt_max &&
+          Random::NextReal(state) < p.k_on * p.dt)
       {
-        mt->Length() += v_pol * dt;
-        if (Random::NextReal(state) < f_cat * dt)
-        {
-          mt->State() = MTState::Depolymerization;
-        }
+        mt->Bind(chrs[minKinIdx]);
       }
-      else
+    }
+    else
+    {
+      if (Random::NextReal(state) < p.k_off * p.dt)
+      {
+        // Detach MT from chromosome
+        mt->UnBind();
+        mt->State() = MTState::Depolymerization;
+      }
+    }
+  }
+}
+
+namespace
+{
+
+// Special values of the MT's event, non-negative values are indices of the captured chromosomes
+const int NO_EVENT = -1;
+const int UNBIND_EVENT = -2;
+
+// Collisions of free MTs with chromosomes and attachment/detachment events, the second part of the intra-cell micro step
+// Free MTs must be already updated by the dynamic instability, their segments and states are given by 'begs',
+// 'ends' and 'growing', each MT continues to consume its own substream
+void ResolveFreeMTs(Cell &cell, const MicroStepParams &p, const ChromosomeGeometry &cg, const CapsuleGrid &grid,
+                    const std::vector<vec3r> &begs, const std::vector<vec3r> &ends,
+                    const std::vector<uint8_t> &growing, std::vector<Random::Substream> &substreams,
+                    int num_threads)
+{
+  const std::vector<MT *> &mts = cell.MTs();
+  const std::vector<Chromosome *> &chrs = cell.Chromosomes();
+  const int n_mts = (int)mts.size();
+  const int n_chrs = (int)chrs.size();
+  std::vector<int> events(n_mts, NO_EVENT);
+
+  // Pairs of free MTs and chromosomes that passed the broad phase, as 'mt, chr, mt, chr, ...'
+  std::vector<std::vector<int> > threadPairs(num_threads);
+
+  // Broad phase
+#pragma omp parallel num_threads(num_threads)
+  {
+    std::vector<int> candidates;
+    std::vector<int> &pairs = threadPairs[omp_get_thread_num()];
+
+#pragma omp for schedule(static)
+    for (int i = 0; i < n_mts; i++)
+    {
+      if (mts[i]->BoundChromosome() == nullptr)
       {
-        mt->Length() = std::max((real)0, mt->Length() - v_dep * dt);
-        if (mt->Length() == (real)0 || Random::NextReal(state) < f_res * dt)
+        grid.Query(begs[i], ends[i], candidates);
+        for (size_t c = 0; c < candidates.size(); c++)
         {
-          mt->State() = MTState::Polymerization;
-          if (mt->Length() == (real)0)
-          {
-            double alpha = Random::NextReal(state) * PI * 2;
-            real dx = Random::NextReal(state) * (mt->GetPole()->Type() == PoleType::Left ? 1 : -1);
-            real dy = (real)(std::sqrt(1.0 - dx * dx) * std::cos(alpha));
-            real dz = (real)(std::sqrt(1.0 - dx * dx) * std::sin(alpha));
-            vec3r dir(dx, dy, dz);
-            mt->Direction() = dir;
-          }
+          pairs.push_back(i);
+          pairs.push_back(candidates[c]);
         }
       }
+    }
+  }
 
-      vec3r beg = mt->GetPole()->Position();
-      vec3r dir = (vec3r)mt->Direction();
-      real len = mt->Length();
-      vec3r end = beg + dir * len;
-      if (mt->State() == MTState::Polymerization)
+  // Groups pairs by chromosomes, so each batch of MTs is checked against the same primitives
+  std::vector<int> chrStart(n_chrs + 1, 0);
+  for (size_t t = 0; t < threadPairs.size(); t++)
+  {
+    for (size_t k = 1; k < threadPairs[t].size(); k += 2)
+    { chrStart[threadPairs[t][k] + 1] += 1; }
+  }
+  for (int j = 0; j < n_chrs; j++)
+  { chrStart[j + 1] += chrStart[j]; }
+  std::vector<int> pairMT(chrStart.back());
+  {
+    std::vector<int> fill(chrStart.begin(), chrStart.end() - 1);
+    for (size_t t = 0; t < threadPairs.size(); t++)
+    {
+      for (size_t k = 0; k < threadPairs[t].size(); k += 2)
+      { pairMT[fill[threadPairs[t][k + 1]]++] = threadPairs[t][k]; }
+    }
+  }
+
+  // Step 2: batched checks of MTs against chromosomes
+  std::vector<uint8_t> pairFlags(pairMT.size(), 0);
+  std::vector<real> pairKinLen(pairMT.size(), (real)0);
+
+#pragma omp parallel for num_threads(num_threads) schedule(dynamic)
+  for (int j = 0; j < n_chrs; j++)
+  {
+    BatchGeometry::Segments segs;
+    for (int k = chrStart[j]; k < chrStart[j + 1]; k += BatchGeometry::WIDTH)
+    {
+      int count = std::min(BatchGeometry::WIDTH, chrStart[j + 1] - k);
+      segs.Clear();
+      for (int l = 0; l < count; l++)
+      { segs.Set(l, begs[pairMT[k + l]], ends[pairMT[k + l]]); }
+      CollideWithChromosome(segs, cg, j, p, &pairFlags[k], &pairKinLen[k]);
+    }
+  }
+
+  // Chromosomes are visited in the ascending order, as in the scalar version
+  std::vector<int> minKinIdx(n_mts, -1);
+  std::vector<real> minKinLen(n_mts);
+  std::vector<uint8_t> collided(n_mts, 0);
+  for (int i = 0; i < n_mts; i++)
+  { minKinLen[i] = mts[i]->Length(); }
+  for (int j = 0; j < n_chrs; j++)
+  {
+    for (int k = chrStart[j]; k < chrStart[j + 1]; k++)
+    {
+      int i = pairMT[k];
+      if ((pairFlags[k] & HAND_COLLISION) && growing[i])
+      { collided[i] = 1; }
+      if (pairFlags[k] & KIN_COLLISION)
       {
-        // Check cell boundaries
-        if (end.GetLength() >= radius)
+        if ((pairFlags[k] & KIN_ATTACHMENT) && pairKinLen[k] <= minKinLen[i])
         {
-          mt->State() = MTState::Depolymerization;
+          minKinIdx[i] = j;
+          minKinLen[i] = pairKinLen[k];
         }
+        collided[i] = 1;
       }
+    }
+  }
 
-      vec3r interPoint;
-      const std::vector<Chromosome *> &chrs = cell.Chromosomes();
-      if(mt->State() == MTState::Polymerization)
+  // Step 3: results of collisions and attachment/detachment events
+#pragma omp parallel for num_threads(num_threads) schedule(static)
+  for (int i = 0; i < n_mts; i++)
+  {
+    MT *mt = mts[i];
+    Random::Substream &substream = substreams[i];
+    if (mt->BoundChromosome() == nullptr)
+    {
+      if (collided[i])
+      { mt->State() = MTState::Depolymerization; }
+      if (minKinIdx[i] != -1)
       {
-        // Intersect with hands or plain side
-        bool intersects = false;
-        bool pls = false;
-        for (int j = 0; j < chrs.size(); j++)
-        {
-          Chromosome *cr = chrs[j];
-          mat3x3r chrOrient = (mat3x3r)cr->Orientation();
-          vec3r ortX = (chrOrient * vec3r(1, 0, 0)).Normalize();
-          vec3r ortY = (chrOrient * vec3r(0, 1, 0)).Normalize();
-          vec3r ortZ = (chrOrient * vec3r(0, 0, 1)).Normalize();
-          vec3r plR1 = ortZ * -cr_hand_r;
-          vec3r plR2 = ortX *  cr_hand_r;
-          // Hands
-          // Upper hand
-          Geometry::Segment seg(beg, end);
-          vec3r handBeg = (vec3r)cr->Position() + ortY * (real)(cr_kin_l / 2);
-          vec3r handEnd = (vec3r)cr->Position() + ortY * (real)(cr_l / 2);
-
-          if (geom.AreIntersected(seg, Geometry::SemiTube(handBeg, handEnd, plR2), interPoint) ||
-              geom.AreIntersected(seg, Geometry::Rectangle(handBeg - plR1, plR1 * 2, handEnd - handBeg), interPoint) ||
-              geom.AreIntersected(seg, Geometry::SemiCircle(handBeg, plR1, plR2), interPoint) ||
-              geom.AreIntersected(seg, Geometry::SemiCircle(handEnd, plR1, plR2), interPoint))
-          {
-            intersects = true;
-            break;
-          }
+        mt->Length() = minKinLen[i];
+        if (Random::NextReal(substream) < p.k_on * p.dt)
+        { events[i] = minKinIdx[i]; }
+      }
+    }
+    else
+    {
+      if (Random::NextReal(substream) < p.k_off * p.dt)
+      { events[i] = UNBIND_EVENT; }
+    }
+  }
 
-          // Lower hand
-          handBeg = (vec3r)cr->Position() + ortY * (real)(-cr_kin_l / 2);
-          handEnd = (vec3r)cr->Position() + ortY * (real)(-cr_l / 2);
-          if (geom.AreIntersected(seg, Geometry::SemiTube(handBeg, handEnd, plR2), interPoint) ||
-              geom.AreIntersected(seg, Geometry::Rectangle(handBeg - plR1, plR1 * 2, handEnd - handBeg), interPoint) ||
-              geom.AreIntersected(seg, Geometry::SemiCircle(handBeg, plR1, plR2), interPoint) ||
-              geom.AreIntersected(seg, Geometry::SemiCircle(handEnd, plR1, plR2), interPoint))
-          {
-            intersects = true;
-            break;
-          }
+  // Kinetochores have limited capacity, so the attachments are resolved in the order of MTs
+  for (size_t i = 0; i < mts.size(); i++)
+  {
+    MT *mt = mts[i];
+    if (events[i] == UNBIND_EVENT)
+    {
+      // Detach MT from chromosome
+      mt->UnBind();
+      mt->State() = MTState::Depolymerization;
+    }
+    else if (events[i] != NO_EVENT && (int)chrs[events[i]]->KMTCount() < p.n_kmt_max)
+    {
+      mt->Bind(chrs[events[i]]);
+    }
+  }
+}
 
-          // Kinetchore back plane.
-          if (geom.AreIntersected(seg,
-                                  Geometry::Rectangle(handBeg - ortZ * cr_kin_r,
-                                                      ortZ * (2 * cr_kin_r),
-                                                      ortY * cr_kin_l),
-                                  interPoint))
-          {
-            intersects = true;
-            break;
-          }
-        }
+} // unnamed namespace
 
-        if (intersects)
-        {
-          mt->State() = MTState::Depolymerization;
-        }
+void CpuSimulator::DoMicroStep(Cell &cell, Random::State &state, const SimParamsSnapshot &params, int num_threads)
+{
+  MicroStepParams p(params);
+  Geometry geom(p.r_cell * (real)1e-5f);
+
+  const std::vector<MT *> &mts = cell.MTs();
+  const int n_mts = (int)mts.size();
+  const ChromosomeGeometry &cg = GetChromosomeGeometry(cell, params);
+  CapsuleGrid grid(geom.GetEpsilon() * 2);
+  BuildChromosomeGrid(cg, grid);
+
+  // Each MT consumes its own substream, so the results don't depend on the count of threads
+  uint32_t seed = Random::Next(state);
+  std::vector<Random::Substream> substreams(n_mts);
+  std::vector<vec3r> begs(n_mts), ends(n_mts);
+  std::vector<uint8_t> growing(n_mts, 0);
+
+  // Step 1: dynamic instability of free MTs
+#pragma omp parallel for num_threads(num_threads) schedule(static)
+  for (int i = 0; i < n_mts; i++)
+  {
+    MT *mt = mts[i];
+    Random::Split(seed, (uint32_t)i, substreams[i]);
+    if (mt->BoundChromosome() == nullptr)
+    {
+      UpdateFreeMTDynamics(mt, p, begs[i], ends[i], substreams[i]);
+      growing[i] = mt->State() == MTState::Polymerization ? 1 : 0;
+    }
+  }
+
+  // Steps 2 and 3: collisions with chromosomes and events
+  ResolveFreeMTs(cell, p, cg, grid, begs, ends, growing, substreams, num_threads);
+}
+
+namespace
+{
+
+// Events of the free MT in the event-driven engine
+enum FreeMTEvent
+{
+  SWITCH_EVENT,           // catastrophe or rescue
+  ZERO_LENGTH_EVENT,      // depolymerizing MT has disappeared, it starts growing in a new direction
+  BOUNDARY_EVENT,         // growing MT has touched the cell's boundary
+  NEAR_EVENT              // growing MT has entered bounding capsules of chromosomes
+};
+
+const double NEVER = std::numeric_limits<double>::infinity();
+
+// Time of the next event of the Poisson process with the given rate
+double SampleEventTime(Random::State &state, double time, real rate)
+{
+  if (rate <= 0)
+  { return NEVER; }
+  return time - std::log(1.0 - (double)Random::NextReal(state)) / rate;
+}
+
+// Time that is required to change the length by 'delta' with the given velocity
+double TimeToReach(real delta, real v)
+{
+  if (delta <= 0)
+  { return 0.0; }
+  return v > 0 ? (double)delta / v : NEVER;
+}
+
+// Returns the type and time of the next event, the time doesn't depend on steps
+FreeMTEvent NextEvent(const FreeMTSchedule::Track &track, MTState::Type mtState,
+                      const FreeMTSchedule::Kinetics &kinetics, double &time)
+{
+  FreeMTEvent res = SWITCH_EVENT;
+  time = track.switchTime;
+  if (mtState == MTState::Polymerization)
+  {
+    double t = track.time + TimeToReach(track.boundaryLength - track.length, kinetics.v_pol);
+    if (t <= time)
+    {
+      time = t;
+      res = BOUNDARY_EVENT;
+    }
+    if (!track.near)
+    {
+      t = track.time + TimeToReach(track.nearLength - track.length, kinetics.v_pol);
+      if (t < time)
+      {
+        time = t;
+        res = NEAR_EVENT;
       }
+    }
+  }
+  else
+  {
+    double t = track.time + TimeToReach(track.length, kinetics.v_dep);
+    if (t <= time)
+    {
+      time = t;
+      res = ZERO_LENGTH_EVENT;
+    }
+  }
+  return res;
+}
+
+// Anchors the free MT at 'time' using its length, state and direction from the cell
+// Limits are recomputed and the next event is queued, the previous entries become outdated
+void Reschedule(MT *mt, FreeMTSchedule &schedule, double time, std::vector<int> &candidates)
+{
+  FreeMTSchedule::Track &track = schedule.Get(mt->ID());
+  vec3r beg = mt->GetPole()->Position();
+  vec3r dir = (vec3r)mt->Direction();
+  track.time = time;
+  track.length = mt->Length();
+  track.boundaryLength = schedule.BoundaryLength(beg, dir);
+  track.nearLength = schedule.NearLength(beg, dir, candidates);
+  track.version++;
+  if (!track.near && track.length >= track.nearLength)
+  {
+    track.near = true;
+    schedule.Near().push_back(mt->ID());
+  }
+
+  double next;
+  NextEvent(track, mt->State(), schedule.GetKinetics(), next);
+  if (next < NEVER)
+  { schedule.Push(mt->ID(), next); }
+}
+
+} // unnamed namespace
 
-      // Intersect with kinetochore (e.g. semi-cylinder)
-      int minKinIdx = -1;
-      real minKinLen = mt->Length();
-      for (int j = 0; j < chrs.size(); j++)
+void CpuSimulator::DoEventMicroStep(Cell &cell, Random::State &state, const SimParamsSnapshot &params,
+                                    FreeMTSchedule &schedule)
+{
+  MicroStepParams p(params);
+  Geometry geom(p.r_cell * (real)1e-5f);
+  const std::vector<MT *> &mts = cell.MTs();
+  const std::vector<Chromosome *> &chrs = cell.Chromosomes();
+  const ChromosomeGeometry &cg = GetChromosomeGeometry(cell, params);
+  CapsuleGrid grid(geom.GetEpsilon() * 2);
+  BuildChromosomeGrid(cg, grid);
+  std::vector<int> candidates;
+  const double now = schedule.Time();
+  const double next = now + p.dt;
+
+  // Poles or parameters have changed, so all free MTs are anchored again
+  // Switches are memoryless, their times are sampled again only for the new rates
+  FreeMTSchedule::Kinetics kinetics = { p.v_pol, p.v_dep, p.f_cat, p.f_res, p.r_cell };
+  if (!schedule.IsActual(cell, cg, kinetics))
+  {
+    schedule.Materialize(cell);
+    bool resample = !schedule.IsValid() || !(schedule.GetKinetics() == kinetics);
+    schedule.Reset(cell, cg, kinetics);
+    for (size_t i = 0; i < mts.size(); i++)
+    {
+      MT *mt = mts[i];
+      FreeMTSchedule::Track &track = schedule.Get((uint32_t)i);
+      bool free = mt->BoundChromosome() == nullptr;
+      if (free && (resample || !track.free))
       {
-        Chromosome *cr = chrs[j];
-        mat3x3r chrOrient = (mat3x3r)cr->Orientation();
-        vec3r ortX = (chrOrient * vec3r(1, 0, 0)).Normalize();
-        vec3r ortY = (chrOrient * vec3r(0, 1, 0)).Normalize();
-        vec3r plNorm = ortX * cr_kin_r;
-        vec3r kinBeg = (vec3r)cr->Position() + chrOrient * vec3r((real)0, (real)(-cr_kin_l / 2), (real)0);
-        vec3r kinEnd = (vec3r)cr->Position() + chrOrient * vec3r((real)0, (real)(cr_kin_l / 2), (real)0);
-        if (geom.AreIntersected(Geometry::Segment(beg, end),
-                                Geometry::SemiTube(kinBeg, kinEnd, plNorm),
-                                interPoint))
+        track.switchTime = SampleEventTime(state, now,
+                                           mt->State() == MTState::Polymerization ? p.f_cat : p.f_res);
+      }
+      track.free = free;
+      if (free)
+      { Reschedule(mt, schedule, now, candidates); }
+    }
+  }
+  else
+  {
+    // Some chromosomes have left their capsules, only the MTs that reach the new capsules earlier are anchored again
+    // Other MTs keep their limits, they are conservative: the MT becomes near at most too early
+    // Near MTs have no pending near events, only their limits are updated
+    std::vector<int> moved;
+    schedule.Update(cg, moved);
+    for (size_t i = 0; i < mts.size() && !moved.empty(); i++)
+    {
+      MT *mt = mts[i];
+      FreeMTSchedule::Track &track = schedule.Get((uint32_t)i);
+      if (!track.free)
+      { continue; }
+
+      vec3r beg = mt->GetPole()->Position();
+      vec3r dir = (vec3r)mt->Direction();
+      real nearLength = track.nearLength;
+      for (size_t k = 0; k < moved.size(); k++)
+      { nearLength = std::min(nearLength, schedule.NearLength(beg, dir, moved[k])); }
+      if (track.near)
+      { track.nearLength = nearLength; }
+      else if (nearLength < track.nearLength)
+      {
+        mt->Length() = schedule.LengthAt((uint32_t)i, mt->State(), now);
+        Reschedule(mt, schedule, now, candidates);
+      }
+    }
+  }
+
+  // MTs that were bound at the beginning of step, the new ones are not detached at the same step
+  std::vector<MT *> bound;
+  for (size_t j = 0; j < chrs.size(); j++)
+  {
+    for (MT *mt : chrs[j]->KMTs())
+    { bound.push_back(mt); }
+  }
+
+  // Events of free MTs in the order of their times
+  uint32_t id;
+  double time;
+  while (schedule.Pop(next, id, time))
+  {
+    MT *mt = mts[id];
+    FreeMTSchedule::Track &track = schedule.Get(id);
+    double expected;
+    switch (NextEvent(track, mt->State(), kinetics, expected))
+    {
+      case SWITCH_EVENT:
+        mt->Length() = schedule.LengthAt(id, mt->State(), time);
+        if (mt->State() == MTState::Polymerization)
         {
-          // Collided, but we need to check the angle as well
-          vec3r dp = interPoint - kinBeg;
-          dp = dp - ortY * DotProduct(dp, ortY);
-          
-          if (DotProduct(dp, ortX) >= cr_kin_cosa * cr_kin_r &&
-              (interPoint - beg).GetLength() <= minKinLen)
-          {
-            // Ok, MT can be attached.
-            minKinIdx = j;
-            minKinLen = (interPoint-beg).GetLength();
-          }
           mt->State() = MTState::Depolymerization;
+          track.switchTime = SampleEventTime(state, time, p.f_res);
         }
-      }
-      if (minKinIdx != -1)
-      {
-        if (kmts[minKinIdx] < n_kmt_max &&
-            Random::NextReal(state) < k_on * dt)
+        else
         {
-          mt->Bind(chrs[minKinIdx]);
-          kmts[minKinIdx] += 1;
+          mt->State() = MTState::Polymerization;
+          track.switchTime = SampleEventTime(state, time, p.f_cat);
         }
-        mt->Length() = minKinLen;
-      }
+        break;
+
+      case ZERO_LENGTH_EVENT:
+        mt->Length() = (real)0;
+        mt->State() = MTState::Polymerization;
+        mt->Direction() = RandomDirection(mt, state);
+        track.switchTime = SampleEventTime(state, time, p.f_cat);
+        break;
+
+      case BOUNDARY_EVENT:
+        mt->Length() = track.boundaryLength;
+        mt->State() = MTState::Depolymerization;
+        track.switchTime = SampleEventTime(state, time, p.f_res);
+        break;
+
+      case NEAR_EVENT:
+        mt->Length() = track.nearLength;
+        break;
     }
-    else
+    Reschedule(mt, schedule, time, candidates);
+  }
+
+  // Near MTs are checked against chromosomes at the end of step, as in the other versions
+  std::vector<uint32_t> &near = schedule.Near();
+  std::sort(near.begin(), near.end());
+  size_t kept = 0;
+  for (size_t k = 0; k < near.size(); k++)
+  {
+    id = near[k];
+    MT *mt = mts[id];
+    FreeMTSchedule::Track &track = schedule.Get(id);
+    real len = schedule.LengthAt(id, mt->State(), next);
+    if (len < track.nearLength)
     {
-      if (Random::NextReal(state) < k_off * dt)
-      {
-        // Detach MT from chromosome
-        Chromosome *cr = mt->BoundChromosome();
-        mt->UnBind();
-        kmts[cr->ID()] -= 1;
-        mt->State() = MTState::Depolymerization;
-      }
+      // The MT may grow again, so it needs the near event that was skipped while it was near
+      track.near = false;
+      mt->Length() = len;
+      Reschedule(mt, schedule, next, candidates);
+      continue;
+    }
+
+    MTState::Type prevState = mt->State();
+    mt->Length() = len;
+    vec3r beg = mt->GetPole()->Position();
+    vec3r end = beg + (vec3r)mt->Direction() * len;
+    int minKinIdx = CollideFreeMT(mt, beg, end, cg, p, geom, grid, candidates);
+    if (minKinIdx != -1 &&
+        (int)chrs[minKinIdx]->KMTCount() < p.n_kmt_max &&
+        Random::NextReal(state) < p.k_on * p.dt)
+    {
+      mt->Bind(chrs[minKinIdx]);
+      track.free = false;
+      track.near = false;
+      continue;
+    }
+
+    if (mt->State() != prevState)
+    { track.switchTime = SampleEventTime(state, next, p.f_res); }
+    if (mt->State() != prevState || mt->Length() != len)
+    { Reschedule(mt, schedule, next, candidates); }
+    near[kept++] = id;
+  }
+  near.resize(kept);
+
+  for (size_t i = 0; i < bound.size(); i++)
+  {
+    MT *mt = bound[i];
+    if (Random::NextReal(state) < p.k_off * p.dt)
+    {
+      // Detach MT from chromosome, now it's a free MT
+      mt->UnBind();
+      mt->State() = MTState::Depolymerization;
+      FreeMTSchedule::Track &track = schedule.Get(mt->ID());
+      track.free = true;
+      track.near = false;
+      track.switchTime = SampleEventTime(state, next, p.f_res);
+      Reschedule(mt, schedule, next, candidates);
     }
   }
+
+  schedule.Advance(p.dt);
 }
 
-void CpuSimulator::DoPoleUpdatingStep(Cell &cell, Random::State &state, IPoleUpdater *updater, double time)
+void CpuSimulator::DoPoleUpdatingStep(Cell &cell, Random::State &state, const SimParamsSnapshot &params,
+                                      IPoleUpdater *updater, double time)
 {
-  real dt        = (real)GlobalSimParams::GetRef()->GetParameter(SimParameter::Double::Dt);
+  real dt        = params[SimParameter::Double::Dt];
   vec3r oldLeft  = (vec3r)cell.GetPole(PoleType::Left)->Position();
   vec3r oldRight = (vec3r)cell.GetPole(PoleType::Right)->Position();
 
@@ -621,60 +1227,58 @@ void CpuSimulator::DoPoleUpdatingStep(Cell &cell, Random::State &state, IPoleUpd
   {
     vec3r leftPoleOffset = (vec3r)cell.GetPole(PoleType::Left)->Position() - oldLeft;
     vec3r rightPoleOffset = (vec3r)cell.GetPole(PoleType::Right)->Position() - oldRight;
-    const std::vector<MT *> &mts = cell.MTs();
-    for (size_t i = 0; i < mts.size(); i++)
+    // Only bound MTs are moved, they are taken from the index
+    const std::vector<Chromosome *> &chrs = cell.Chromosomes();
+    for (size_t j = 0; j < chrs.size(); j++)
     {
-      if (mts[i]->BoundChromosome() != nullptr)
+      for (MT *mt : chrs[j]->KMTs())
       {
-        vec3r oldVec = (vec3r)mts[i]->Direction() * mts[i]->Length();
-        vec3r newVec = oldVec - (mts[i]->GetPole()->Type() == PoleType::Left
+        vec3r oldVec = (vec3r)mt->Direction() * mt->Length();
+        vec3r newVec = oldVec - (mt->GetPole()->Type() == PoleType::Left
                 ? leftPoleOffset
                 : rightPoleOffset);
-        mts[i]->Length() = newVec.GetLength();
-        mts[i]->Direction() = mts[i]->Length() == 0.0 ? vec3r::DEFAULT_DIRECT : (vec3r)newVec.Normalize();
+        mt->Length() = newVec.GetLength();
+        mt->Direction() = mt->Length() == 0.0 ? vec3r::DEFAULT_DIRECT : (vec3r)newVec.Normalize();
       }
     }
   }
 }
 
-void CpuSimulator::DoSpringBreakingStep(Cell &cell, Random::State &state)
+void CpuSimulator::DoSpringBreakingStep(Cell &cell, const SimParamsSnapshot &params)
 {
   if(cell.Chromosomes().size() == 0)
   { return; }
   if (!cell.AreSpringsBroken())
   {
-    CellOps cellOps(&cell);
-    auto kmts = cellOps.ExtractKMTs();
-
-    if (GlobalSimParams::GetRef()->GetParameter(SimParameter::Int::Spring_Brake_Type) == 1)
+    if (params[SimParameter::Int::Spring_Brake_Type] == 1)
     {
-      int minCount = GlobalSimParams::GetRef()->GetParameter(SimParameter::Int::Spring_Brake_MTs) * 2;
+      int minCount = params[SimParameter::Int::Spring_Brake_MTs] * 2;
       const std::vector<Chromosome *> &chrs = cell.Chromosomes();
       for (size_t i = 0; i < chrs.size(); i++)
       {
-        if (minCount > kmts[i].size())
-        { minCount = (int)kmts[i].size(); }
+        if (minCount > (int)chrs[i]->KMTCount())
+        { minCount = (int)chrs[i]->KMTCount(); }
       }
-      if (minCount >= GlobalSimParams::GetRef()->GetParameter(SimParameter::Int::Spring_Brake_MTs))
+      if (minCount >= params[SimParameter::Int::Spring_Brake_MTs])
         cell.SetSpringFlag(true);
     }
     else
     {
-      real minForce = (real)GlobalSimParams::GetRef()->GetParameter(SimParameter::Double::Spring_Brake_Force, true) * 2;
-      real const_a  = (real)GlobalSimParams::GetRef()->GetParameter(SimParameter::Double::Const_A, true);
-      const std::vector<Chromosome *> &chrs = cell.Chromosomes();
-      for (size_t i = 0; i < chrs.size(); i++)
+      real minForce = params[SimParameter::Double::Spring_Brake_Force] * 2;
+      real const_a  = params[SimParameter::Double::Const_A];
+      const ChromosomeGeometry &cg = GetChromosomeGeometry(cell, params);
+      for (size_t i = 0; i < cg.Count(); i++)
       {
-        Chromosome *cr = chrs[i];
+        vec3r crPos = cg.Get(ChromosomeGeometry::POSITION, i);
         vec3r curForce(0, 0, 0);
-        for (auto mt : kmts[i])
-        { curForce = curForce + ((mt->GetPole()->Position() - cr->Position()).Normalize() * const_a); }
+        for (auto mt : cell.Chromosomes()[i]->KMTs())
+        { curForce = curForce + ((mt->GetPole()->Position() - crPos).Normalize() * const_a); }
 
         real curForceMod = curForce.GetLength();
         if (minForce > curForceMod)
           minForce = curForceMod;
       }
-      if (minForce >= GlobalSimParams::GetRef()->GetParameter(SimParameter::Double::Spring_Brake_Force, true))
+      if (minForce >= params.Exact(SimParameter::Double::Spring_Brake_Force))
         cell.SetSpringFlag(true);
     }
   }
@@ -0,0 +1,190 @@
+#include "FreeMTSchedule.h"
+
+#include "MiCoSi.Objects/All.h"
+
+//----------------------
+//--- FreeMTSchedule ---
+//----------------------
+
+FreeMTSchedule::FreeMTSchedule(size_t mts)
+  : _valid(false), _time(0.0), _tracks(mts), _radius((real)0), _margin((real)0)
+{
+  for (size_t i = 0; i < _tracks.size(); i++)
+  {
+    _tracks[i].version = 0;
+    _tracks[i].free = false;
+    _tracks[i].near = false;
+  }
+  _kinetics.v_pol = _kinetics.v_dep = _kinetics.f_cat = _kinetics.f_res = _kinetics.r_cell = (real)0;
+}
+
+real FreeMTSchedule::LengthAt(uint32_t mt, MTState::Type state, double time) const
+{
+  const Track &track = _tracks[mt];
+  if (state == MTState::Polymerization)
+  { return (real)(track.length + _kinetics.v_pol * (time - track.time)); }
+  else
+  { return (real)std::max(0.0, track.length - _kinetics.v_dep * (time - track.time)); }
+}
+
+void FreeMTSchedule::Materialize(Cell &cell) const
+{
+  if (!_valid)
+  { return; }
+
+  const std::vector<MT *> &mts = cell.MTs();
+  for (size_t i = 0; i < mts.size(); i++)
+  {
+    if (_tracks[i].free)
+    { mts[i]->Length() = LengthAt((uint32_t)i, mts[i]->State(), _time); }
+  }
+}
+
+bool FreeMTSchedule::IsActual(const Cell &cell, const ChromosomeGeometry &cg, const Kinetics &kinetics) const
+{
+  if (!_valid || !(_kinetics == kinetics) || _begs.size() != cg.Count())
+  { return false; }
+
+  return (vec3r)cell.GetPole(PoleType::Left)->Position() == _poles[0] &&
+         (vec3r)cell.GetPole(PoleType::Right)->Position() == _poles[1];
+}
+
+void FreeMTSchedule::Update(const ChromosomeGeometry &cg, std::vector<int> &moved)
+{
+  // If both ends of axis have moved less than margin, the whole axis has moved less than margin
+  moved.clear();
+  for (size_t j = 0; j < _begs.size(); j++)
+  {
+    vec3r beg = cg.Get(ChromosomeGeometry::BOUND_BEG, j);
+    vec3r end = cg.Get(ChromosomeGeometry::BOUND_END, j);
+    if ((beg - _begs[j]).GetLength() > _margin || (end - _ends[j]).GetLength() > _margin)
+    {
+      _begs[j] = beg;
+      _ends[j] = end;
+      moved.push_back((int)j);
+    }
+  }
+  if (!moved.empty())
+  { BuildCapsules(); }
+}
+
+void FreeMTSchedule::BuildCapsules()
+{
+  _capsules.Clear();
+  for (size_t j = 0; j < _begs.size(); j++)
+  { _capsules.Add(_begs[j], _ends[j], _radius); }
+  _capsules.Build();
+}
+
+void FreeMTSchedule::Reset(const Cell &cell, const ChromosomeGeometry &cg, const Kinetics &kinetics)
+{
+  _kinetics = kinetics;
+  _poles[0] = (vec3r)cell.GetPole(PoleType::Left)->Position();
+  _poles[1] = (vec3r)cell.GetPole(PoleType::Right)->Position();
+
+  // Chromosomes move slowly, so the margin equals to their radius
+  _margin = cg.BoundRadius();
+  _radius = cg.BoundRadius() + _margin;
+  _begs.resize(cg.Count());
+  _ends.resize(cg.Count());
+  for (size_t j = 0; j < cg.Count(); j++)
+  {
+    _begs[j] = cg.Get(ChromosomeGeometry::BOUND_BEG, j);
+    _ends[j] = cg.Get(ChromosomeGeometry::BOUND_END, j);
+  }
+  BuildCapsules();
+
+  _queue.clear();
+  _near.clear();
+  for (size_t i = 0; i < _tracks.size(); i++)
+  { _tracks[i].near = false; }
+  _valid = true;
+}
+
+real FreeMTSchedule::BoundaryLength(const vec3r &beg, const vec3r &dir) const
+{
+  real b = DotProduct(beg, dir);
+  real c = beg.GetLength2() - _kinetics.r_cell * _kinetics.r_cell;
+  if (c >= 0)
+  { return std::numeric_limits<real>::infinity(); }
+  return -b + std::sqrt(b * b - c);
+}
+
+real FreeMTSchedule::NearLength(const vec3r &beg, const vec3r &dir, std::vector<int> &candidates) const
+{
+  real res = std::numeric_limits<real>::infinity();
+  _capsules.Query(beg, beg + dir * (_kinetics.r_cell * 2), candidates);
+  for (size_t k = 0; k < candidates.size() && res > 0; k++)
+  { res = std::min(res, NearLength(beg, dir, candidates[k])); }
+  return res;
+}
+
+real FreeMTSchedule::NearLength(const vec3r &beg, const vec3r &dir, int chromosome) const
+{
+  // Capsule is a union of the finite cylinder and two spheres, the ray enters one of them first
+  const real r2 = _radius * _radius;
+  vec3r d = _ends[chromosome] - _begs[chromosome];
+  vec3r m = beg - _begs[chromosome];
+  real dd = d.GetLength2();
+  real md = DotProduct(m, d);
+  real t = dd > 0 ? std::min(std::max(md / dd, (real)0), (real)1) : (real)0;
+  if ((m - d * t).GetLength2() <= r2)
+  { return (real)0; }
+
+  // Cylinder, only the points between the ends of axis are taken
+  real res = std::numeric_limits<real>::infinity();
+  real nd = DotProduct(dir, d);
+  real a = dd - nd * nd;
+  if (a > 0)
+  {
+    real b = dd * DotProduct(m, dir) - nd * md;
+    real c = dd * (m.GetLength2() - r2) - md * md;
+    real disc = b * b - a * c;
+    if (disc >= 0)
+    {
+      real s = (-b - std::sqrt(disc)) / a;
+      real axial = md + s * nd;
+      if (s >= 0 && axial >= 0 && axial <= dd)
+      { res = s; }
+    }
+  }
+
+  // Spheres at the ends of axis
+  for (int e = 0; e < 2; e++)
+  {
+    vec3r oc = beg - (e == 0 ? _begs[chromosome] : _ends[chromosome]);
+    real b = DotProduct(oc, dir);
+    real c = oc.GetLength2() - r2;
+    real disc = b * b - c;
+    if (b < 0 && disc >= 0)
+    { res = std::min(res, -b - std::sqrt(disc)); }
+  }
+  return res;
+}
+
+void FreeMTSchedule::Push(uint32_t mt, double time)
+{
+  Entry e;
+  e.time = time;
+  e.mt = mt;
+  e.version = _tracks[mt].version;
+  _queue.push_back(e);
+  std::push_heap(_queue.begin(), _queue.end());
+}
+
+bool FreeMTSchedule::Pop(double until, uint32_t &mt, double &time)
+{
+  while (!_queue.empty() && _queue.front().time <= until)
+  {
+    Entry e = _queue.front();
+    std::pop_heap(_queue.begin(), _queue.end());
+    _queue.pop_back();
+    if (_tracks[e.mt].free && _tracks[e.mt].version == e.version)
+    {
+      mt = e.mt;
+      time = e.time;
+      return true;
+    }
+  }
+  return false;
+}
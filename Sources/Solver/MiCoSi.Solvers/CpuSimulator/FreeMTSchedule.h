@@ -0,0 +1,125 @@
+#pragma once
+#include "MiCoSi.Core/Defs.h"
+
+#include "MiCoSi.Geometry/CapsuleGrid.h"
+#include "MiCoSi.Objects/Cell.h"
+#include "MiCoSi.Objects/MT.h"
+
+// State of the event-driven engine for free MTs (see 'CpuSimulator::DoEventMicroStep()')
+// Between events the length of free MT changes linearly, so only the anchor (time and length) is stored
+// Lengths in 'CellData' are updated lazily: by events and by 'Materialize()'
+// Geometry that MTs depend on is remembered as well: changes of poles require rescheduling of all free MTs,
+// bounding capsules of chromosomes are moved one by one when chromosomes leave them
+class FreeMTSchedule
+{
+  public:
+    // Kinetics of free MTs, changes of these values require rescheduling
+    struct Kinetics
+    {
+      real v_pol, v_dep, f_cat, f_res, r_cell;
+
+      bool operator ==(const Kinetics &k) const
+      { return v_pol == k.v_pol && v_dep == k.v_dep && f_cat == k.f_cat && f_res == k.f_res && r_cell == k.r_cell; }
+    };
+
+    // Anchor and precomputed limits of the free MT
+    struct Track
+    {
+      double time;            // the MT had 'length' at this time
+      real length;
+      double switchTime;      // time of the next catastrophe or rescue
+      real boundaryLength;    // length at which the MT touches the cell's boundary
+      real nearLength;        // length at which the MT enters bounding capsules of chromosomes
+      uint32_t version;       // entries of queue with other versions are outdated
+      bool free;              // false for bound MTs, they are not tracked
+      bool near;              // the MT may collide with chromosomes, it is checked on each step
+    };
+
+    FreeMTSchedule(size_t mts);
+    FreeMTSchedule(const FreeMTSchedule &) = delete;
+    FreeMTSchedule &operator =(const FreeMTSchedule &) = delete;
+
+    // False until the first rescheduling
+    bool IsValid() const
+    { return _valid; }
+
+    // Time of the engine, it is counted from its first step
+    double Time() const
+    { return _time; }
+
+    void Advance(double dt)
+    { _time += dt; }
+
+    Track &Get(uint32_t mt)
+    { return _tracks[mt]; }
+
+    const Track &Get(uint32_t mt) const
+    { return _tracks[mt]; }
+
+    // Length of the free MT at the required time
+    real LengthAt(uint32_t mt, MTState::Type state, double time) const;
+
+    // Writes the current lengths of free MTs to the cell
+    void Materialize(Cell &cell) const;
+
+    // True, if kinetics, poles and the number of chromosomes are the same as in 'Reset()'
+    bool IsActual(const Cell &cell, const ChromosomeGeometry &cg, const Kinetics &kinetics) const;
+
+    // Moves bounding capsules of chromosomes that have left them, returns indices of such chromosomes
+    void Update(const ChromosomeGeometry &cg, std::vector<int> &moved);
+
+    // Remembers geometry and kinetics, clears the queue and the list of near MTs
+    // Tracks are kept, they must be re-anchored by the caller
+    void Reset(const Cell &cell, const ChromosomeGeometry &cg, const Kinetics &kinetics);
+
+    const Kinetics &GetKinetics() const
+    { return _kinetics; }
+
+    // Length at which the ray from the pole touches the cell's boundary, infinity if the pole is outside
+    real BoundaryLength(const vec3r &beg, const vec3r &dir) const;
+
+    // Length at which the ray enters some of the bounding capsules (zero if it starts inside), infinity if it doesn't
+    // Capsules are extended by margin, so they stay valid while their axes move less than margin
+    real NearLength(const vec3r &beg, const vec3r &dir, std::vector<int> &candidates) const;
+
+    // The same for the single bounding capsule
+    real NearLength(const vec3r &beg, const vec3r &dir, int chromosome) const;
+
+    // Adds the entry with the current version of MT
+    void Push(uint32_t mt, double time);
+
+    // Extracts the earliest actual entry that is not later than 'until'
+    bool Pop(double until, uint32_t &mt, double &time);
+
+    // MTs that are checked against chromosomes on each step, may contain MTs that are not near anymore
+    std::vector<uint32_t> &Near()
+    { return _near; }
+
+  private:
+    struct Entry
+    {
+      double time;
+      uint32_t mt;
+      uint32_t version;
+
+      // Reversed order for the min-heap, ties are resolved by MTs to keep the order deterministic
+      bool operator <(const Entry &e) const
+      { return time > e.time || (time == e.time && mt > e.mt); }
+    };
+
+    bool _valid;
+    double _time;
+    Kinetics _kinetics;
+    std::vector<Track> _tracks;
+    std::vector<Entry> _queue;
+    std::vector<uint32_t> _near;
+
+    void BuildCapsules();
+
+    // Geometry at the moment of the last 'Reset()' or 'Update()'
+    vec3r _poles[2];
+    std::vector<vec3r> _begs, _ends;
+    real _radius;
+    real _margin;
+    CapsuleGrid _capsules;
+};
@@ -2,21 +2,74 @@
 
 #include "MiCoSi.Core/SimParams.h"
 #include "MiCoSi.Objects/Cell.h"
+#include "MiCoSi.Objects/CellOps.h"
+
+namespace
+{
+
+// Multi-rate steps must not change the model, so they are rejected if the approximations of steps break down
+// Parameters are checked once, when the simulator is created, so the run cannot fail in the middle
+void CheckStepSizes(const SimParamsSnapshot &params)
+{
+  const int substeps = params[SimParameter::Int::Micro_Substeps];
+  const int period = params[SimParameter::Int::Macro_Period];
+  if (substeps == 1 && period == 1)
+  { return; }
+  real microDt = (real)(params.Exact(SimParameter::Double::Dt) / substeps);
+  real macroDt = (real)(params.Exact(SimParameter::Double::Dt) * period);
+
+  // Micro step samples events with probabilities 'rate * dt', they must stay probabilities
+  real maxRate = std::max(std::max(params[SimParameter::Double::F_Cat], params[SimParameter::Double::F_Res]),
+                          std::max(params[SimParameter::Double::K_On], params[SimParameter::Double::K_Off]));
+  if (maxRate * microDt > 1)
+  { throw std::runtime_error("micro time step is too large for the rates of MT events, increase 'micro_substeps'"); }
+
+  // Random displacement of chromosomes during one macro step must be less than the size of kinetochore,
+  // otherwise chromosomes may jump over MTs between the steps
+  real trans = std::sqrt(2 * params[SimParameter::Double::D_Trans] * macroDt);
+  real rot = std::sqrt(2 * params[SimParameter::Double::D_Rot] * macroDt) * params[SimParameter::Double::Cr_L] / 2;
+  if (std::max(trans, rot) > params[SimParameter::Double::Cr_Kin_D])
+  { throw std::runtime_error("macro time step is too large for the diffusion of chromosomes, decrease 'macro_period'"); }
+}
+
+} // unnamed namespace
 
 //-----------------
 //--- Simulator ---
 //-----------------
 
-void Simulator::Init(std::vector<std::unique_ptr<CellWithRng> > &cells, double startTime)
+void Simulator::Init(std::vector<std::unique_ptr<CellWithRng> > &cells, const std::vector<double> &times)
 {
   if (cells.size() == 0)
   { throw std::runtime_error("cannot initialize solver without cells"); }
-  
+  if (times.size() != cells.size())
+  { throw std::runtime_error("internal error, wrong number of cell times"); }
+
+  const double startTime = *std::max_element(times.begin(), times.end());
   _cellCount = cells.size();
   _time = startTime;
+  _macroTime = startTime;
   _statsAreValid = false;
+  _retirement.assign(_cellCount, -1.0);
+  _released.clear();
+
+  SimParamsSnapshot params = GlobalSimParams::GetRef()->Snapshot();
+  CheckStepSizes(params);
+
+  // Cells that are behind the others were retired by the previous run at their own time
+  for (size_t i = 0; i < _cellCount; i++)
+  {
+    if (std::abs(times[i] - startTime) < 1e-6)
+    { continue; }
+    if (params[SimParameter::Int::Stop_Condition] == 0)
+    { throw std::runtime_error("cannot process cells with different times simultanoiusly, 'stop_condition' is not set"); }
+    _retirement[i] = times[i];
+  }
 
   Import(cells);
+
+  // Continued simulations may contain cells that were retired by the previous run
+  RetireCells(startTime, params);
 }
 
 const std::vector<std::unique_ptr<CellWithRng> > &Simulator::Cells()
@@ -45,9 +98,45 @@ const std::vector<CellStats> &Simulator::Stats()
 
 bool Simulator::IsFinished()
 {
-  double cur = Time();
+  return IsFinished(Time()) || ActiveCellCount() == 0;
+}
+
+bool Simulator::IsFinished(double time)
+{
   double end = GlobalSimParams::GetRef()->GetParameter(SimParameter::Double::T_End, true);
-  return cur >= end || std::abs(cur - end) < 1e-6;
+  return time >= end || std::abs(time - end) < 1e-6;
+}
+
+size_t Simulator::ActiveCellCount() const
+{
+  size_t res = 0;
+  for (size_t i = 0; i < _retirement.size(); i++)
+  { res += IsRetired(i) ? 0 : 1; }
+  return res;
+}
+
+std::unique_ptr<CellWithRng> Simulator::Release(size_t cell)
+{
+  if (!IsRetired(cell) || IsReleased(cell))
+  { throw std::runtime_error("internal error: only retired cells can be released, and only once"); }
+
+  auto res = DetachCell(cell);
+  _released.emplace(cell, CellStats::Create(&res->CellObject()));
+  _statsAreValid = false;
+  return res;
+}
+
+bool Simulator::TryRetire(size_t cell, const Cell &obj, const SimParamsSnapshot &params, double time)
+{
+  int condition = params[SimParameter::Int::Stop_Condition];
+  if (condition == 0 || IsRetired(cell))
+  { return IsRetired(cell); }
+
+  bool stop = ((condition & StopOnBrokenSprings) != 0 && obj.AreSpringsBroken()) ||
+              ((condition & StopOnAmphitelic) != 0 && CellOps(&obj).AreAllAmphitelic());
+  if (stop)
+  { _retirement[cell] = time; }
+  return stop;
 }
 
 void Simulator::DoIteration()
@@ -55,13 +144,64 @@ void Simulator::DoIteration()
   if (IsFinished())
   { throw std::runtime_error("internal error: simulation is finished and new iteration cannot be done"); }
 
-  IterationStarted();
-  DoPoleUpdatingStep(Time());
-  DoMacroStep(Time());
-  DoMicroStep(Time());
-  DoSpringBreakingStep(Time());
-  IterationFinished();
+  DoIterations(1);
+}
+
+void Simulator::DoIterations(int count)
+{
+  if (ActiveCellCount() == 0)
+  { return; }
 
-  _time += GlobalSimParams::GetRef()->GetParameter(SimParameter::Double::Dt, true);
-  _statsAreValid = false;
+  StepParams params;
+  params.common = GlobalSimParams::GetRef()->Snapshot();
+  params.dt = GlobalSimParams::GetRef()->GetParameter(SimParameter::Double::Dt, true);
+  params.substeps = params.common[SimParameter::Int::Micro_Substeps];
+  const int period = params.common[SimParameter::Int::Macro_Period];
+
+  // Snapshots with the time steps of the corresponding rates, by default they are the same
+  params.micro = params.common;
+  params.macro = params.common;
+  if (params.substeps != 1 || period != 1)
+  {
+    params.micro.exact[SimParameter::Double::Dt] = params.dt / params.substeps;
+    params.macro.exact[SimParameter::Double::Dt] = params.dt * period;
+    params.micro.doubles[SimParameter::Double::Dt] = (real)params.micro.exact[SimParameter::Double::Dt];
+    params.macro.doubles[SimParameter::Double::Dt] = (real)params.macro.exact[SimParameter::Double::Dt];
+  }
+
+  // Macro step covers the next 'period' iterations, the tolerance hides rounding errors of time
+  std::vector<IterationPlan> plans;
+  double time = Time();
+  for (int i = 0; i < count && !IsFinished(time); i++)
+  {
+    IterationPlan plan = { time, time >= _macroTime - params.dt * 1e-3 };
+    if (plan.macro)
+    { _macroTime = time + params.dt * period; }
+    plans.push_back(plan);
+    time += params.dt;
+  }
+
+  if (!plans.empty())
+  {
+    DoIterationBatch(params, plans);
+    _time = time;
+    _statsAreValid = false;
+  }
+}
+
+void Simulator::DoIterationBatch(const StepParams &params, const std::vector<IterationPlan> &plans)
+{
+  for (size_t k = 0; k < plans.size(); k++)
+  {
+    const IterationPlan &plan = plans[k];
+    IterationStarted();
+    DoPoleUpdatingStep(plan.time, params.common);
+    if (plan.macro)
+    { DoMacroStep(plan.time, params.macro); }
+    for (int i = 0; i < params.substeps; i++)
+    { DoMicroStep(plan.time + params.dt * i / params.substeps, params.micro); }
+    DoSpringBreakingStep(plan.time, params.common);
+    IterationFinished();
+    RetireCells(plan.time + params.dt, params.common);
+  }
 }
@@ -2,6 +2,7 @@
 #include "MiCoSi.Core/Defs.h"
 
 #include "MiCoSi.Core/Random.h"
+#include "MiCoSi.Core/SimParams.h"
 #include "CellStats.h"
 #include "CellWithRng.h"
 
@@ -14,9 +15,17 @@ class Simulator : public ICellStatsProvider
   public:
     typedef std::vector<std::unique_ptr<CellWithRng> > CellEnsemble;
 
+    // Bits of 'Stop_Condition', the cell is retired when any of the selected conditions holds
+    enum StopCondition
+    {
+      StopOnBrokenSprings = 1,
+      StopOnAmphitelic    = 2
+    };
+
     // Packs all data into cells and returns their objects paired with RNG
     // This operation may be slow, so don't call it without need
     // The returned instances may be updated (or be not) by 'DoIteration()'
+    // Entries of the released cells are empty
     const CellEnsemble &Cells();
 
     // Returns count of the concurrent cells
@@ -31,32 +40,92 @@ class Simulator : public ICellStatsProvider
     inline double Time() const
     { return _time; }
 
-    // True, if simlation is finished
+    // True, if simlation is finished or all cells are retired
     bool IsFinished();
 
+    // True, if the cell has met 'Stop_Condition' and isn't simulated anymore
+    // Conditions are checked after each iteration, the retired cells keep their last state
+    inline bool IsRetired(size_t cell) const
+    { return _retirement[cell] >= 0.0; }
+
+    // Time of the iteration's end at which the cell was retired
+    inline double RetirementTime(size_t cell) const
+    { return _retirement[cell]; }
+
+    // Count of cells that are still simulated
+    size_t ActiveCellCount() const;
+
+    // Detaches the retired cell from the simulator and returns it, e.g. to save its final state
+    // Statistics of the cell are kept, so 'Stats()' still covers the whole ensemble
+    std::unique_ptr<CellWithRng> Release(size_t cell);
+
+    inline bool IsReleased(size_t cell) const
+    { return _released.find(cell) != _released.end(); }
+
     // Does one iteration with predefined time step (according to GlobalSimParams)
+    // Parameters are copied once, all steps of the iteration use the same snapshot
+    // Micro dynamics may be substepped ('Micro_Substeps') and the macro step may cover
+    // several iterations ('Macro_Period'), in these cases only the time step of snapshot differs
     void DoIteration();
 
+    // Does up to 'count' iterations at once, stops earlier if simulation is finished
+    // All iterations use the same snapshot, so parameters must not be changed by the caller between them
+    // Simulators may run the whole batch without synchronization between iterations
+    void DoIterations(int count);
+
     virtual ~Simulator() = default;
 
   protected:
-    Simulator() : _cellCount(0), _statsAreValid(false), _time(0.0)
+    // Snapshots for the steps of different rates and the common one
+    struct StepParams
+    {
+      SimParamsSnapshot common, macro, micro;
+      double dt;
+      int substeps;
+    };
+
+    // Steps of one iteration that are planned by 'DoIterations()'
+    struct IterationPlan
+    {
+      double time;
+      bool macro;     // false, if the macro step of some previous iteration covers this one
+    };
+
+    Simulator() : _cellCount(0), _statsAreValid(false), _time(0.0), _macroTime(0.0)
     { /*nothing*/ }
 
+    // Runs the planned iterations step by step, simulators may override it to avoid synchronization
+    virtual void DoIterationBatch(const StepParams &params, const std::vector<IterationPlan> &plans);
+
     virtual void Import(CellEnsemble &cells) = 0;
 
     virtual void IterationStarted() { }
 
-    virtual void DoMacroStep(double time) = 0;
+    virtual void DoMacroStep(double time, const SimParamsSnapshot &params) = 0;
 
-    virtual void DoMicroStep(double time) = 0;
+    virtual void DoMicroStep(double time, const SimParamsSnapshot &params) = 0;
 
-    virtual void DoPoleUpdatingStep(double time) = 0;
+    virtual void DoPoleUpdatingStep(double time, const SimParamsSnapshot &params) = 0;
 
-    virtual void DoSpringBreakingStep(double time) = 0;
+    virtual void DoSpringBreakingStep(double time, const SimParamsSnapshot &params) = 0;
 
     virtual void IterationFinished() { }
 
+    // Checks 'Stop_Condition' for all active cells after the iteration that ends at 'time'
+    // Simulators that don't support retirement keep all cells running
+    virtual void RetireCells(double time, const SimParamsSnapshot &params) { }
+
+    // Retires the cell if it meets 'Stop_Condition', returns true if the cell is retired
+    // May be called concurrently for different cells
+    bool TryRetire(size_t cell, const Cell &obj, const SimParamsSnapshot &params, double time);
+
+    // Statistics of the cell at the moment of its release
+    inline const CellStats &ReleasedStats(size_t cell) const
+    { return _released.at(cell); }
+
+    // Removes the retired cell from the simulator, its entry of 'SynchronizeCells()' becomes empty
+    virtual std::unique_ptr<CellWithRng> DetachCell(size_t cell) = 0;
+
     virtual const CellEnsemble &SynchronizeCells() = 0;
 
     virtual void FormatStats(std::vector<CellStats> &stats) = 0;
@@ -66,13 +135,20 @@ class Simulator : public ICellStatsProvider
     Simulator &operator =(const Simulator &) = delete;
 
     // To be used by SimulatorFactory
-    void Init(CellEnsemble &cells, double startTime);
+    // The simulation continues from the latest time, cells with earlier times are considered as retired
+    void Init(CellEnsemble &cells, const std::vector<double> &times);
+
+    bool IsFinished(double time);
 
     size_t _cellCount;
     std::vector<CellStats> _stats;
     bool _statsAreValid;
 
     double _time;
+    double _macroTime;    // the macro state is integrated up to this time
+
+    std::vector<double> _retirement;          // time of retirement per cell, negative for the active ones
+    std::map<size_t, CellStats> _released;
 
   friend class SimulatorFactory;
 };
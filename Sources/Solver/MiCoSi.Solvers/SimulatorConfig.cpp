@@ -4,6 +4,8 @@ namespace
 {
 constexpr const char *CPU_STR = "cpu";
 constexpr const char *CUDA_STR = "cuda";
+constexpr const char *CPU_INTRA_STR = "cpu-intra";
+constexpr const char *CPU_TASKS_STR = "cpu-tasks";
 }
 
 //-----------------------
@@ -31,11 +33,19 @@ SimulatorConfig SimulatorConfig::Parse(const std::string &str)
     deviceType = str;
   }
 
-  if (deviceType != CPU_STR && deviceType != CUDA_STR)
+  SimulatorType type;
+  if (deviceType == CPU_STR)
+  { type = SimulatorConfig::CPU; }
+  else if (deviceType == CUDA_STR)
+  { type = SimulatorConfig::CUDA; }
+  else if (deviceType == CPU_INTRA_STR)
+  { type = SimulatorConfig::CPU_INTRA; }
+  else if (deviceType == CPU_TASKS_STR)
+  { type = SimulatorConfig::CPU_TASKS; }
+  else
   { throw std::runtime_error("wrong config string, unknown solver"); }
 
-  return SimulatorConfig(deviceType == CPU_STR ? SimulatorConfig::CPU : SimulatorConfig::CUDA,
-                         deviceNumber);
+  return SimulatorConfig(type, deviceNumber);
 }
 
 std::string SimulatorConfig::Serialize(SimulatorConfig config)
@@ -46,6 +56,10 @@ std::string SimulatorConfig::Serialize(SimulatorConfig config)
   { res << CPU_STR; }
   else if (config.Type() == SimulatorConfig::CUDA)
   { res << CUDA_STR; }
+  else if (config.Type() == SimulatorConfig::CPU_INTRA)
+  { res << CPU_INTRA_STR; }
+  else if (config.Type() == SimulatorConfig::CPU_TASKS)
+  { res << CPU_TASKS_STR; }
   else
   { throw std::runtime_error("internal error, wrong simulator type"); }
 
@@ -9,13 +9,19 @@ class SimulatorConfig
     {
       CPU        = 1,
       CUDA       = 2,
+      CPU_INTRA  = 3,     // CPU version that also splits each cell between threads
+      CPU_TASKS  = 4,     // CPU version that runs all steps of each cell as one task, threads take tasks dynamically
     };
 
     SimulatorConfig()
-    { _type = Default()._type; _devNumber = Default()._devNumber; }
+    {
+      _type = Default()._type; _devNumber = Default()._devNumber;
+      _deterministic = false; _pinThreads = false; _firstTouch = false;
+    }
 
-    SimulatorConfig(SimulatorType type, int deviceNumber = -1)
-      : _type(type), _devNumber(std::max(-1, deviceNumber))
+    SimulatorConfig(SimulatorType type, int deviceNumber = -1, bool deterministic = false)
+      : _type(type), _devNumber(std::max(-1, deviceNumber)), _deterministic(deterministic),
+        _pinThreads(false), _firstTouch(false)
     { /*nothing*/ }
 
     SimulatorConfig(const SimulatorConfig &) = default;
@@ -27,6 +33,28 @@ class SimulatorConfig
     inline bool HasDeviceNumber(int &number) const
     { number = _devNumber; return _devNumber >= 0; }
 
+    // If true, results are bitwise identical for all CPU solvers and any count of threads
+    // The flag is not a part of the serialized string, it's set by the separate option
+    inline bool IsDeterministic() const
+    { return _deterministic; }
+
+    inline void SetDeterministic(bool value)
+    { _deterministic = value; }
+
+    // If true, threads of CPU solvers are bound to processors and keep their cells
+    inline bool PinThreads() const
+    { return _pinThreads; }
+
+    inline void SetPinThreads(bool value)
+    { _pinThreads = value; }
+
+    // If true, data of each cell is copied by the thread that owns it, so it lands on the thread's NUMA node
+    inline bool FirstTouch() const
+    { return _firstTouch; }
+
+    inline void SetFirstTouch(bool value)
+    { _firstTouch = value; }
+
     static SimulatorConfig Parse(const std::string &str);
 
     static std::string Serialize(SimulatorConfig config);
@@ -36,4 +64,7 @@ class SimulatorConfig
   private:
     SimulatorType _type;
     int _devNumber;
+    bool _deterministic;
+    bool _pinThreads;
+    bool _firstTouch;
 };
@@ -17,20 +17,29 @@
 //------------------------
 
 std::unique_ptr<Simulator> SimulatorFactory::CreateInternal(Simulator::CellEnsemble &cells,
-                                                            double startTime, IPoleUpdater &poles,
+                                                            const std::vector<double> &times, IPoleUpdater &poles,
                                                             const SimulatorConfig &config)
 {
   std::unique_ptr<Simulator> res;
 
-  if (config.Type() == SimulatorConfig::CPU)
+  if (config.Type() == SimulatorConfig::CPU || config.Type() == SimulatorConfig::CPU_INTRA ||
+      config.Type() == SimulatorConfig::CPU_TASKS)
   {
     int cores = 0;
     if (!config.HasDeviceNumber(cores))
     { cores = 0; }
-    res.reset(new CpuSimulator(poles, (size_t)cores));
+    CpuSimulator::Mode mode = config.Type() == SimulatorConfig::CPU_INTRA ? CpuSimulator::IntraCell :
+                              config.Type() == SimulatorConfig::CPU_TASKS ? CpuSimulator::CellTasks :
+                                                                            CpuSimulator::CellSteps;
+    CpuSimulator *cpu = new CpuSimulator(poles, (size_t)cores, mode, config.IsDeterministic());
+    res.reset(cpu);
+    cpu->SetPlacement(config.PinThreads(), config.FirstTouch());
   }
   else if (config.Type() == SimulatorConfig::CUDA)
   {
+    if (config.IsDeterministic())
+    { throw std::runtime_error("deterministic mode is supported only by CPU solvers"); }
+
 #ifndef NO_CUDA
     res = new CudaSimulator(poles);
     //res = new CudaSimulator2(poles);
@@ -43,7 +52,7 @@ std::unique_ptr<Simulator> SimulatorFactory::CreateInternal(Simulator::CellEnsem
     throw std::runtime_error("internal error, unknown enum value of 'config.Type()'");
   }
 
-  res->Init(cells, startTime);    
+  res->Init(cells, times);
   return res;
 }
 
@@ -66,7 +75,7 @@ std::unique_ptr<Simulator>SimulatorFactory::Create(const std::vector<Random::Sta
     cells[i] = std::make_unique<CellWithRng>(cellInitializer, poleUpdater, states[i]);
   }
 
-  return CreateInternal(cells, 0.0, *poleUpdater, config);
+  return CreateInternal(cells, std::vector<double>(cells.size(), 0.0), *poleUpdater, config);
 }
 
 std::unique_ptr<Simulator>
@@ -74,6 +83,15 @@ std::unique_ptr<Simulator>
                            double startTime,
                            IPoleUpdater *poleUpdater,
                            SimulatorConfig config)
+{
+  return Create(cells, std::vector<double>(cells.size(), startTime), poleUpdater, config);
+}
+
+std::unique_ptr<Simulator>
+  SimulatorFactory::Create(const std::vector<std::pair<const Cell *, Random::State> > &cells,
+                           const std::vector<double> &times,
+                           IPoleUpdater *poleUpdater,
+                           SimulatorConfig config)
 {
   std::unique_ptr<IPoleUpdater> poleUpdater_;
   if (poleUpdater == nullptr)
@@ -85,5 +103,5 @@ std::unique_ptr<Simulator>
     cellsWithRng[i] = std::make_unique<CellWithRng>(*cells[i].first, cells[i].second);
   }
 
-  return CreateInternal(cellsWithRng, startTime, *poleUpdater, config);
+  return CreateInternal(cellsWithRng, times, *poleUpdater, config);
 }
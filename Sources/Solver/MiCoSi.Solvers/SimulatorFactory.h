@@ -26,9 +26,17 @@ class SimulatorFactory
              IPoleUpdater *poleUpdater = nullptr,
              SimulatorConfig config = SimulatorConfig::Default());
 
+    // Continues the simulation of cells with their own times, e.g. of a partly retired series
+    // The simulator starts from the latest time, the cells that are behind it were retired at their times
+    static std::unique_ptr<Simulator>
+      Create(const std::vector<std::pair<const Cell *, Random::State> > &cells,
+             const std::vector<double> &times,
+             IPoleUpdater *poleUpdater = nullptr,
+             SimulatorConfig config = SimulatorConfig::Default());
+
   private:
     static std::unique_ptr<Simulator>
       CreateInternal(Simulator::CellEnsemble &cells,
-                     double startTime, IPoleUpdater &poles,
+                     const std::vector<double> &times, IPoleUpdater &poles,
                      const SimulatorConfig &config);
 };
@@ -1,7 +1,9 @@
 #pragma once
 
+#include "AsyncWriter.h"
 #include "Chunk.h"
 #include "ChunkHeader.h"
 #include "FileContainer.h"
 #include "FileExplorer.h"
+#include "MappedFile.h"
 #include "TimeStream.h"
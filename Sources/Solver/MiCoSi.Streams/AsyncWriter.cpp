@@ -0,0 +1,147 @@
+#include "AsyncWriter.h"
+
+//-------------------
+//--- AsyncWriter ---
+//-------------------
+
+AsyncWriter::AsyncWriter(const std::vector<TimeStream *> &streams, size_t threads, size_t snapshotsPerStream)
+  : _queues(streams.size()), _snapshotsPerStream(std::max((size_t)1, snapshotsPerStream)),
+    _pendingCount(0), _stop(false)
+{
+  for (size_t i = 0; i < streams.size(); i++)
+  {
+    _queues[i].stream = streams[i];
+    _queues[i].created = 0;
+    _queues[i].busy = false;
+  }
+
+  // More writers than streams cannot be used, because each stream is written by one thread at once
+  threads = std::max((size_t)1, std::min(threads, streams.size()));
+  for (size_t i = 0; i < threads; i++)
+  { _threads.emplace_back(&AsyncWriter::WriterLoop, this); }
+}
+
+AsyncWriter::~AsyncWriter()
+{
+  {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _isIdle.wait(lock, [this] { return _pendingCount == 0; });
+    _stop = true;
+  }
+  _hasWork.notify_all();
+  for (auto &thread : _threads)
+  { thread.join(); }
+}
+
+void AsyncWriter::Append(size_t stream, const Cell &cell, double time, const Random::State &rng)
+{
+  if (stream >= _queues.size())
+  { throw std::runtime_error("internal error: wrong index of time stream"); }
+  StreamQueue &queue = _queues[stream];
+
+  // Back-pressure: the caller waits if all snapshots of the stream are still pending
+  std::unique_ptr<Snapshot> snapshot;
+  {
+    std::unique_lock<std::mutex> lock(_mutex);
+    RethrowError();
+    _hasSpace.wait(lock, [&] {
+      return !queue.pool.empty() || queue.created < _snapshotsPerStream || _error != nullptr;
+    });
+    RethrowError();
+    if (!queue.pool.empty())
+    {
+      snapshot = std::move(queue.pool.back());
+      queue.pool.pop_back();
+    }
+    else
+    { queue.created++; }
+  }
+
+  // Snapshot is owned by the caller now, so the copy is done without locking
+  const CellData &src = cell.Data();
+  if (snapshot == nullptr)
+  {
+    snapshot.reset(new Snapshot());
+    snapshot->cell.reset(cell.CloneTemplated<Cell>());
+  }
+  else
+  {
+    const CellData &dst = snapshot->cell->Data();
+    if (dst.DataSize() != src.DataSize())
+    { throw std::runtime_error("internal error: configuration of the cell was changed"); }
+    memcpy(dst.DataPointer(), src.DataPointer(), src.DataSize());
+    snapshot->cell->GeometryCache().Invalidate();
+  }
+  snapshot->time = time;
+  snapshot->rng = rng;
+
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    queue.pending.push_back(std::move(snapshot));
+    _pendingCount++;
+    if (!queue.busy && queue.pending.size() == 1)
+    { Schedule(stream); }
+  }
+}
+
+void AsyncWriter::Wait()
+{
+  std::unique_lock<std::mutex> lock(_mutex);
+  _isIdle.wait(lock, [this] { return _pendingCount == 0; });
+  RethrowError();
+}
+
+void AsyncWriter::Schedule(size_t stream)
+{
+  _ready.push_back(stream);
+  _hasWork.notify_one();
+}
+
+void AsyncWriter::RethrowError()
+{
+  if (_error != nullptr)
+  { std::rethrow_exception(_error); }
+}
+
+void AsyncWriter::WriterLoop()
+{
+  std::unique_lock<std::mutex> lock(_mutex);
+  while (true)
+  {
+    _hasWork.wait(lock, [this] { return _stop || !_ready.empty(); });
+    if (_ready.empty())
+    { return; }
+
+    size_t stream = _ready.front();
+    _ready.pop_front();
+    StreamQueue &queue = _queues[stream];
+    std::unique_ptr<Snapshot> snapshot = std::move(queue.pending.front());
+    queue.pending.pop_front();
+    queue.busy = true;
+    bool failed = _error != nullptr;
+
+    // Encoding and I/O are done without locking, the stream is not touched by other writers
+    lock.unlock();
+    std::exception_ptr error;
+    if (!failed)
+    {
+      try
+      { queue.stream->Append(*snapshot->cell, snapshot->time, snapshot->rng); }
+      catch (...)
+      { error = std::current_exception(); }
+    }
+    lock.lock();
+
+    // After the first error, layers are dropped - the file must not have gaps
+    if (error != nullptr && _error == nullptr)
+    { _error = error; }
+    queue.busy = false;
+    queue.pool.push_back(std::move(snapshot));
+    if (!queue.pending.empty())
+    { Schedule(stream); }
+    _pendingCount--;
+    _hasSpace.notify_all();
+    if (_pendingCount == 0)
+    { _isIdle.notify_all(); }
+  }
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include "MiCoSi.Core/Defs.h"
+
+#include "TimeStream.h"
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+// Appends time layers to the streams by background threads, so the simulation doesn't wait for I/O
+// The caller only copies the cell's data into a pooled snapshot, writers encode and append it later
+// Layers of each stream keep their order, different streams are written in parallel
+class AsyncWriter
+{
+  public:
+    AsyncWriter() = delete;
+    AsyncWriter(const AsyncWriter &) = delete;
+    AsyncWriter &operator =(const AsyncWriter &) = delete;
+
+    // Streams must outlive the writer
+    // Each stream has up to 'snapshotsPerStream' pending layers, 'Append()' waits for the free one
+    AsyncWriter(const std::vector<TimeStream *> &streams, size_t threads, size_t snapshotsPerStream = 2);
+
+    // Waits for the pending layers, errors are ignored (call 'Wait()' to get them)
+    ~AsyncWriter();
+
+    // Takes a snapshot of the cell and returns, the layer is appended to the stream later
+    // Rethrows an error of the previous writes, if any
+    void Append(size_t stream, const Cell &cell, double time, const Random::State &rng);
+
+    // Waits until all pending layers are appended, rethrows the first error of writers
+    void Wait();
+
+  private:
+    struct Snapshot
+    {
+      std::unique_ptr<Cell> cell;
+      double time;
+      Random::State rng;
+    };
+
+    struct StreamQueue
+    {
+      TimeStream *stream;
+      std::deque<std::unique_ptr<Snapshot> > pending;
+      std::vector<std::unique_ptr<Snapshot> > pool;
+      size_t created;
+      bool busy;        // some writer appends its layer, so the others must not touch it
+    };
+
+    void WriterLoop();
+    void Schedule(size_t stream);
+    void RethrowError();
+
+    std::vector<StreamQueue> _queues;
+    std::deque<size_t> _ready;    // streams with pending layers and without a writer
+    size_t _snapshotsPerStream;
+    size_t _pendingCount;
+    bool _stop;
+    std::exception_ptr _error;
+
+    std::mutex _mutex;
+    std::condition_variable _hasWork, _hasSpace, _isIdle;
+    std::vector<std::thread> _threads;
+};
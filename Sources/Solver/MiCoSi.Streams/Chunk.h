@@ -2,6 +2,7 @@
 #include "MiCoSi.Core/Defs.h"
 
 #include "ChunkHeader.h"
+#include "MappedFile.h"
 
 class FileContainer;
 
@@ -17,26 +18,38 @@ class Chunk
     { return _header; }
 
     // Non-parsed meta data. Size can acquired from Header.
+    // Data of the mapped chunks is read-only
     void *MetaDataPointer() const
-    { return _metaData.get(); }
+    { return _metaData; }
 
     // Non-parsed binary data. Size can acquired from Header.
     void *BinDataPointer() const
-    { return _binData.get(); }
+    { return _binData; }
 
     ~Chunk() { /*nothing*/ }
 
   private:
+    // Chunk with its own buffers, they are filled by 'FileContainer'
     Chunk(const ChunkHeader &header)
       : _header(header)
     {
-      _metaData.reset(new uint8_t[(size_t)Header().MetaDataSize()]);
-      _binData.reset(new uint8_t[(size_t)Header().BinDataSize()]);
+      _storage.reset(new uint8_t[(size_t)(Header().MetaDataSize() + Header().BinDataSize())]);
+      _metaData = _storage.get();
+      _binData = _storage.get() + Header().MetaDataSize();
     }
 
+    // View of the mapped file, nothing is copied
+    Chunk(const ChunkHeader &header, std::shared_ptr<MappedFile> file,
+          const uint8_t *metaData, const uint8_t *binData)
+      : _header(header), _file(file),
+        _metaData((uint8_t *)metaData), _binData((uint8_t *)binData)
+    { /*nothing*/ }
+
     ChunkHeader _header;
-    std::unique_ptr<uint8_t[]> _metaData;
-    std::unique_ptr<uint8_t[]> _binData;
+    std::unique_ptr<uint8_t[]> _storage;
+    std::shared_ptr<MappedFile> _file;
+    uint8_t *_metaData;
+    uint8_t *_binData;
 
   friend class FileContainer;
 };
@@ -4,6 +4,7 @@
 
 #ifdef _WIN32
 #include <io.h>
+#include <share.h>
 #else
 #include <unistd.h>
 #endif
@@ -371,6 +372,36 @@ size_t FileContainer::Formatter::LoadChunk(FILE *f, void *metaData, size_t metaD
   return size;
 }
 
+size_t FileContainer::Formatter::ViewChunk(const uint8_t *data, size_t available,
+                                           size_t metaDataSize, size_t binDataSize,
+                                           const uint8_t *&metaData, const uint8_t *&binData)
+{
+  size_t size = 0;
+
+  if(available > std::strlen("?frame") + sizeof(double) && memcmp(data, "?frame", std::strlen("?frame")) == 0)
+    size = std::strlen("?frame") + sizeof(double);
+  else if(available > std::strlen("?service") && memcmp(data, "?service", std::strlen("?service")) == 0)
+    size = std::strlen("?service");
+  else
+    throw std::runtime_error("Error at FileContainer::Formatter::ViewChunk() - bad type");
+
+  if(available - size < 2 * sizeof(uint64_t))
+    throw std::runtime_error("Error at FileContainer::Formatter::ViewChunk() - cannot read data sizes");
+  uint64_t _metaDataSize, _binDataSize;
+  memcpy(&_metaDataSize, data + size, sizeof(uint64_t));
+  memcpy(&_binDataSize, data + size + sizeof(uint64_t), sizeof(uint64_t));
+  size += 2 * sizeof(uint64_t);
+
+  if(_metaDataSize != metaDataSize || _binDataSize != binDataSize)
+    throw std::runtime_error("Error at FileContainer::Formatter::ViewChunk() - different data sizes");
+  if(metaDataSize > available - size || binDataSize > available - size - metaDataSize)
+    throw std::runtime_error("Error at FileContainer::Formatter::ViewChunk() - chunk is out of file");
+
+  metaData = data + size;
+  binData = data + size + metaDataSize;
+  return size + metaDataSize + binDataSize;
+}
+
 size_t FileContainer::Formatter::ReadTable(FILE *f, std::vector<ChunkHeader> &table)
 {
   size_t size = 0;
@@ -461,7 +492,9 @@ FILE *FileContainer::OpenFile(const std::string &filename, const char *opt)
   FILE *f = nullptr;
 
 #ifdef WIN32
-  if (fopen_s(&f, filename.c_str(), opt) != 0)
+  // 'fopen_s()' denies other handles, so the file couldn't be mapped while it's opened
+  f = _fsopen(filename.c_str(), opt, _SH_DENYNO);
+  if (f == nullptr)
   {
     std::stringstream ss;
     ss << "Error at FileContainer::OpenFile() - cannot open \"";
@@ -470,7 +503,7 @@ FILE *FileContainer::OpenFile(const std::string &filename, const char *opt)
     throw std::runtime_error(ss.str());
   }
 #else
-  f = fopen(filename, opt);
+  f = fopen(filename.c_str(), opt);
   if (f == nullptr)
   {
     std::stringstream ss;
@@ -502,6 +535,15 @@ std::shared_ptr<Chunk> FileContainer::LoadChunk(size_t chunkNumber)
     throw std::runtime_error("Error at FileContainer::LoadChunk() - no such chunk");
   
   auto header = _table[chunkNumber];
+  if (_mapping != nullptr && header.ChunkOffset() >= 0 && header.ChunkOffset() <= _mappedEnd &&
+      header.ChunkSize() <= (uint64_t)(_mappedEnd - header.ChunkOffset()))
+  {
+    const uint8_t *metaData = nullptr, *binData = nullptr;
+    Formatter::ViewChunk(_mapping->Data() + header.ChunkOffset(), (size_t)header.ChunkSize(),
+                         (size_t)header.MetaDataSize(), (size_t)header.BinDataSize(), metaData, binData);
+    return std::shared_ptr<Chunk>(new Chunk(header, _mapping, metaData, binData));
+  }
+
   std::shared_ptr<Chunk> res(new Chunk(header));
   if (_fseeki64(_file, header.ChunkOffset(), SEEK_SET) != 0)
     throw std::runtime_error("Error at FileContainer::LoadChunk() - failed to locate required chunk");
@@ -539,7 +581,13 @@ std::shared_ptr<FileContainer> FileContainer::Open(const std::string &filename)
     if (_fseeki64(f, offset, SEEK_SET) != 0)
       throw std::runtime_error("Error at FileContainer::Open() - failed to locate table position");
     Formatter::ReadTable(f, table);
-    return std::shared_ptr<FileContainer>(new FileContainer(f, offset, table, version, false));
+    std::shared_ptr<FileContainer> res(new FileContainer(f, offset, table, version, false));
+
+    // New chunks overwrite the table, so only the chunks before it are taken from the mapping
+    res->_mapping = MappedFile::Map(filename);
+    if (res->_mapping != nullptr)
+    { res->_mappedEnd = std::min(offset, (offset_t)res->_mapping->Size()); }
+    return res;
   }
   catch (std::exception &)
   {
@@ -3,6 +3,7 @@
 
 #include "MiCoSi.Objects/Cell.h"
 #include "Chunk.h"
+#include "MappedFile.h"
 
 typedef bool (*FrameExtractor)(const void *metaData, size_t metaDataSize,
                                const void *binData, size_t binDataSize, 
@@ -27,7 +28,12 @@ class FileContainer
     const uint64_t Version() const
     { return _version; }
 
+    // True, if the file was mapped to memory when it was opened
+    bool IsMapped() const
+    { return _mapping != nullptr; }
+
     // Loads and returns chunk with required index
+    // Chunks that existed when the file was opened are views of the mapped file, others are read
     std::shared_ptr<Chunk> LoadChunk(size_t chunkNumber);
 
     // Immediately appends and writes service chunk. Table will be rewritten by destructor
@@ -41,7 +47,7 @@ class FileContainer
 
     ~FileContainer();
 
-    // Tries to open file
+    // Tries to open file, it's also mapped to memory if the OS allows it
     // Throws exception in case of any error
     static std::shared_ptr<FileContainer> Open(const std::string &filename);
 
@@ -71,6 +77,8 @@ class FileContainer
         static size_t ReadHeader(FILE *f, uint64_t &version, offset_t &tableOffset);
         static size_t ScanChunk(FILE *f, ChunkType::Type &type, size_t &metaDataSize, size_t &binDataSize);
         static size_t LoadChunk(FILE *f, void *metaData, size_t metaDataSize, void *binData, size_t binDataSize);
+        static size_t ViewChunk(const uint8_t *data, size_t available, size_t metaDataSize, size_t binDataSize,
+                                const uint8_t *&metaData, const uint8_t *&binData);
         static size_t ReadTable(FILE *f, std::vector<ChunkHeader> &table);
     };
 
@@ -78,7 +86,7 @@ class FileContainer
                   const std::vector<ChunkHeader> &table,
                   uint64_t version, bool rewriteTable)
       : _file(file), _newChunkStart(newChunkStart),
-        _table(table), _version(version), _rewriteTable(rewriteTable)
+        _table(table), _version(version), _rewriteTable(rewriteTable), _mappedEnd(0)
     { /*nothing*/ }
 
     static FILE *OpenFile(const std::string &filename, const char *opt);
@@ -96,4 +104,8 @@ class FileContainer
     std::vector<ChunkHeader> _table;
     bool _rewriteTable;
     uint64_t _version;
+
+    // Chunks before '_mappedEnd' are loaded from '_mapping', the appended ones are not visible there
+    std::shared_ptr<MappedFile> _mapping;
+    offset_t _mappedEnd;
 };
@@ -6,7 +6,7 @@ FileExplorer::ChunkElement::ChunkElement(TiXmlElement* elem, void* data, uint64_
   {
     _data = malloc((size_t)sizeInBytes);
     memcpy(_data, data, (size_t)sizeInBytes);
-    _elem = (TiXmlElement*)elem->Clone();
+    _elem = elem != nullptr ? (TiXmlElement*)elem->Clone() : nullptr;
   } else
   {
     _data = data;
@@ -25,8 +25,11 @@ FileExplorer::ChunkElement::~ChunkElement()
   }
 }
 
-FileExplorer::WritingChunk::WritingChunk(std::shared_ptr<FileContainer> fc, size_t maxElemPerChunk)
+FileExplorer::WritingChunk::WritingChunk(std::shared_ptr<FileContainer> fc, size_t maxElemPerChunk, bool binary,
+                                         const IChunkCodec *codec)
 {
+  _binary = binary;
+  _codec = codec;
   _time = 0;
   _maxElemPerChunk = maxElemPerChunk;
   _currentIdx = 0;
@@ -40,7 +43,41 @@ FileExplorer::WritingChunk::WritingChunk(std::shared_ptr<FileContainer> fc, size
 
 void FileExplorer::WritingChunk::Flush()
 {
-  if(_currentIdx != 0)
+  if(_currentIdx != 0 && _binary && _codec != nullptr)
+  {
+    // Records of frames describe the decoded data, so the readers find frames in the same way
+    MemoryStream encoded;
+    _codec->Encode(_stream->GetBuffer(), _stream->Length(), _frames, encoded);
+    FrameFormat::ChunkDirectory dir = { FrameFormat::CODEC_CHUNK_MAGIC, (uint32_t)_currentIdx };
+    FrameFormat::ChunkCodecInfo info = { (uint32_t)_codec->Id(), 0, (uint64_t)_stream->Length() };
+    MemoryStream meta(sizeof(dir) + sizeof(info) + _frames.size() * sizeof(FrameFormat::FrameRecord));
+    meta.Write(&dir, sizeof(dir));
+    meta.Write(&info, sizeof(info));
+    meta.Write(&_frames[0], _frames.size() * sizeof(FrameFormat::FrameRecord));
+    _fc->AppendFrameChunk(_time, _currentIdx, meta.GetBuffer(), meta.Length(), encoded.GetBuffer(), encoded.Length());
+    _stream->Reset();
+    _frames.clear();
+    _currentIdx = 0;
+    for(auto p = _elements.begin(); p != _elements.end(); p++)
+      delete *p;
+    _elements.clear();
+  }
+  else if(_currentIdx != 0 && _binary)
+  {
+    // Directory of frames is the meta data, so nothing must be parsed to find them
+    FrameFormat::ChunkDirectory dir = { FrameFormat::CHUNK_MAGIC, (uint32_t)_currentIdx };
+    MemoryStream meta(sizeof(dir) + _frames.size() * sizeof(FrameFormat::FrameRecord));
+    meta.Write(&dir, sizeof(dir));
+    meta.Write(&_frames[0], _frames.size() * sizeof(FrameFormat::FrameRecord));
+    _fc->AppendFrameChunk(_time, _currentIdx, meta.GetBuffer(), meta.Length(), _stream->GetBuffer(), _stream->Length());
+    _stream->Reset();
+    _frames.clear();
+    _currentIdx = 0;
+    for(auto p = _elements.begin(); p != _elements.end(); p++)
+      delete *p;
+    _elements.clear();
+  }
+  else if(_currentIdx != 0)
   {
     _stream->Write(&_maxElemPerChunk, 0, sizeof(uint64_t));
     _stream->Write(_offsets, sizeof(uint64_t), (size_t)_maxElemPerChunk * sizeof(uint64_t));
@@ -62,6 +99,21 @@ void FileExplorer::WritingChunk::Add(TiXmlElement* elem, double time, MemoryStre
 {
   if(_currentIdx >= _maxElemPerChunk)
     throw std::runtime_error("Too many elements");
+  if(_binary)
+  {
+    // Frames are aligned, so their columns stay aligned in the loaded chunk
+    static uint8_t zeros[8] = { 0 };
+    if(_currentIdx == 0)
+      _time = time;
+    size_t padding = FrameFormat::Align(_stream->Length()) - _stream->Length();
+    if(padding > 0)
+      _stream->Write(zeros, padding);
+    FrameFormat::FrameRecord frame = { time, (uint64_t)_stream->Length(), (uint64_t)stream->Length() };
+    _stream->Write(stream);
+    _frames.push_back(frame);
+    _currentIdx++;
+    return;
+  }
   uint64_t offset;
   if(_currentIdx == 0)
   {
@@ -93,6 +145,12 @@ FileExplorer::ChunkElement* FileExplorer::WritingChunk::GetElement(size_t idx)
 {
   if(idx >= _currentIdx)
     throw std::runtime_error("Cannot get element");
+  if(_binary)
+  {
+    ChunkElement* elem = new ChunkElement(nullptr, (uint8_t*)_stream->GetBuffer() + _frames[idx].offset, _frames[idx].size);
+    _elements.push_back(elem);
+    return elem;
+  }
   TiXmlNode *n = _doc->RootElement()->FirstChild();
   for (size_t i = 0; i  < idx; i++)
     n = n->NextSibling();
@@ -114,6 +172,36 @@ FileExplorer::WritingChunk::~WritingChunk()
 
 void FileExplorer::ReadingChunk::LoadChunk(std::shared_ptr<Chunk> chunk)
 {
+  if(_binary)
+  {
+    std::vector<FrameFormat::FrameRecord> frames;
+    uint32_t codecId = 0;
+    uint64_t dataSize = 0;
+    if(!FrameFormat::ReadDirectory(chunk->MetaDataPointer(), (size_t)chunk->Header().MetaDataSize(),
+                                   (size_t)chunk->Header().BinDataSize(), frames, codecId, dataSize))
+      throw std::runtime_error("FileExplorer::ReadingChunk::LoadChunk - Corrupted directory of frames");
+    for(auto p = _elements.begin(); p != _elements.end(); p++)
+      delete *p;
+    _elements.clear();
+
+    // Chunks without encoding are used in place, others are decoded into the buffer
+    uint8_t* data = (uint8_t*)chunk->BinDataPointer();
+    if(codecId != IChunkCodec::None)
+    {
+      const IChunkCodec* codec = IChunkCodec::Get(codecId);
+      if(codec == nullptr)
+        throw std::runtime_error("FileExplorer::ReadingChunk::LoadChunk - Unknown codec of chunk");
+      _decoded.resize((size_t)dataSize);
+      data = _decoded.empty() ? nullptr : &_decoded[0];
+      codec->Decode(chunk->BinDataPointer(), (size_t)chunk->Header().BinDataSize(), frames, data, _decoded.size());
+    }
+    _chunk = chunk;
+    for(size_t i = 0; i < frames.size(); i++)
+      _elements.push_back(new ChunkElement(nullptr, data + frames[i].offset, frames[i].size));
+    _currentElemPerChunk = frames.size();
+    return;
+  }
+
   _chunk = chunk;
   _maxElemPerChunk = ((uint64_t*)_chunk->BinDataPointer())[0];
   if(_maxElemPerChunk <= 0)
@@ -130,7 +218,7 @@ void FileExplorer::ReadingChunk::LoadChunk(std::shared_ptr<Chunk> chunk)
     _doc->ClearError();
     _doc->Clear();
   }
-  std::string metaString((char*)chunk->MetaDataPointer());
+  std::string metaString((char*)chunk->MetaDataPointer(), (size_t)chunk->Header().MetaDataSize());
   std::stringstream ss(metaString);
   ss >> *_doc;
   if(_doc->Error())
@@ -180,6 +268,7 @@ FileExplorer::FileExplorer(const std::string &file)
 {
   _file = file;
   _fc.reset();
+  _binaryFrames = false;
   _configuration = nullptr;
   _writingChunk = nullptr;
   _readingChunk = nullptr;
@@ -233,7 +322,7 @@ FileExplorer::ChunkElement* FileExplorer::LoadService(size_t idx)
   {
     auto chunk = _fc->LoadChunk(idx);
     doc = new TiXmlDocument();
-    std::string metaString((char*)chunk->MetaDataPointer());
+    std::string metaString((char*)chunk->MetaDataPointer(), (size_t)chunk->Header().MetaDataSize());
     std::stringstream ss(metaString);
     ss >> *doc;
     if(doc->Error())
@@ -298,10 +387,12 @@ const std::pair<FileExplorer::ChunkElement*, FileExplorer::ChunkElement*> FileEx
   
   if(chunkNumber == _additional.size())
   {
+    // Layers that are not flushed yet belong to the latest sim params
     size_t size = _additional.size() - 1;
-    if(_additional[size].second-1 >= _simParams.size())
+    if(_simParams.size() == 0)
       throw std::runtime_error("FileExplorer::TimeLayer - sim params not found");
-    return std::make_pair(_writingChunk->GetElement(n - _additional[size].first), _simParams[_additional[size].second-1]);
+    return std::make_pair(_writingChunk->GetElement(n - _additional[size].first - _elementsPerChunk[size]),
+                          _simParams[_simParams.size() - 1]);
   }
 
   size_t chunkInTable = chunkNumber + 1 + _additional[chunkNumber].second;
@@ -346,11 +437,13 @@ void FileExplorer::Flush()
   if(_chunkIdx == 0)
     return;
   _writingChunk->Flush();
-  _elementsPerChunk.push_back(_chunkIdx);
   if(_simParams.size() == 0)
     throw std::runtime_error("Not found sim params");
-  size_t simNumber = _simParams.size() - 1;
-  size_t counts = _additional.size() == 0 ? 0 : _additional[_additional.size() - 1].first + _chunkIdx;
+  // Count of the preceding service chunks, like in 'ReadTable()'
+  size_t simNumber = _simParams.size();
+  // The new chunk follows all layers of the previous one, it can be incomplete (e.g. in continued files)
+  size_t counts = _additional.size() == 0 ? 0 : _additional[_additional.size() - 1].first + _elementsPerChunk[_elementsPerChunk.size() - 1];
+  _elementsPerChunk.push_back(_chunkIdx);
   _additional.push_back(std::make_pair(counts, simNumber));
   _chunkIdx = 0;
 }
@@ -370,15 +463,26 @@ FileExplorer::~FileExplorer()
   _fc.reset();
 }
 
-FileExplorer* FileExplorer::Create(const std::string &file, size_t elemPerChunk, uint64_t version)
+void FileExplorer::InitChunks(std::shared_ptr<FileContainer> fc, size_t elemPerChunk, IChunkCodec::Type codec)
+{
+  _fc = fc;
+  int fileFormat = std::get<2>(DeSerializer::DeserializeVersion(fc->Version()));
+  _binaryFrames = fileFormat >= FrameFormat::FIRST_FILE_FORMAT;
+  const IChunkCodec *chunkCodec = nullptr;
+  if(fileFormat >= FrameFormat::FIRST_CODEC_FILE_FORMAT && (chunkCodec = IChunkCodec::Get(codec)) == nullptr)
+    throw std::runtime_error("FileExplorer::InitChunks - Unknown codec");
+  _maxElemPerChunk = elemPerChunk;
+  _writingChunk = new FileExplorer::WritingChunk(fc, elemPerChunk, _binaryFrames, chunkCodec);
+  _readingChunk = new FileExplorer::ReadingChunk(_binaryFrames);
+}
+
+FileExplorer* FileExplorer::Create(const std::string &file, size_t elemPerChunk, uint64_t version,
+                                   IChunkCodec::Type codec)
 {
   auto fc = FileContainer::Create(file, version);
 
   FileExplorer *res = new FileExplorer(file);
-  res->_fc = fc;
-  res->_maxElemPerChunk = elemPerChunk;
-  res->_writingChunk = new FileExplorer::WritingChunk(fc, elemPerChunk);
-  res->_readingChunk = new FileExplorer::ReadingChunk();
+  res->InitChunks(fc, elemPerChunk, codec);
 
   return res;
 }
@@ -388,10 +492,7 @@ FileExplorer *FileExplorer::Open(const std::string &file, size_t elemPerChunk)
   auto fc = FileContainer::Open(file);
 
   FileExplorer *res = new FileExplorer(file);
-  res->_fc = fc;
-  res->_writingChunk = new FileExplorer::WritingChunk(fc, elemPerChunk);
-  res->_readingChunk = new FileExplorer::ReadingChunk();
-  res->_maxElemPerChunk = elemPerChunk;
+  res->InitChunks(fc, elemPerChunk, IChunkCodec::Delta);
   res->ReadTable();
 
   return res;
@@ -403,10 +504,7 @@ FileExplorer *FileExplorer::Repair(const std::string &file, FrameExtractor fextr
   auto fc = FileContainer::Repair(file, fextr, sextr, cextr);
 
   FileExplorer *res = new FileExplorer(file);
-  res->_fc = fc;
-  res->_writingChunk = new FileExplorer::WritingChunk(fc, elemPerChunk);
-  res->_readingChunk = new FileExplorer::ReadingChunk();
-  res->_maxElemPerChunk = elemPerChunk;
+  res->InitChunks(fc, elemPerChunk, IChunkCodec::Delta);
   res->ReadTable();
 
   return res;
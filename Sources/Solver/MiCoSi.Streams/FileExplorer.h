@@ -2,11 +2,15 @@
 #include "MiCoSi.Core/Defs.h"
 
 #include "MiCoSi.Formatters/DeSerializer.h"
+#include "MiCoSi.Formatters/FrameFormat.h"
+#include "MiCoSi.Formatters/ChunkCodec.h"
 #include "FileContainer.h"
 
 class FileExplorer
 {
   public:
+    // XML node and binary data of some record
+    // Binary frames of the newer file formats have no XML node (see 'BinaryFrames()')
     class ChunkElement
     {
       public:
@@ -35,6 +39,11 @@ class FileExplorer
     uint64_t Version()
     { return _fc->Version(); }
 
+    // True, if time layers are binary frames without XML nodes (see 'FrameFormat')
+    // Older files keep their own format, even if they are continued by the newer program
+    bool BinaryFrames() const
+    { return _binaryFrames; }
+
     // Returns node with static cell configuration
     ChunkElement* Configuration()
     { return _configuration; }
@@ -47,6 +56,7 @@ class FileExplorer
 
     void AppendServiceLayer(TiXmlElement* elem, MemoryStream* stream);
 
+    // The 'elem' node must be null for binary frames
     void AppendFrameLayer(double time, TiXmlElement* elem, MemoryStream* stream);
 
     void AppendCellConfiguration(TiXmlElement* elem, MemoryStream* stream);
@@ -57,9 +67,11 @@ class FileExplorer
     ~FileExplorer();
 
     // Creates new empty FileExplorer, that will override existant files
-    static FileExplorer *Create(const std::string &file, size_t elemPerChunk, uint64_t version);
+    // The codec is used by the file formats with encoded chunks only (see 'FrameFormat')
+    static FileExplorer *Create(const std::string &file, size_t elemPerChunk, uint64_t version,
+                                IChunkCodec::Type codec = IChunkCodec::Delta);
 
-    // Opens previously saved results for exploring
+    // Opens previously saved results for exploring, appended chunks are encoded by the "Delta" codec
     static FileExplorer *Open(const std::string &file, size_t elemPerChunk = 10);
 
     static FileExplorer *Repair(const std::string &file, FrameExtractor fextr, ServiceExtractor sextr,
@@ -69,7 +81,9 @@ class FileExplorer
     class WritingChunk
     {
       public:
-        WritingChunk(std::shared_ptr<FileContainer> fc, size_t MaxElemPerChunk);
+        // Binary chunks are stored as is, if there is no codec
+        WritingChunk(std::shared_ptr<FileContainer> fc, size_t MaxElemPerChunk, bool binary,
+                     const IChunkCodec *codec);
         inline size_t CurrentIdx()
         { return _currentIdx; }
         void Flush();
@@ -87,13 +101,17 @@ class FileExplorer
         uint64_t* _sizes;
         double _time;
         std::vector<ChunkElement*> _elements;
+        bool _binary;
+        std::vector<FrameFormat::FrameRecord> _frames;    // directory of the binary chunk
+        const IChunkCodec *_codec;
     };
 
     class ReadingChunk
     {
       public:
-        ReadingChunk():
-          _doc(0), _offsets(0), _sizes(0), _maxElemPerChunk(0), _currentElemPerChunk(0), _elements(0)
+        ReadingChunk(bool binary):
+          _doc(0), _offsets(0), _sizes(0), _maxElemPerChunk(0), _currentElemPerChunk(0), _elements(0),
+          _binary(binary)
         { }
         void LoadChunk(std::shared_ptr<Chunk> chunk);
         ChunkElement* Read(size_t idx);
@@ -107,10 +125,13 @@ class FileExplorer
         uint64_t _maxElemPerChunk;
         uint64_t _currentElemPerChunk;
         std::vector<ChunkElement*> _elements;
+        bool _binary;
+        std::vector<uint8_t> _decoded;    // binary data of the encoded chunk, it's reused by the next chunks
     };
 
     // Creates an uninitialized FileExplorer
     FileExplorer(const std::string &file);
+    void InitChunks(std::shared_ptr<FileContainer> fc, size_t elemPerChunk, IChunkCodec::Type codec);
     void SaveService(TiXmlElement *elem, MemoryStream *stream);
     ChunkElement *LoadService(size_t idx);
     void ReadTable();
@@ -119,6 +140,7 @@ class FileExplorer
     ChunkElement* _configuration;
     std::vector<ChunkElement*> _simParams;
     std::shared_ptr<FileContainer> _fc;
+    bool _binaryFrames;
 
     WritingChunk* _writingChunk;
     ReadingChunk* _readingChunk;
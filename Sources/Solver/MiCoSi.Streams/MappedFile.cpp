@@ -0,0 +1,72 @@
+#include "MappedFile.h"
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+//------------------
+//--- MappedFile ---
+//------------------
+
+MappedFile::~MappedFile()
+{
+#ifdef WIN32
+  UnmapViewOfFile(_data);
+#else
+  munmap((void *)_data, (size_t)_size);
+#endif
+}
+
+std::shared_ptr<MappedFile> MappedFile::Map(const std::string &filename)
+{
+#ifdef WIN32
+  // The file is still opened for appending by 'FileContainer', so writers must be allowed
+  HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                            nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE)
+  { return nullptr; }
+
+  LARGE_INTEGER size;
+  if (GetFileSizeEx(file, &size) == 0 || size.QuadPart <= 0 || (uint64_t)size.QuadPart > (uint64_t)SIZE_MAX)
+  {
+    CloseHandle(file);
+    return nullptr;
+  }
+
+  // The view keeps the mapping and the file opened, so both handles are not needed anymore
+  HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  CloseHandle(file);
+  if (mapping == nullptr)
+  { return nullptr; }
+  void *data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  CloseHandle(mapping);
+  if (data == nullptr)
+  { return nullptr; }
+
+  return std::shared_ptr<MappedFile>(new MappedFile((const uint8_t *)data, (uint64_t)size.QuadPart));
+#else
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0)
+  { return nullptr; }
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size <= 0 || (uint64_t)st.st_size > (uint64_t)SIZE_MAX)
+  {
+    close(fd);
+    return nullptr;
+  }
+
+  // The mapping stays valid after closing the descriptor
+  void *data = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED)
+  { return nullptr; }
+
+  return std::shared_ptr<MappedFile>(new MappedFile((const uint8_t *)data, (uint64_t)st.st_size));
+#endif
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include "MiCoSi.Core/Defs.h"
+
+// Read-only view of the whole file, pages are shared with the OS file cache instead of being copied
+// Chunks that are loaded from the mapped file keep it alive (see 'FileContainer::LoadChunk()')
+class MappedFile
+{
+  public:
+    MappedFile() = delete;
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator =(const MappedFile &) = delete;
+    ~MappedFile();
+
+    const uint8_t *Data() const
+    { return _data; }
+
+    // Size of the file at the moment of mapping, later changes are not visible
+    uint64_t Size() const
+    { return _size; }
+
+    // Returns nullptr if the file cannot be mapped (e.g. it's empty or too large for the address space)
+    // The caller must fall back to the usual reading
+    static std::shared_ptr<MappedFile> Map(const std::string &filename);
+
+  private:
+    MappedFile(const uint8_t *data, uint64_t size)
+      : _data(data), _size(size)
+    { /*nothing*/ }
+
+    const uint8_t *_data;
+    uint64_t _size;
+};
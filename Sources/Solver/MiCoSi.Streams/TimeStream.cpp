@@ -70,14 +70,58 @@ void UnLockFile(const char *file)
   { throw std::runtime_error("cannot unlock file"); }
 }
 
+// Loads time layer of the file's format
+std::pair<double, Random::State> DeserializeLayer(bool binaryFrames, FileExplorer::ChunkElement *layer, Cell &cell)
+{
+  if (binaryFrames)
+  { return DeSerializer::DeserializeFrame(layer->BinDataPointer(), (size_t)layer->SizeInBytes(), cell); }
+  else
+  {
+    return DeSerializer::DeserializeTimeLayer(layer->XmlElement(), cell,
+                                              layer->BinDataPointer(), (size_t)layer->SizeInBytes());
+  }
+}
+
+FrameFormat::Profile LayerProfile(bool binaryFrames, FileExplorer::ChunkElement *layer)
+{
+  return binaryFrames
+    ? DeSerializer::DeserializeFrameProfile(layer->BinDataPointer(), (size_t)layer->SizeInBytes())
+    : FrameFormat::Full;
+}
+
 bool TimeLayerExtractor(const void *metaData, size_t metaDataSize,
                         const void *binData, size_t binDataSize,
                         Cell &cell, double &time, size_t &layerCount)
 {
   try
   {
+    // Chunks of the newer formats have the binary directory of frames instead of XML
+    std::vector<FrameFormat::FrameRecord> frames;
+    uint32_t codecId = 0;
+    uint64_t dataSize = 0;
+    if (FrameFormat::ReadDirectory(metaData, metaDataSize, binDataSize, frames, codecId, dataSize))
+    {
+      if (frames.empty())
+      { return false; }
+      std::vector<uint8_t> decoded;
+      if (codecId != IChunkCodec::None)
+      {
+        const IChunkCodec *codec = IChunkCodec::Get(codecId);
+        if (codec == nullptr)
+        { return false; }
+        decoded.resize((size_t)dataSize);
+        codec->Decode(binData, binDataSize, frames, decoded.empty() ? nullptr : &decoded[0], decoded.size());
+        binData = decoded.empty() ? nullptr : &decoded[0];
+      }
+      for (size_t i = 0; i < frames.size(); i++)
+      { DeSerializer::DeserializeFrame((const uint8_t *)binData + frames[i].offset, (size_t)frames[i].size, cell); }
+      time = frames[0].time;
+      layerCount = frames.size();
+      return true;
+    }
+
     std::unique_ptr<TiXmlDocument> doc(new TiXmlDocument());
-    std::string metaString((char*)metaData);
+    std::string metaString((char*)metaData, metaDataSize);
     std::stringstream ss(metaString);
     ss >> *doc;
 
@@ -123,7 +167,7 @@ bool SimParamsExtractor(const void *metaData, size_t metaDataSize,
   try
   {
     std::unique_ptr<TiXmlDocument> doc(new TiXmlDocument());
-    std::string metaString((char*)metaData);
+    std::string metaString((char*)metaData, metaDataSize);
     std::stringstream ss(metaString);
     ss >> *doc;
 
@@ -146,7 +190,7 @@ bool CellConfigurationExtractor(const void *metaData, size_t metaDataSize,
   try
   {
     std::unique_ptr<TiXmlDocument> doc(new TiXmlDocument());
-    std::string metaString((char*)metaData);
+    std::string metaString((char*)metaData, metaDataSize);
     std::stringstream ss(metaString);
     ss >> *doc;
     cell = DeSerializer::DeserializeCellConfiguration(
@@ -182,7 +226,8 @@ std::unique_ptr<TimeStream> TimeStream::OpenFile(const std::string &file, bool r
 
   // Get the initial random seed and check version
   std::tuple<Version, std::string, int> ver = DeSerializer::DeserializeVersion(fe->Version());
-  if (std::get<2>(ver) != CurrentVersion::FileFormatVersion())
+  if (std::get<2>(ver) < CurrentVersion::OldestFileFormatVersion() ||
+      std::get<2>(ver) > CurrentVersion::FileFormatVersion())
   { throw VersionConflictException(CurrentVersion::ProgramVersion(), std::get<0>(ver)); }
   if (std::get<1>(ver) != CurrentVersion::CompilationFlags())
   { throw CompilationConflictException(CurrentVersion::CompilationFlags(), std::get<1>(ver)); }
@@ -191,17 +236,20 @@ std::unique_ptr<TimeStream> TimeStream::OpenFile(const std::string &file, bool r
   auto rng = DeSerializer::DeserializeRng(conf->XmlElement(),
                                           conf->BinDataPointer(),
                                           (size_t)conf->SizeInBytes());
+  bool deterministic = DeSerializer::DeserializeDeterministic(conf->XmlElement());
 
   //Done! Return the time stream
-  return std::unique_ptr<TimeStream>(new TimeStream(file, fe, rng.first, rng.second));
+  return std::unique_ptr<TimeStream>(new TimeStream(file, fe, rng.first, rng.second, deterministic));
 }
 
 TimeStream::TimeStream(const std::string &file,
                        std::unique_ptr<FileExplorer> &fe,
                        const Random::State &initialRng,
-                       int64_t userSeed)
-  : _file(file), _initialRng(initialRng), _userSeed(userSeed),
-    _fe(std::move(fe)), _curLayerIndex(-1), _needToFlush(false), _time(0.0)
+                       int64_t userSeed,
+                       bool deterministic)
+  : _file(file), _initialRng(initialRng), _userSeed(userSeed), _deterministic(deterministic),
+    _fe(std::move(fe)), _curLayerIndex(-1), _needToFlush(false), _time(0.0),
+    _layerProfile(FrameFormat::Full), _profile(FrameFormat::Full), _lengthRange(0.0)
 {
   LockFile(_file.c_str());
 }
@@ -211,7 +259,7 @@ const TimeStream::TimeLayer TimeStream::Current() const
   if (_curLayerIndex < 0)
   { throw std::runtime_error("built-in iterator is not set up"); }
 
-  return TimeLayer(_cell.get(), _params.get(), _time, &_rng);
+  return TimeLayer(_cell.get(), _params.get(), _time, &_rng, _layerProfile);
 }
 
 bool TimeStream::MoveNext()
@@ -244,15 +292,13 @@ void TimeStream::MoveTo(size_t layerIndex)
     );
 
     auto tp = _fe->TimeLayer(_curLayerIndex);
-    std::pair<double, Random::State> tr = DeSerializer::DeserializeTimeLayer(
-        tp.first->XmlElement(), *_cell,
-        tp.first->BinDataPointer(), (size_t)tp.first->SizeInBytes()
-    );
+    std::pair<double, Random::State> tr = DeserializeLayer(_fe->BinaryFrames(), tp.first, *_cell);
     _params = DeSerializer::DeserializeSimParams(tp.second->XmlElement(), 
                                                  tp.second->BinDataPointer(),
                                                  (size_t)tp.second->SizeInBytes());
     _time = tr.first;
     _rng = std::move(tr.second);
+    _layerProfile = LayerProfile(_fe->BinaryFrames(), tp.first);
   }
   else
   {
@@ -261,15 +307,13 @@ void TimeStream::MoveTo(size_t layerIndex)
     _params.reset();
 
     auto tp = _fe->TimeLayer(_curLayerIndex);
-    std::pair<double, Random::State> tr = DeSerializer::DeserializeTimeLayer(
-        tp.first->XmlElement(), *_cell,
-        tp.first->BinDataPointer(), (size_t)tp.first->SizeInBytes()
-    );
+    std::pair<double, Random::State> tr = DeserializeLayer(_fe->BinaryFrames(), tp.first, *_cell);
     _params = DeSerializer::DeserializeSimParams(tp.second->XmlElement(), 
                                                  tp.second->BinDataPointer(),
                                                  (size_t)tp.second->SizeInBytes());
     _time = tr.first;
     _rng = tr.second;
+    _layerProfile = LayerProfile(_fe->BinaryFrames(), tp.first);
   }
 }
 
@@ -290,6 +334,8 @@ double TimeStream::GetLayerTime(size_t layerIndex)
   { throw std::runtime_error("layer's index is out of range"); }
 
   auto tp = _fe->TimeLayer(layerIndex);
+  if (_fe->BinaryFrames())
+  { return DeSerializer::DeserializeFrameTime(tp.first->BinDataPointer(), (size_t)tp.first->SizeInBytes()); }
   return DeSerializer::DeserializeTime(tp.first->XmlElement());
 }
 
@@ -307,11 +353,28 @@ void TimeStream::Append(const Cell &cell, double time, const Random::State &rng)
 {
   Reset();
   MemoryStream stream;
-  TiXmlElement *elem = Serializer::SerializeTimeLayer(cell, time, rng, stream);
-  _fe->AppendFrameLayer(time, elem, &stream);
+  if (_fe->BinaryFrames())
+  {
+    Serializer::SerializeFrame(cell, time, rng, stream, _profile, _lengthRange);
+    _fe->AppendFrameLayer(time, nullptr, &stream);
+  }
+  else
+  {
+    // Files of the older formats are continued in their own format
+    TiXmlElement *elem = Serializer::SerializeTimeLayer(cell, time, rng, stream);
+    _fe->AppendFrameLayer(time, elem, &stream);
+  }
   _needToFlush = true;
 }
 
+void TimeStream::SetProfile(FrameFormat::Profile profile)
+{
+  if (profile != FrameFormat::Full && !_fe->BinaryFrames())
+  { throw std::runtime_error("files of the older formats cannot store lossy time layers"); }
+  _profile = profile;
+  _lengthRange = 2.0 * GlobalSimParams::GetRef()->GetParameter(SimParameter::Double::R_Cell, true);
+}
+
 void TimeStream::Flush()
 {
 
@@ -338,7 +401,9 @@ TimeStream::~TimeStream()
 std::unique_ptr<TimeStream> TimeStream::Create(const std::string &file,
                                                const Cell &cell,
                                                const Random::State &rng,
-                                               int64_t userSeed)
+                                               int64_t userSeed,
+                                               IChunkCodec::Type codec,
+                                               bool deterministic)
 {
   if (IsFileLocked(file))
   { throw std::runtime_error("file with results is locked"); }
@@ -348,12 +413,13 @@ std::unique_ptr<TimeStream> TimeStream::Create(const std::string &file,
       FileExplorer::Create(file, 10,
                            Serializer::SerializeVersion(CurrentVersion::ProgramVersion(),
                                                         CurrentVersion::CompilationFlags(),
-                                                        CurrentVersion::FileFormatVersion()))
+                                                        CurrentVersion::FileFormatVersion()),
+                           codec)
   );
-  TiXmlElement* elem = Serializer::SerializeCellConfiguration(cell, rng, userSeed, stream);
+  TiXmlElement* elem = Serializer::SerializeCellConfiguration(cell, rng, userSeed, stream, deterministic);
   fe->AppendCellConfiguration(elem, &stream);
 
-  return std::unique_ptr<TimeStream>(new TimeStream(file, fe, rng, userSeed));
+  return std::unique_ptr<TimeStream>(new TimeStream(file, fe, rng, userSeed, deterministic));
 }
 
 std::unique_ptr<TimeStream> TimeStream::Open(const std::string &file)
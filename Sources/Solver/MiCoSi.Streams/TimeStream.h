@@ -26,16 +26,22 @@ class TimeStream
         const Random::State &GetRng() const
         { return *_rng; }
 
+        // Layers of the lossy profiles cannot be used to continue simulation
+        FrameFormat::Profile GetProfile() const
+        { return _profile; }
+
       private:
-        TimeLayer() : _cell(nullptr), _simParams(nullptr), _time(0.0), _rng(nullptr) { }
-        TimeLayer(const Cell *cell, const SimParams *simParams, double time, const Random::State *rng)
-          : _cell(cell), _simParams(simParams), _time(time), _rng(rng)
+        TimeLayer() : _cell(nullptr), _simParams(nullptr), _time(0.0), _rng(nullptr), _profile(FrameFormat::Full) { }
+        TimeLayer(const Cell *cell, const SimParams *simParams, double time, const Random::State *rng,
+                  FrameFormat::Profile profile)
+          : _cell(cell), _simParams(simParams), _time(time), _rng(rng), _profile(profile)
         { /*nothing*/ }
 
         const Cell *_cell;
         const SimParams *_simParams;
         double _time;
         const Random::State *_rng;
+        FrameFormat::Profile _profile;
 
       friend class TimeStream;
     };
@@ -54,6 +60,10 @@ class TimeStream
     const Random::State &InitialRNG() const
     { return _initialRng; }
 
+    // True, if results were created in the deterministic mode (see 'SimulatorConfig::IsDeterministic()')
+    bool IsDeterministic() const
+    { return _deterministic; }
+
     // Returns the total count of time layers
     size_t LayerCount() const
     { return _fe->TimeLayerCount(); }
@@ -84,15 +94,25 @@ class TimeStream
     // Resets built-in iterator
     void Append(const Cell &cell, double time, const Random::State &rng);
 
+    // Profile of the appended time layers (see 'FrameFormat'), the full one is used by default
+    // Files of the older formats store full time layers only
+    // Lossy layers are quantized by the cell's size, so the global parameters must be already set
+    FrameFormat::Profile GetProfile() const
+    { return _profile; }
+    void SetProfile(FrameFormat::Profile profile);
+
     // Stores all changes
     void Flush();
 
     // Creates new file for time stream
     // If the previous file exist, rewrites it
+    // Chunks with time layers are encoded by the codec (see 'IChunkCodec')
     static std::unique_ptr<TimeStream> Create(const std::string &file,
                                               const Cell &cell,
                                               const Random::State &rng,
-                                              int64_t userSeed = -1);
+                                              int64_t userSeed = -1,
+                                              IChunkCodec::Type codec = IChunkCodec::Delta,
+                                              bool deterministic = false);
 
     //Tries to open some stored simulation results
     static std::unique_ptr<TimeStream> Open(const std::string &file);
@@ -104,12 +124,14 @@ class TimeStream
     TimeStream(const std::string &file,
                std::unique_ptr<FileExplorer> &fe,
                const Random::State &initialRng,
-               int64_t userSeed);
+               int64_t userSeed,
+               bool deterministic);
 
     static std::unique_ptr<TimeStream> OpenFile(const std::string &file, bool repair);
 
     std::string _file;
     int64_t _userSeed;
+    bool _deterministic;
     Random::State _initialRng;
     int _curLayerIndex;
     bool _needToFlush;
@@ -119,4 +141,7 @@ class TimeStream
     std::unique_ptr<Cell> _cell;
     double _time;
     Random::State _rng;
+    FrameFormat::Profile _layerProfile;
+    FrameFormat::Profile _profile;
+    double _lengthRange;                // is taken by 'SetProfile()', layers can be appended by other threads
 };
@@ -70,6 +70,15 @@ TEST(CommandLine, WrongSolvers)
   ASSERT_TRUE(ret.empty()) << ret;
 }
 
+TEST(CommandLine, WrongPrecisions)
+{
+  cli::array<String ^> ^argSet = { "--precision fp16",
+                                   "--precision double",
+                                   "--precision FP64:2" };
+  auto ret = CommandLineTest(argSet, true);
+  ASSERT_TRUE(ret.empty()) << ret;
+}
+
 TEST(CommandLine, NoCellForUpdate)
 {
   cli::array<String ^> ^argSet = { "--mode fix",
@@ -81,7 +90,8 @@ TEST(CommandLine, NoCellForUpdate)
 
 TEST(CommandLine, CorrectArgs)
 {
-  cli::array<String ^> ^argSet = { "--mode info", "--help" };   //no --new due to huge time with default config
+  cli::array<String ^> ^argSet = { "--mode info", "--help",     //no --new due to huge time with default config
+                                   "--mode info --precision fp32", "--mode info --precision fp64" };
   auto ret = CommandLineTest(argSet, false);
   ASSERT_TRUE(ret.empty()) << ret;
 }
@@ -111,6 +121,7 @@ TEST(CommandLine, Help)
 
     ASSERT_TRUE(output->Contains("--csv")) << StringToString("Have no info about \"--csv\"");
     ASSERT_TRUE(output->Contains("--print_delay")) << StringToString("Have no info about \"--print_delay\"");
+    ASSERT_TRUE(output->Contains("--precision")) << StringToString("Have no info about \"--precision\"");
   }
   catch (Exception ^ex) { FAIL() << StringToString(ex->Message); }
   finally { Helper::ClearUpTestDirectory(); }
@@ -186,6 +197,38 @@ TEST(CommandLine, AllArgs)
   finally { Helper::ClearUpTestDirectory(); }
 }
 
+TEST(CommandLine, Precision)
+{
+  try
+  {
+    Helper::PrepareTestDirectory();
+
+    auto parameters = gcnew LaunchParameters();
+    parameters->Config = gcnew SimParams();
+    parameters->Config[SimParameter::Int::N_Cr_Total] = 1;
+    parameters->Config[SimParameter::Int::N_MT_Total] = 10;
+    parameters->Config[SimParameter::Double::T_End] = 1.0;
+
+    // Results of both engines must be continued by the engine that stored them
+    for each (auto precision in gcnew cli::array<String ^>{ "fp32", "fp64" })
+    {
+      parameters->Args->Mode = LaunchMode::New;
+      parameters->Args->Precision = precision;
+      ASSERT_FALSE(Helper::Launch(parameters)->ExitedWithError)
+        << StringToString(String::Format("Failed to launch with \"{0}\" precision", precision));
+
+      parameters->Config[SimParameter::Double::T_End] = 2.0;
+      parameters->Args->Mode = LaunchMode::Continue;
+      parameters->Args->Precision = nullptr;
+      ASSERT_FALSE(Helper::Launch(parameters)->ExitedWithError)
+        << StringToString(String::Format("Failed to continue results of \"{0}\" precision", precision));
+      parameters->Config[SimParameter::Double::T_End] = 1.0;
+    }
+  }
+  catch (Exception ^ex) { FAIL() << StringToString(ex->Message); }
+  finally { Helper::ClearUpTestDirectory(); }
+}
+
 TEST(CommandLine, ResettingArg)
 {
   try
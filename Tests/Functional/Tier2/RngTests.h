@@ -169,3 +169,109 @@ TEST(RNG, StartContinue)
     Helper::ClearUpTestDirectory();
   }
 }
+
+TEST(RNG, IntraCellThreads)
+{
+  IntPtr single = (IntPtr)nullptr, multiple = (IntPtr)nullptr;
+  Helper::PrepareTestDirectory();
+
+  try
+  {
+    auto parameters = gcnew LaunchParameters();
+    parameters->Config = gcnew SimParams();
+    parameters->Config[SimParameter::Int::N_Cr_Total] = 3;
+    parameters->Config[SimParameter::Int::N_MT_Total] = 750;
+    parameters->Config[SimParameter::Double::Dt] = 0.5;
+    parameters->Config[SimParameter::Double::T_End] = 10.5;
+    parameters->Args->Mode = LaunchMode::New;
+    parameters->Args->UserSeed = 100500;
+
+    // Get data for single thread
+    TimeStream ^ts = nullptr;
+    parameters->Args->Solver = gcnew SimulatorConfig(SimulatorType::CPU_INTRA, 1);
+    try
+    {
+      ts = Helper::LaunchAndOpen(parameters);
+      ts->MoveTo(ts->LayerCount - 1);
+      single = Helper::CopyData(ts->Current->Cell);
+    }
+    finally { if (ts != nullptr) { delete ts; } }
+
+    // Get data for multiple threads that share the same cell
+    parameters->Args->Solver = gcnew SimulatorConfig(SimulatorType::CPU_INTRA, 4);
+    ts = nullptr;
+    try
+    {
+      ts = Helper::LaunchAndOpen(parameters);
+      ts->MoveTo(ts->LayerCount - 1);
+      multiple = Helper::CopyData(ts->Current->Cell);
+    }
+    finally { if (ts != nullptr) { delete ts; } }
+
+    // Check
+    if (!Helper::CompareData(single, multiple))
+    { FAIL() << "Results depend on the count of threads"; }
+  }
+  catch (Exception ^ex)
+  { FAIL() << StringToString(ex->Message); }
+  finally
+  {
+    if (single != (IntPtr)nullptr) { Helper::ReleaseData(single); }
+    if (multiple != (IntPtr)nullptr) { Helper::ReleaseData(multiple); }
+    Helper::ClearUpTestDirectory();
+  }
+}
+
+TEST(RNG, Deterministic)
+{
+  cli::array<IntPtr> ^data = gcnew cli::array<IntPtr>{ (IntPtr)nullptr, (IntPtr)nullptr, (IntPtr)nullptr };
+  Helper::PrepareTestDirectory();
+
+  try
+  {
+    auto parameters = gcnew LaunchParameters();
+    parameters->Config = gcnew SimParams();
+    parameters->Config[SimParameter::Int::N_Cr_Total] = 3;
+    parameters->Config[SimParameter::Int::N_MT_Total] = 750;
+    parameters->Config[SimParameter::Double::Dt] = 0.5;
+    parameters->Config[SimParameter::Double::T_End] = 10.5;
+    parameters->Args->Mode = LaunchMode::New;
+    parameters->Args->UserSeed = 100500;
+    parameters->Args->Deterministic = true;
+
+    // Different solvers and counts of threads must provide the same cell
+    cli::array<SimulatorConfig ^> ^solvers = { gcnew SimulatorConfig(SimulatorType::CPU, 1),
+                                               gcnew SimulatorConfig(SimulatorType::CPU, 4),
+                                               gcnew SimulatorConfig(SimulatorType::CPU_INTRA, 4) };
+    for (int i = 0; i < data->Length; i++)
+    {
+      TimeStream ^ts = nullptr;
+      parameters->Args->Solver = solvers[i];
+      try
+      {
+        ts = Helper::LaunchAndOpen(parameters);
+        ts->MoveTo(ts->LayerCount - 1);
+        data[i] = Helper::CopyData(ts->Current->Cell);
+      }
+      finally { if (ts != nullptr) { delete ts; } }
+    }
+
+    // Check
+    for (int i = 1; i < data->Length; i++)
+    {
+      if (!Helper::CompareData(data[0], data[i]))
+      { FAIL() << "Results depend on the solver or on the count of threads"; }
+    }
+  }
+  catch (Exception ^ex)
+  { FAIL() << StringToString(ex->Message); }
+  finally
+  {
+    for each (auto r in data)
+    {
+      if (r != (IntPtr)nullptr)
+      { Helper::ReleaseData(r); }
+    }
+    Helper::ClearUpTestDirectory();
+  }
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include "Defs.h"
+
+#include "MiCoSi.Geometry/BatchGeometry.h"
+
+namespace
+{
+
+// Checks that the batched and scalar versions return exactly the same results
+template <class PRIMITIVE>
+void CompareBatchWithScalar(const PRIMITIVE &prim, std::mt19937 &gen, int count)
+{
+  std::uniform_real_distribution<float> rnd(-2.0f, 2.0f);
+  Geometry geom(1e-5f);
+  BatchGeometry::Segments segs;
+  std::vector<Geometry::Segment> scalar;
+  for (int i = 0; i < count; i++)
+  {
+    vec3r p1(rnd(gen), rnd(gen), rnd(gen));
+    vec3r p2(rnd(gen), rnd(gen), rnd(gen));
+    segs.Set(i, p1, p2);
+    scalar.push_back(Geometry::Segment(p1, p2));
+  }
+
+  BatchGeometry::Hits hits;
+  uint32_t mask = BatchGeometry::AreIntersected(segs, prim, hits);
+  for (int i = 0; i < BatchGeometry::WIDTH; i++)
+  {
+    vec3r ipoint;
+    bool expected = i < count && geom.AreIntersected(scalar[i], prim, ipoint);
+    ASSERT_EQ(((mask >> i) & 1) != 0, expected);
+    if (expected)
+    {
+      ASSERT_EQ(hits.x[i], ipoint.x);
+      ASSERT_EQ(hits.y[i], ipoint.y);
+      ASSERT_EQ(hits.z[i], ipoint.z);
+      ASSERT_EQ(hits.dist[i], (ipoint - scalar[i].p1).GetLength());
+    }
+  }
+}
+
+} // unnamed namespace
+
+TEST(BatchGeometry, EmptyBatch)
+{
+  BatchGeometry::Segments segs;
+  BatchGeometry::Hits hits;
+  Geometry::Plane plane(vec3r(0.0f, 0.0f, 0.0f), vec3r(0.0f, 0.0f, 1.0f));
+  ASSERT_EQ(BatchGeometry::AreIntersected(segs, plane, hits), 0u);
+}
+
+TEST(BatchGeometry, CompareWithScalar)
+{
+  const int TRIES = 2000;
+  std::mt19937 gen(100500);
+  std::uniform_real_distribution<float> rnd(-1.0f, 1.0f);
+  for (int k = 0; k < TRIES; k++)
+  {
+    vec3r p(rnd(gen), rnd(gen), rnd(gen));
+    vec3r v1(rnd(gen), rnd(gen), rnd(gen));
+    vec3r v2 = CrossProduct(v1, vec3r(rnd(gen), rnd(gen), rnd(gen)));
+    int count = 1 + k % BatchGeometry::WIDTH;
+
+    CompareBatchWithScalar(Geometry::Plane(p, v1), gen, count);
+    CompareBatchWithScalar(Geometry::Rectangle(p, v1, v2), gen, count);
+    CompareBatchWithScalar(Geometry::SemiCircle(p, v1, v2.Normalize() * v1.GetLength()), gen, count);
+    CompareBatchWithScalar(Geometry::SemiTube(p, p + v1, v2.Normalize() * 0.5f), gen, count);
+  }
+}
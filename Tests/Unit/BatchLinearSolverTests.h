@@ -0,0 +1,89 @@
+#pragma once
+#include "Defs.h"
+
+#include "MiCoSi.Geometry/BatchLinearSolver.h"
+
+namespace
+{
+
+typedef real Matrix6x7[BatchLinearSolver::ROWS][BatchLinearSolver::COLS];
+
+// Random system, some of them are degenerate (zero rows or linearly dependent rows)
+void GenerateSystem(Matrix6x7 &mat, std::mt19937 &gen)
+{
+  std::uniform_real_distribution<float> rnd(-1.0f, 1.0f);
+  for (int i = 0; i < BatchLinearSolver::ROWS; i++)
+  {
+    for (int j = 0; j < BatchLinearSolver::COLS; j++)
+    { mat[i][j] = rnd(gen); }
+  }
+
+  switch (gen() % 8)
+  {
+    case 0:
+      for (int j = 0; j < BatchLinearSolver::COLS; j++)
+      { mat[gen() % BatchLinearSolver::ROWS][j] = 0.0f; }
+      break;
+
+    case 1:
+      for (int j = 0; j < BatchLinearSolver::COLS; j++)
+      { mat[5][j] = mat[2][j] * 2.0f; }
+      break;
+
+    default:
+      break;
+  }
+}
+
+} // unnamed namespace
+
+TEST(BatchLinearSolver, KnownAnswer)
+{
+  Matrix6x7 mat = {};
+  for (int i = 0; i < BatchLinearSolver::ROWS; i++)
+  {
+    mat[i][i] = (real)(i + 1);
+    mat[i][BatchLinearSolver::COLS - 1] = (real)(i + 1) * 3;
+  }
+
+  BatchLinearSolver::Systems systems;
+  systems.Set(0, mat);
+  ASSERT_EQ(BatchLinearSolver::Solve(systems), 1u);
+  for (int i = 0; i < BatchLinearSolver::ROWS; i++)
+  { ASSERT_NEAR(systems.Answer(0, i), 3.0f, 1e-5f); }
+}
+
+TEST(BatchLinearSolver, CompareWithScalar)
+{
+  const int TRIES = 2000;
+  std::mt19937 gen(100500);
+  for (int k = 0; k < TRIES; k++)
+  {
+    int count = 1 + k % BatchLinearSolver::WIDTH;
+    BatchLinearSolver::Systems systems;
+    std::vector<bool> expected;
+    std::vector<std::vector<real> > answers;
+    for (int lane = 0; lane < count; lane++)
+    {
+      Matrix6x7 mat;
+      GenerateSystem(mat, gen);
+      systems.Set(lane, mat);
+      expected.push_back(BatchLinearSolver::Solve(mat));
+      answers.push_back(std::vector<real>());
+      for (int i = 0; i < BatchLinearSolver::ROWS; i++)
+      { answers.back().push_back(mat[i][BatchLinearSolver::COLS - 1]); }
+    }
+
+    uint32_t mask = BatchLinearSolver::Solve(systems);
+    for (int lane = 0; lane < BatchLinearSolver::WIDTH; lane++)
+    {
+      bool solved = lane < count && expected[lane];
+      ASSERT_EQ(((mask >> lane) & 1) != 0, solved);
+      if (solved)
+      {
+        for (int i = 0; i < BatchLinearSolver::ROWS; i++)
+        { ASSERT_EQ(systems.Answer(lane, i), answers[lane][i]); }
+      }
+    }
+  }
+}
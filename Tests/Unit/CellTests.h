@@ -0,0 +1,67 @@
+#pragma once
+#include "Defs.h"
+
+#include "MiCoSi.Objects/All.h"
+#include "MiCoSi.Solvers/RandomCellInitializer.h"
+#include "MiCoSi.Solvers/StaticPoleUpdater.h"
+
+namespace
+{
+
+// Compares the index of bound MTs with the full enumeration
+void CheckKMTIndex(const Cell &cell)
+{
+  for (auto chr : cell.Chromosomes())
+  {
+    std::vector<MT *> expected;
+    for (auto mt : cell.MTs())
+    {
+      if (mt->BoundChromosome() == chr)
+      { expected.push_back(mt); }
+    }
+
+    std::vector<MT *> actual;
+    for (auto mt : chr->KMTs())
+    { actual.push_back(mt); }
+
+    ASSERT_EQ(chr->KMTCount(), expected.size());
+    ASSERT_EQ(actual, expected);
+  }
+}
+
+} // unnamed namespace
+
+TEST(Cell, KMTIndex)
+{
+  RandomCellInitialzier initializer;
+  StaticPoleUpdater updater;
+  Random::State state;
+  Random::Initialize(state, 100500);
+  Cell cell(&initializer, &updater, state);
+  CheckKMTIndex(cell);
+
+  std::mt19937 gen(100500);
+  std::uniform_int_distribution<size_t> mtRnd(0, cell.MTs().size() - 1);
+  std::uniform_int_distribution<size_t> chrRnd(0, cell.Chromosomes().size() - 1);
+  for (int i = 0; i < 5000; i++)
+  {
+    MT *mt = cell.MTs()[mtRnd(gen)];
+    if (gen() % 3 == 0)
+    { mt->UnBind(); }
+    else
+    { mt->Bind(cell.Chromosomes()[chrRnd(gen)]); }
+
+    if (i % 100 == 0)
+    { CheckKMTIndex(cell); }
+  }
+  CheckKMTIndex(cell);
+
+  // Rebuilt index must be the same
+  std::vector<size_t> counts;
+  for (auto chr : cell.Chromosomes())
+  { counts.push_back(chr->KMTCount()); }
+  const_cast<CellData &>(cell.Data()).RebuildKMTIndex();
+  for (size_t i = 0; i < counts.size(); i++)
+  { ASSERT_EQ(cell.Chromosomes()[i]->KMTCount(), counts[i]); }
+  CheckKMTIndex(cell);
+}
@@ -1,4 +1,28 @@
+#pragma once
 #include <gtest/gtest.h>
 
+#include "MiCoSi.Core/SimParams.h"
+
 #define ASSERT_EQ_EPS(val1, val2, eps)        \
 ASSERT_TRUE(std::abs((val1) - (val2)) < (eps))
+
+// Restores the global simulation parameters at the end of the test, even if some assertion fails
+class SimParamsGuard
+{
+  public:
+    SimParamsGuard()
+      : _values(GlobalSimParams::GetRef()->ExportValues()), _access(GlobalSimParams::GetRef()->GetAccess())
+    { /*nothing*/ }
+
+    ~SimParamsGuard()
+    {
+      SimParams *params = GlobalSimParams::GetRef();
+      params->SetAccess(SimParams::Access::Initialize);
+      params->ImportValues(_values);
+      params->SetAccess(_access);
+    }
+
+  private:
+    std::vector<std::pair<std::string, std::string> > _values;
+    SimParams::Access::Type _access;
+};
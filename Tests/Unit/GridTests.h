@@ -0,0 +1,85 @@
+#pragma once
+#include "Defs.h"
+
+#include "MiCoSi.Geometry/CapsuleGrid.h"
+
+TEST(Grid, EmptyGrid)
+{
+  CapsuleGrid grid(1e-5f);
+  grid.Build();
+  std::vector<int> res(3, 0);
+  grid.Query(vec3r(-1.0f, 0.0f, 0.0f), vec3r(1.0f, 0.0f, 0.0f), res);
+  ASSERT_TRUE(res.empty());
+}
+
+TEST(Grid, SortedCandidates)
+{
+  CapsuleGrid grid(1e-5f);
+  for (int i = 0; i < 10; i++)
+  {
+    float x = 9.0f - 2.0f * i;
+    grid.Add(vec3r(x, -0.5f, 0.0f), vec3r(x, 0.5f, 0.0f), 0.1f);
+  }
+  grid.Build();
+
+  std::vector<int> res;
+  grid.Query(vec3r(-10.0f, 0.0f, 0.0f), vec3r(10.0f, 0.0f, 0.0f), res);
+  ASSERT_EQ(res.size(), 10u);
+  for (int i = 0; i < 10; i++)
+  { ASSERT_EQ(res[i], i); }
+
+  grid.Query(vec3r(4.0f, 0.0f, 0.0f), vec3r(10.0f, 0.0f, 0.0f), res);
+  ASSERT_EQ(res.size(), 3u);
+  ASSERT_EQ(res[0], 0);
+  ASSERT_EQ(res[2], 2);
+
+  grid.Query(vec3r(-10.0f, 1.0f, 0.0f), vec3r(10.0f, 1.0f, 0.0f), res);
+  ASSERT_TRUE(res.empty());
+}
+
+TEST(Grid, CompareWithBoxes)
+{
+  const int CAPSULES = 46;
+  const int QUERIES = 1000;
+  std::mt19937 gen(100500);
+  std::uniform_real_distribution<float> rnd(-10.0f, 10.0f);
+
+  CapsuleGrid grid(1e-5f);
+  std::vector<float> lo(CAPSULES * 3), hi(CAPSULES * 3);
+  for (int i = 0; i < CAPSULES; i++)
+  {
+    vec3r c(rnd(gen) * 0.8f, rnd(gen) * 0.8f, rnd(gen) * 0.8f);
+    vec3r axis(rnd(gen) * 0.1f, rnd(gen) * 0.1f, rnd(gen) * 0.1f);
+    float r = std::abs(rnd(gen)) * 0.05f;
+    grid.Add(c - axis, c + axis, r);
+    for (int a = 0; a < 3; a++)
+    {
+      lo[i * 3 + a] = c[a] - std::abs(axis[a]) - r;
+      hi[i * 3 + a] = c[a] + std::abs(axis[a]) + r;
+    }
+  }
+  grid.Build();
+
+  std::vector<int> res;
+  for (int q = 0; q < QUERIES; q++)
+  {
+    vec3r beg(rnd(gen), rnd(gen), rnd(gen));
+    vec3r end(rnd(gen), rnd(gen), rnd(gen));
+    grid.Query(beg, end, res);
+
+    // Each segment that surely crosses some box must report it
+    for (int i = 0; i < CAPSULES; i++)
+    {
+      bool inside = false;
+      for (int s = 0; s <= 100 && !inside; s++)
+      {
+        vec3r p = beg + (end - beg) * (s / 100.0f);
+        inside = true;
+        for (int a = 0; a < 3; a++)
+        { inside = inside && p[a] > lo[i * 3 + a] && p[a] < hi[i * 3 + a]; }
+      }
+      if (inside)
+      { ASSERT_TRUE(std::find(res.begin(), res.end(), i) != res.end()); }
+    }
+  }
+}
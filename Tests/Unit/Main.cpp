@@ -1,8 +1,14 @@
 #include "Defs.h"
 
+#include "BatchGeometryTests.h"
+#include "BatchLinearSolverTests.h"
+#include "CellTests.h"
 #include "DistanceTests.h"
+#include "GridTests.h"
 #include "RandomTests.h"
+#include "SimParamsTests.h"
 #include "SimulatorTests.h"
+#include "StreamTests.h"
 
 int main(int argc, char *argv[])
 {
@@ -19,6 +19,13 @@ TEST(Random, NewStates)
     gen.Initialize(state2);
     ASSERT_NE(state1, state2);
   }
+  {
+    PhiloxGenerator gen;
+    PhiloxGenerator::State state1, state2;
+    gen.Initialize(state1);
+    gen.Initialize(state2);
+    ASSERT_NE(state1, state2);
+  }
 }
 
 TEST(Random, MaxIsBigEnough)
@@ -31,6 +38,10 @@ TEST(Random, MaxIsBigEnough)
     MersenneTwisterGenerator gen;
     ASSERT_GE(gen.Max(), 0x7FFFu);
   }
+  {
+    PhiloxGenerator gen;
+    ASSERT_GE(gen.Max(), 0x7FFFu);
+  }
 }
 
 #define MultiplyStateTestBody()                             \
@@ -67,6 +78,12 @@ TEST(Random, MultiplyState_Mtg)
   MultiplyStateTestBody();
 }
 
+TEST(Random, MultiplyState_Philox)
+{
+  using Generator = PhiloxGenerator;
+  MultiplyStateTestBody();
+}
+
 #define ReproducibilityTestBody()           \
 {                                           \
   Generator gen;                            \
@@ -99,6 +116,12 @@ TEST(Random, Reproducibility_Mtg)
   ReproducibilityTestBody();
 }
 
+TEST(Random, Reproducibility_Philox)
+{
+  using Generator = PhiloxGenerator;
+  ReproducibilityTestBody();
+}
+
 #define HistogramsTestBody()                                  \
 {                                                             \
   const size_t N = 0xFFFF;                                    \
@@ -130,6 +153,12 @@ TEST(Random, Histograms_Mtg)
   HistogramsTestBody();
 }
 
+TEST(Random, Histograms_Philox)
+{
+  using Generator = PhiloxGenerator;
+  HistogramsTestBody();
+}
+
 #define MidPointTestBody()                                  \
 {                                                           \
   const int N = 4 * 1024;                                   \
@@ -162,6 +191,12 @@ TEST(Random, MidPoint_Mtg)
   MidPointTestBody();
 }
 
+TEST(Random, MidPoint_Philox)
+{
+  using Generator = PhiloxGenerator;
+  MidPointTestBody();
+}
+
 #define GoodSerializationTestBody()                         \
 {                                                           \
   Generator gen;                                            \
@@ -194,6 +229,12 @@ TEST(Random, GoodSerialization_Mtg)
   GoodSerializationTestBody();
 }
 
+TEST(Random, GoodSerialization_Philox)
+{
+  using Generator = PhiloxGenerator;
+  GoodSerializationTestBody();
+}
+
 #define BadSerializationTestBody()                                                  \
 {                                                                                   \
   Generator gen;                                                                    \
@@ -237,3 +278,84 @@ TEST(Random, BadSerialization_Mtg)
   using Generator = MersenneTwisterGenerator;
   BadSerializationTestBody();
 }
+
+TEST(Random, BadSerialization_Philox)
+{
+  using Generator = PhiloxGenerator;
+  BadSerializationTestBody();
+}
+
+TEST(Random, KnownAnswers_Philox)
+{
+  // Reference values of Philox4x32-10 for the zero key and counter
+  const uint32_t key[2] = { 0, 0 };
+  uint32_t res[4];
+  PhiloxGenerator::Block(key, 0, res);
+  ASSERT_EQ(res[0], 0x6627E8D5u);
+  ASSERT_EQ(res[1], 0xE169C58Du);
+  ASSERT_EQ(res[2], 0xBC57AC4Cu);
+  ASSERT_EQ(res[3], 0x9B00DBD8u);
+
+  PhiloxGenerator gen;
+  PhiloxGenerator::State state;
+  gen.Initialize(state, 0, 0);
+  for (int i = 0; i < 4; i++)
+  { ASSERT_EQ(gen.Next(state), res[i]); }
+}
+
+TEST(Random, Skip_Philox)
+{
+  PhiloxGenerator gen;
+  PhiloxGenerator::State state1, state2;
+  gen.Initialize(state1, 100500, 7);
+  for (uint64_t skip : { 0, 1, 3, 4, 5, 13 })
+  {
+    state2 = state1;
+    for (uint64_t i = 0; i < skip; i++)
+    { gen.Next(state1); }
+    gen.Skip(state2, skip);
+    ASSERT_EQ(state1, state2);
+    ASSERT_EQ(gen.Next(state1), gen.Next(state2));
+  }
+}
+
+TEST(Random, NormalMoments)
+{
+  const size_t COUNT = 1000001;   // odd, the last pair is incomplete
+  std::vector<real> values(COUNT);
+  Random::State state;
+  Random::Initialize(state, 100500);
+  Random::NextNormals(state, values.data(), COUNT);
+
+  double sum = 0.0, sum2 = 0.0;
+  size_t tails = 0;
+  for (real v : values)
+  {
+    sum += v;
+    sum2 += (double)v * v;
+    if (std::abs(v) > 3) tails++;
+  }
+  double mean = sum / COUNT;
+  double var = sum2 / COUNT - mean * mean;
+  ASSERT_NEAR(mean, 0.0, 0.01);
+  ASSERT_NEAR(var, 1.0, 0.01);
+  ASSERT_NEAR((double)tails / COUNT, 0.0027, 0.0005);   // not truncated, unlike sum of 12 uniforms
+}
+
+TEST(Random, Streams)
+{
+  // States of streams depend only on the seed and on the index of stream
+  auto draws = [](uint32_t seed, uint32_t stream) -> std::vector<uint32_t>
+  {
+    Random::State state;
+    Random::Initialize(state, seed, stream);
+    std::vector<uint32_t> res(8);
+    for (size_t i = 0; i < res.size(); i++)
+    { res[i] = Random::Next(state); }
+    return res;
+  };
+
+  ASSERT_EQ(draws(100500, 3), draws(100500, 3));
+  ASSERT_NE(draws(100500, 3), draws(100500, 4));
+  ASSERT_NE(draws(100500, 3), draws(100501, 3));
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include "Defs.h"
+
+#include "MiCoSi.Core/SimParams.h"
+
+TEST(SimParams, Registry)
+{
+  ASSERT_EQ(SimParameter::Int::All().size(), SimParameter::Int::Count);
+  for (auto type : SimParameter::Int::All())
+  {
+    SimParameter::Int::Type parsed;
+    ASSERT_TRUE(SimParameter::Int::TryParse(SimParameter::Int::Info(type).Name(), parsed));
+    ASSERT_EQ(parsed, type);
+  }
+
+  ASSERT_EQ(SimParameter::Double::All().size(), SimParameter::Double::Count);
+  for (auto type : SimParameter::Double::All())
+  {
+    SimParameter::Double::Type parsed;
+    ASSERT_TRUE(SimParameter::Double::TryParse(SimParameter::Double::Info(type).Name(), parsed));
+    ASSERT_EQ(parsed, type);
+  }
+}
+
+TEST(SimParams, Snapshot)
+{
+  SimParams params;
+  params.SetAccess(SimParams::Access::Initialize);
+  params.SetParameter(SimParameter::Int::N_KMT_Max, 7);
+  params.SetParameter(SimParameter::Double::V_Pol, 10.0);
+
+  SimParamsSnapshot snapshot = params.Snapshot();
+  for (auto type : SimParameter::Int::All())
+  { ASSERT_EQ(snapshot[type], params.GetParameter(type)); }
+  for (auto type : SimParameter::Double::All())
+  {
+    ASSERT_EQ(snapshot[type], (real)params.GetParameter(type, true));
+    ASSERT_EQ(snapshot.Exact(type), params.GetParameter(type, true));
+  }
+  ASSERT_EQ(snapshot[SimParameter::Int::N_KMT_Max], 7);
+}
@@ -1,7 +1,13 @@
 #pragma once
 #include "Defs.h"
 
+#include "MiCoSi.Objects/All.h"
 #include "MiCoSi.Solvers/SimulatorConfig.h"
+#include "MiCoSi.Solvers/SimulatorFactory.h"
+#include "MiCoSi.Solvers/RandomCellInitializer.h"
+#include "MiCoSi.Solvers/StaticPoleUpdater.h"
+#include "MiCoSi.Solvers/CpuSimulator/CpuSimulator.h"
+#include "MiCoSi.Solvers/CpuSimulator/FreeMTSchedule.h"
 
 static inline bool SerializeDeserializeTest(const SimulatorConfig &config)
 {
@@ -20,6 +26,111 @@ static inline bool SerializeDeserializeTest(const SimulatorConfig &config)
   { return false; }
 }
 
+// Runs several iterations of the CPU simulator and returns lengths of MTs and positions of chromosomes
+static inline std::vector<real> SimulateCells(SimulatorConfig config, int batch = 1)
+{
+  std::vector<Random::State> states(4);
+  for (size_t i = 0; i < states.size(); i++)
+  { Random::Initialize(states[i], 100500 + (uint32_t)i); }
+
+  auto sim = SimulatorFactory::Create(states, nullptr, nullptr, config);
+  for (int i = 0; i < 20; i += batch)
+  { sim->DoIterations(batch); }
+
+  std::vector<real> res;
+  for (auto &cell : sim->Cells())
+  {
+    for (auto mt : cell->CellObject().MTs())
+    { res.push_back(mt->Length()); }
+    for (auto chr : cell->CellObject().Chromosomes())
+    {
+      vec3r pos = (vec3r)chr->Position();
+      res.push_back(pos.x);
+      res.push_back(pos.y);
+      res.push_back(pos.z);
+    }
+  }
+  return res;
+}
+
+// The same, but returns the whole blocks of cell data, like 'Helper::CompareData()' of the functional tests
+static inline std::vector<std::vector<uint8_t> > SimulateCellData(SimulatorConfig config, int batch = 1)
+{
+  std::vector<Random::State> states(4);
+  for (size_t i = 0; i < states.size(); i++)
+  { Random::Initialize(states[i], 100500, (uint32_t)i); }
+
+  auto sim = SimulatorFactory::Create(states, nullptr, nullptr, config);
+  for (int i = 0; i < 20; i += batch)
+  { sim->DoIterations(batch); }
+
+  std::vector<std::vector<uint8_t> > res;
+  for (auto &cell : sim->Cells())
+  {
+    const CellData &data = cell->CellObject().Data();
+    res.emplace_back(data.DataPointer(), data.DataPointer() + data.DataSize());
+  }
+  return res;
+}
+
+// Averages over the second half of simulation, they depend on growth, captures and collisions of free MTs
+struct FreeMTStats
+{
+  double length;    // length of free MTs
+  double kmts;      // count of MTs that are bound to chromosomes
+};
+
+// Event-driven engine stops MTs exactly at the cell's boundary, the fixed-step one may overshoot by one step
+static inline FreeMTStats SimulateFreeMTs(bool eventDriven, uint32_t seed)
+{
+  RandomCellInitialzier initializer;
+  StaticPoleUpdater updater;
+  Random::State state;
+  Random::Initialize(state, seed);
+  Cell cell(&initializer, &updater, state);
+  FreeMTSchedule schedule(cell.MTs().size());
+  SimParamsSnapshot params = GlobalSimParams::GetRef()->Snapshot();
+  const real r_cell = (real)params[SimParameter::Double::R_Cell];
+
+  const int steps = 4000;
+  double sum = 0.0, kmts = 0.0;
+  size_t count = 0, samples = 0;
+  for (int i = 0; i < steps; i++)
+  {
+    CpuSimulator::DoMacroStep(cell, state, params);
+    if (eventDriven)
+    { CpuSimulator::DoEventMicroStep(cell, state, params, schedule); }
+    else
+    { CpuSimulator::DoMicroStep(cell, state, params); }
+
+    // KMTs live for a few steps only, so they are counted after each step
+    if (i >= steps / 2)
+    {
+      for (auto chr : cell.Chromosomes())
+      { kmts += chr->KMTCount(); }
+      samples++;
+    }
+
+    if (i >= steps / 2 && i % 100 == 0)
+    {
+      if (eventDriven)
+      { schedule.Materialize(cell); }
+      for (auto mt : cell.MTs())
+      {
+        if (mt->BoundChromosome() != nullptr)
+        { continue; }
+        EXPECT_GE(mt->Length(), (real)0);
+        if (eventDriven)
+        { EXPECT_LE(mt->EndPoint().GetLength(), r_cell * (real)1.0001); }
+        sum += mt->Length();
+        count++;
+      }
+    }
+  }
+  FreeMTStats res = { sum / count, kmts / samples };
+  return res;
+}
+
 TEST(Simulator, DefaultConfig)
 {
   auto config = SimulatorConfig::Default();
@@ -56,3 +167,218 @@ TEST(Simulator, CudaConfig)
   ASSERT_TRUE(config.HasDeviceNumber(num));
   ASSERT_EQ(num, 1);
 }
+
+TEST(Simulator, CpuIntraConfig)
+{
+  int num;
+  auto config = SimulatorConfig(SimulatorConfig::CPU_INTRA);
+  ASSERT_TRUE(SerializeDeserializeTest(config));
+  ASSERT_EQ(config.Type(), SimulatorConfig::CPU_INTRA);
+  ASSERT_FALSE(config.HasDeviceNumber(num));
+
+  config = SimulatorConfig::Parse("cpu-intra:4");
+  ASSERT_TRUE(SerializeDeserializeTest(config));
+  ASSERT_EQ(config.Type(), SimulatorConfig::CPU_INTRA);
+  ASSERT_TRUE(config.HasDeviceNumber(num));
+  ASSERT_EQ(num, 4);
+}
+
+TEST(Simulator, FreeMTEngine)
+{
+  // Both engines sample the same processes, so the statistics must be close
+  // Captures are rare with the default rates, so MTs are captured at the first contact and never released
+  SimParamsGuard guard;
+  SimParams *params = GlobalSimParams::GetRef();
+  params->SetAccess(SimParams::Access::Initialize);
+  params->SetParameter(SimParameter::Double::K_On, 10.0);
+  params->SetParameter(SimParameter::Double::K_Off, 0.0);
+  FreeMTStats fixedStep = { 0.0, 0.0 }, eventDriven = { 0.0, 0.0 };
+  for (uint32_t seed = 100500; seed < 100504; seed++)
+  {
+    FreeMTStats f = SimulateFreeMTs(false, seed), e = SimulateFreeMTs(true, seed);
+    fixedStep.length += f.length;
+    fixedStep.kmts += f.kmts;
+    eventDriven.length += e.length;
+    eventDriven.kmts += e.kmts;
+  }
+  ASSERT_NEAR(eventDriven.length / fixedStep.length, 1.0, 0.1);
+  ASSERT_GT(fixedStep.kmts, 0.0);
+  ASSERT_NEAR(eventDriven.kmts / fixedStep.kmts, 1.0, 0.1);
+}
+
+TEST(Simulator, MultiRate)
+{
+  SimParamsGuard guard;
+  SimParams *params = GlobalSimParams::GetRef();
+  params->SetAccess(SimParams::Access::Initialize);
+  params->SetParameter(SimParameter::Int::Micro_Substeps, 2);
+  params->SetParameter(SimParameter::Int::Macro_Period, 3);
+
+  std::vector<Random::State> states(1);
+  Random::Initialize(states[0], 100500);
+  auto sim = SimulatorFactory::Create(states, nullptr, nullptr, SimulatorConfig(SimulatorConfig::CPU, 1));
+  const double dt = params->GetParameter(SimParameter::Double::Dt, true);
+  for (int i = 0; i < 10; i++)
+  { sim->DoIteration(); }
+  ASSERT_NEAR(sim->Time(), dt * 10, dt * 1e-3);
+
+  // Chromosomes would diffuse too far during such a long macro step, it's rejected before the run
+  params->SetParameter(SimParameter::Int::Macro_Period, 1000);
+  ASSERT_THROW(SimulatorFactory::Create(states, nullptr, nullptr, SimulatorConfig(SimulatorConfig::CPU, 1)),
+               std::runtime_error);
+}
+
+TEST(Simulator, CpuTasksConfig)
+{
+  int num;
+  auto config = SimulatorConfig::Parse("cpu-tasks");
+  ASSERT_TRUE(SerializeDeserializeTest(config));
+  ASSERT_EQ(config.Type(), SimulatorConfig::CPU_TASKS);
+  ASSERT_FALSE(config.HasDeviceNumber(num));
+
+  config = SimulatorConfig::Parse("cpu-tasks:3");
+  ASSERT_TRUE(SerializeDeserializeTest(config));
+  ASSERT_TRUE(config.HasDeviceNumber(num));
+  ASSERT_EQ(num, 3);
+}
+
+TEST(Simulator, CpuTasks)
+{
+  // Cells are independent, so the distribution of them between threads must not affect results
+  auto expected = SimulateCells(SimulatorConfig(SimulatorConfig::CPU, 1));
+  ASSERT_EQ(SimulateCells(SimulatorConfig(SimulatorConfig::CPU_TASKS, 1)), expected);
+  ASSERT_EQ(SimulateCells(SimulatorConfig(SimulatorConfig::CPU_TASKS, 3)), expected);
+}
+
+TEST(Simulator, Batches)
+{
+  // Batches change only synchronization of cells, not their steps
+  auto expected = SimulateCells(SimulatorConfig(SimulatorConfig::CPU, 1));
+  ASSERT_EQ(SimulateCells(SimulatorConfig(SimulatorConfig::CPU, 3), 5), expected);
+  ASSERT_EQ(SimulateCells(SimulatorConfig(SimulatorConfig::CPU_TASKS, 3), 10), expected);
+
+  // Intra-cell version uses RNG substreams for MTs, so it is compared with itself
+  expected = SimulateCells(SimulatorConfig(SimulatorConfig::CPU_INTRA, 2));
+  ASSERT_EQ(SimulateCells(SimulatorConfig(SimulatorConfig::CPU_INTRA, 2), 4), expected);
+}
+
+TEST(Simulator, Deterministic)
+{
+  // All CPU solvers must provide bitwise identical cells for any count of threads
+  auto expected = SimulateCellData(SimulatorConfig(SimulatorConfig::CPU, 1, true));
+  ASSERT_EQ(SimulateCellData(SimulatorConfig(SimulatorConfig::CPU, 3, true)), expected);
+  ASSERT_EQ(SimulateCellData(SimulatorConfig(SimulatorConfig::CPU, 3, true), 5), expected);
+  ASSERT_EQ(SimulateCellData(SimulatorConfig(SimulatorConfig::CPU_TASKS, 2, true), 10), expected);
+  ASSERT_EQ(SimulateCellData(SimulatorConfig(SimulatorConfig::CPU_INTRA, 1, true)), expected);
+  ASSERT_EQ(SimulateCellData(SimulatorConfig(SimulatorConfig::CPU_INTRA, 3, true)), expected);
+  ASSERT_THROW(SimulateCellData(SimulatorConfig(SimulatorConfig::CUDA, 0, true)), std::runtime_error);
+}
+
+TEST(Simulator, Placement)
+{
+  // Pinned threads and copies of cells made by their owners must not change results
+  auto expected = SimulateCellData(SimulatorConfig(SimulatorConfig::CPU, 1));
+  SimulatorConfig config(SimulatorConfig::CPU, 3);
+  config.SetPinThreads(true);
+  config.SetFirstTouch(true);
+  ASSERT_EQ(SimulateCellData(config), expected);
+  ASSERT_EQ(SimulateCellData(config, 5), expected);
+}
+
+TEST(Simulator, Retirement)
+{
+  // Springs are broken by the first iteration, so all cells are retired with its state
+  SimParamsGuard guard;
+  SimParams *params = GlobalSimParams::GetRef();
+  params->SetAccess(SimParams::Access::Initialize);
+  params->SetParameter(SimParameter::Int::Spring_Brake_Type, 1);
+  params->SetParameter(SimParameter::Int::Spring_Brake_MTs, 0);
+  const double dt = params->GetParameter(SimParameter::Double::Dt, true);
+
+  std::vector<Random::State> states(4);
+  for (size_t i = 0; i < states.size(); i++)
+  { Random::Initialize(states[i], 100500, (uint32_t)i); }
+  auto reference = SimulatorFactory::Create(states, nullptr, nullptr, SimulatorConfig(SimulatorConfig::CPU, 1, true));
+  reference->DoIteration();
+  std::vector<std::vector<uint8_t> > expected;
+  for (auto &cell : reference->Cells())
+  {
+    const CellData &data = cell->CellObject().Data();
+    expected.emplace_back(data.DataPointer(), data.DataPointer() + data.DataSize());
+  }
+
+  params->SetParameter(SimParameter::Int::Stop_Condition, Simulator::StopOnBrokenSprings);
+  std::pair<SimulatorConfig, int> configs[] = {
+    std::make_pair(SimulatorConfig(SimulatorConfig::CPU, 3, true), 5),
+    std::make_pair(SimulatorConfig(SimulatorConfig::CPU_TASKS, 2, true), 10),
+    std::make_pair(SimulatorConfig(SimulatorConfig::CPU_INTRA, 2, true), 1)
+  };
+  for (auto &config : configs)
+  {
+    auto sim = SimulatorFactory::Create(states, nullptr, nullptr, config.first);
+    sim->DoIterations(config.second);
+    ASSERT_TRUE(sim->IsFinished());
+    ASSERT_EQ(sim->ActiveCellCount(), 0u);
+
+    decltype(auto) cells = sim->Cells();
+    for (size_t i = 0; i < cells.size(); i++)
+    {
+      ASSERT_TRUE(sim->IsRetired(i));
+      ASSERT_NEAR(sim->RetirementTime(i), dt, dt * 1e-3);
+      const CellData &data = cells[i]->CellObject().Data();
+      ASSERT_EQ(std::vector<uint8_t>(data.DataPointer(), data.DataPointer() + data.DataSize()), expected[i]);
+    }
+
+    // Released cells leave the ensemble, but not the statistics
+    auto released = sim->Release(0);
+    ASSERT_TRUE(released != nullptr);
+    ASSERT_TRUE(sim->Cells()[0] == nullptr);
+    ASSERT_EQ(sim->Stats().size(), states.size());
+    ASSERT_THROW(sim->Release(0), std::runtime_error);
+  }
+}
+
+TEST(Simulator, ContinueRetired)
+{
+  // The first cell was retired after one iteration, the others were simulated further
+  SimParamsGuard guard;
+  SimParams *params = GlobalSimParams::GetRef();
+  params->SetAccess(SimParams::Access::Initialize);
+  const double dt = params->GetParameter(SimParameter::Double::Dt, true);
+
+  std::vector<Random::State> states(4);
+  for (size_t i = 0; i < states.size(); i++)
+  { Random::Initialize(states[i], 100500, (uint32_t)i); }
+  auto retired = SimulatorFactory::Create(states, nullptr, nullptr, SimulatorConfig(SimulatorConfig::CPU, 1));
+  retired->DoIteration();
+  auto active = SimulatorFactory::Create(states, nullptr, nullptr, SimulatorConfig(SimulatorConfig::CPU, 1));
+  active->DoIterations(3);
+
+  std::vector<std::pair<const Cell *, Random::State> > cells;
+  std::vector<double> times;
+  cells.emplace_back(&retired->Cells()[0]->CellObject(), retired->Cells()[0]->Rng());
+  times.push_back(retired->Time());
+  for (size_t i = 1; i < states.size(); i++)
+  {
+    cells.emplace_back(&active->Cells()[i]->CellObject(), active->Cells()[i]->Rng());
+    times.push_back(active->Time());
+  }
+  const CellData &data = retired->Cells()[0]->CellObject().Data();
+  std::vector<uint8_t> expected(data.DataPointer(), data.DataPointer() + data.DataSize());
+
+  // Streams of different lengths are accepted only if cells may be retired
+  ASSERT_THROW(SimulatorFactory::Create(cells, times, nullptr, SimulatorConfig(SimulatorConfig::CPU, 1)),
+               std::runtime_error);
+
+  params->SetParameter(SimParameter::Int::Stop_Condition, Simulator::StopOnBrokenSprings);
+  auto sim = SimulatorFactory::Create(cells, times, nullptr, SimulatorConfig(SimulatorConfig::CPU, 2));
+  ASSERT_NEAR(sim->Time(), dt * 3, dt * 1e-3);
+  ASSERT_EQ(sim->ActiveCellCount(), states.size() - 1);
+  ASSERT_TRUE(sim->IsRetired(0));
+  ASSERT_NEAR(sim->RetirementTime(0), dt, dt * 1e-3);
+
+  sim->DoIterations(2);
+  ASSERT_NEAR(sim->Time(), dt * 5, dt * 1e-3);
+  const CellData &kept = sim->Cells()[0]->CellObject().Data();
+  ASSERT_EQ(std::vector<uint8_t>(kept.DataPointer(), kept.DataPointer() + kept.DataSize()), expected);
+}
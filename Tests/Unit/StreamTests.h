@@ -0,0 +1,443 @@
+#pragma once
+#include "Defs.h"
+
+#include "MiCoSi.Objects/All.h"
+#include "MiCoSi.Formatters/Serializer.h"
+#include "MiCoSi.Formatters/DeSerializer.h"
+#include "MiCoSi.Formatters/ChunkCodec.h"
+#include "MiCoSi.Streams/AsyncWriter.h"
+#include "MiCoSi.Streams/FileContainer.h"
+#include "MiCoSi.Streams/FileExplorer.h"
+#include "MiCoSi.Streams/TimeStream.h"
+#include "MiCoSi.Solvers/SimulatorFactory.h"
+
+// Serializes time layer as a binary frame and returns its bytes
+static inline std::vector<uint8_t> FrameBytes(const Cell &cell, double time, const Random::State &rng)
+{
+  MemoryStream stream;
+  Serializer::SerializeFrame(cell, time, rng, stream);
+  const uint8_t *data = (const uint8_t *)stream.GetBuffer();
+  return std::vector<uint8_t>(data, data + stream.Length());
+}
+
+// Creates an empty cell with the same configuration, time layers are loaded into it
+static inline std::unique_ptr<Cell> CopyConfiguration(const Cell &cell, const Random::State &rng)
+{
+  MemoryStream stream;
+  std::unique_ptr<TiXmlElement> elem(Serializer::SerializeCellConfiguration(cell, rng, 0, stream));
+  return DeSerializer::DeserializeCellConfiguration(elem.get(), stream.GetBuffer(), stream.Length());
+}
+
+static inline std::unique_ptr<Simulator> CreateStreamSimulator()
+{
+  std::vector<Random::State> states(1);
+  Random::Initialize(states[0], 100500);
+  return SimulatorFactory::Create(states, nullptr, nullptr, SimulatorConfig(SimulatorConfig::CPU, 1));
+}
+
+TEST(Streams, FrameRoundTrip)
+{
+  auto sim = CreateStreamSimulator();
+  sim->DoIterations(5);
+  const CellWithRng &cell = *sim->Cells()[0];
+  const double time = 1.25;
+  std::vector<uint8_t> expected = FrameBytes(cell.CellObject(), time, cell.Rng());
+
+  // Binary frame
+  auto frameCell = CopyConfiguration(cell.CellObject(), cell.Rng());
+  auto frame = DeSerializer::DeserializeFrame(&expected[0], expected.size(), *frameCell);
+  ASSERT_EQ(frame.first, time);
+  ASSERT_EQ(DeSerializer::DeserializeFrameTime(&expected[0], expected.size()), time);
+  ASSERT_TRUE(FrameBytes(*frameCell, frame.first, frame.second) == expected);
+
+  // The old XML layer must restore exactly the same state
+  MemoryStream stream;
+  std::unique_ptr<TiXmlElement> elem(Serializer::SerializeTimeLayer(cell.CellObject(), time, cell.Rng(), stream));
+  auto xmlCell = CopyConfiguration(cell.CellObject(), cell.Rng());
+  auto layer = DeSerializer::DeserializeTimeLayer(elem.get(), *xmlCell, stream.GetBuffer(), stream.Length());
+  ASSERT_TRUE(FrameBytes(*xmlCell, layer.first, layer.second) == expected);
+
+  // Truncated and foreign data
+  ASSERT_THROW(DeSerializer::DeserializeFrame(&expected[0], expected.size() / 2, *frameCell), std::exception);
+  ASSERT_THROW(DeSerializer::DeserializeFrame(stream.GetBuffer(), stream.Length(), *frameCell), std::exception);
+}
+
+TEST(Streams, BinaryFrames)
+{
+  const std::string file = "stream_tests_binary.cell";
+  auto sim = CreateStreamSimulator();
+  const CellWithRng &cell = *sim->Cells()[0];
+  std::vector<std::vector<uint8_t> > expected;
+  {
+    auto ts = TimeStream::Create(file, cell.CellObject(), cell.Rng(), 100500);
+    ts->Append(*GlobalSimParams::GetRef());
+    for (int i = 0; i < 25; i++)
+    {
+      sim->DoIteration();
+      ts->Append(cell.CellObject(), 0.5 * i, cell.Rng());
+      expected.push_back(FrameBytes(cell.CellObject(), 0.5 * i, cell.Rng()));
+    }
+  }
+
+  {
+    auto ts = TimeStream::Open(file);
+    ASSERT_EQ(ts->LayerCount(), expected.size());
+    for (size_t i = 0; i < expected.size(); i++)
+    {
+      ASSERT_EQ(ts->GetLayerTime(i), 0.5 * i);
+      ts->MoveTo(i);
+      auto layer = ts->Current();
+      ASSERT_TRUE(FrameBytes(layer.GetCell(), layer.GetTime(), layer.GetRng()) == expected[i]);
+    }
+  }
+  remove(file.c_str());
+}
+
+TEST(Streams, DeterministicMode)
+{
+  // The mode is stored with the seed, so continued simulations don't switch it
+  const std::string file = "stream_tests_deterministic.cell";
+  auto sim = CreateStreamSimulator();
+  const CellWithRng &cell = *sim->Cells()[0];
+  for (int mode = 0; mode < 2; mode++)
+  {
+    {
+      auto ts = TimeStream::Create(file, cell.CellObject(), cell.Rng(), 100500, IChunkCodec::Delta, mode != 0);
+      ts->Append(*GlobalSimParams::GetRef());
+      ts->Append(cell.CellObject(), 0.0, cell.Rng());
+    }
+
+    auto ts = TimeStream::Open(file);
+    ASSERT_EQ(ts->IsDeterministic(), mode != 0);
+    ASSERT_EQ(ts->UserSeed(), 100500);
+  }
+  remove(file.c_str());
+}
+
+TEST(Streams, LegacyFormat)
+{
+  const std::string file = "stream_tests_legacy.cell";
+  auto sim = CreateStreamSimulator();
+  const CellWithRng &cell = *sim->Cells()[0];
+  std::vector<std::vector<uint8_t> > expected;
+  {
+    // Writes the file like the programs of the 2nd format did
+    std::unique_ptr<FileExplorer> fe(
+        FileExplorer::Create(file, 10,
+                             Serializer::SerializeVersion(CurrentVersion::ProgramVersion(),
+                                                          CurrentVersion::CompilationFlags(), 2))
+    );
+    ASSERT_FALSE(fe->BinaryFrames());
+    MemoryStream conf;
+    fe->AppendCellConfiguration(Serializer::SerializeCellConfiguration(cell.CellObject(), cell.Rng(), 100500, conf),
+                                &conf);
+    MemoryStream params;
+    fe->AppendServiceLayer(Serializer::SerializeSimParams(*GlobalSimParams::GetRef(), params), &params);
+    for (int i = 0; i < 12; i++)
+    {
+      sim->DoIteration();
+      MemoryStream stream;
+      fe->AppendFrameLayer(i, Serializer::SerializeTimeLayer(cell.CellObject(), i, cell.Rng(), stream), &stream);
+      expected.push_back(FrameBytes(cell.CellObject(), i, cell.Rng()));
+    }
+  }
+
+  {
+    // Old files are continued in their own format
+    auto ts = TimeStream::Open(file);
+    ASSERT_EQ(ts->LayerCount(), expected.size());
+    sim->DoIteration();
+    ts->Append(cell.CellObject(), 12.0, cell.Rng());
+    expected.push_back(FrameBytes(cell.CellObject(), 12.0, cell.Rng()));
+  }
+
+  {
+    auto ts = TimeStream::Open(file);
+    ASSERT_EQ(ts->LayerCount(), expected.size());
+    for (size_t i = 0; i < expected.size(); i++)
+    {
+      ASSERT_EQ(ts->GetLayerTime(i), (double)i);
+      ts->MoveTo(i);
+      auto layer = ts->Current();
+      ASSERT_TRUE(FrameBytes(layer.GetCell(), layer.GetTime(), layer.GetRng()) == expected[i]);
+    }
+  }
+  remove(file.c_str());
+}
+
+TEST(Streams, MappedChunks)
+{
+  const std::string file = "stream_tests_mapped.cell";
+  auto sim = CreateStreamSimulator();
+  const CellWithRng &cell = *sim->Cells()[0];
+  std::vector<std::vector<uint8_t> > expected;
+  {
+    auto ts = TimeStream::Create(file, cell.CellObject(), cell.Rng(), 100500);
+    ts->Append(*GlobalSimParams::GetRef());
+    for (int i = 0; i < 25; i++)
+    {
+      sim->DoIteration();
+      ts->Append(cell.CellObject(), i, cell.Rng());
+      expected.push_back(FrameBytes(cell.CellObject(), i, cell.Rng()));
+    }
+  }
+
+  {
+    // Chunks of the mapped file are views, so nothing is copied
+    auto fc = FileContainer::Open(file);
+    ASSERT_TRUE(fc->IsMapped());
+    for (size_t i = 0; i < fc->Table().size(); i++)
+    {
+      auto first = fc->LoadChunk(i), second = fc->LoadChunk(i);
+      ASSERT_EQ(first->BinDataPointer(), second->BinDataPointer());
+    }
+  }
+
+  {
+    // Chunks that are appended after opening are not mapped, but they must be readable too
+    auto ts = TimeStream::Open(file);
+    for (int i = 25; i < 40; i++)
+    {
+      sim->DoIteration();
+      ts->Append(cell.CellObject(), i, cell.Rng());
+      expected.push_back(FrameBytes(cell.CellObject(), i, cell.Rng()));
+    }
+    ASSERT_EQ(ts->LayerCount(), expected.size());
+    for (size_t i = 0; i < expected.size(); i++)
+    {
+      ts->MoveTo(i);
+      auto layer = ts->Current();
+      ASSERT_TRUE(FrameBytes(layer.GetCell(), layer.GetTime(), layer.GetRng()) == expected[i]);
+    }
+  }
+  remove(file.c_str());
+}
+
+TEST(Streams, ChunkCodec)
+{
+  auto sim = CreateStreamSimulator();
+  const CellWithRng &cell = *sim->Cells()[0];
+
+  // Chunk with aligned frames, like the writers produce
+  std::vector<uint8_t> chunk;
+  std::vector<FrameFormat::FrameRecord> frames;
+  for (int i = 0; i < 10; i++)
+  {
+    sim->DoIteration();
+    std::vector<uint8_t> frame = FrameBytes(cell.CellObject(), i, cell.Rng());
+    chunk.resize(FrameFormat::Align(chunk.size()), 0);
+    FrameFormat::FrameRecord record = { (double)i, (uint64_t)chunk.size(), (uint64_t)frame.size() };
+    frames.push_back(record);
+    chunk.insert(chunk.end(), frame.begin(), frame.end());
+  }
+
+  ASSERT_TRUE(IChunkCodec::Get(100500) == nullptr);
+  for (uint32_t id = IChunkCodec::None; id <= IChunkCodec::Delta; id++)
+  {
+    const IChunkCodec *codec = IChunkCodec::Get(id);
+    ASSERT_TRUE(codec != nullptr);
+    ASSERT_EQ(codec->Id(), id);
+
+    MemoryStream encoded;
+    codec->Encode(&chunk[0], chunk.size(), frames, encoded);
+    std::vector<uint8_t> decoded(chunk.size());
+    codec->Decode(encoded.GetBuffer(), encoded.Length(), frames, &decoded[0], decoded.size());
+    ASSERT_TRUE(decoded == chunk);
+    if (id == IChunkCodec::Delta)
+    {
+      // Successive time layers are similar, so they must be compressed well
+      ASSERT_LT(encoded.Length(), chunk.size() / 2);
+      ASSERT_THROW(codec->Decode(encoded.GetBuffer(), encoded.Length() - 8, frames, &decoded[0], decoded.size()),
+                   std::exception);
+    }
+  }
+}
+
+TEST(Streams, EncodedChunks)
+{
+  const std::string file = "stream_tests_encoded.cell";
+  auto sim = CreateStreamSimulator();
+  const CellWithRng &cell = *sim->Cells()[0];
+
+  // The 3rd format has no codecs, its chunks are stored as is
+  for (int format = FrameFormat::FIRST_FILE_FORMAT; format <= CurrentVersion::FileFormatVersion(); format++)
+  {
+    std::vector<std::vector<uint8_t> > expected;
+    {
+      std::unique_ptr<FileExplorer> fe(
+          FileExplorer::Create(file, 10,
+                               Serializer::SerializeVersion(CurrentVersion::ProgramVersion(),
+                                                            CurrentVersion::CompilationFlags(), format))
+      );
+      MemoryStream conf;
+      fe->AppendCellConfiguration(Serializer::SerializeCellConfiguration(cell.CellObject(), cell.Rng(), 100500, conf),
+                                  &conf);
+      MemoryStream params;
+      fe->AppendServiceLayer(Serializer::SerializeSimParams(*GlobalSimParams::GetRef(), params), &params);
+      for (int i = 0; i < 15; i++)
+      {
+        sim->DoIteration();
+        MemoryStream stream;
+        Serializer::SerializeFrame(cell.CellObject(), i, cell.Rng(), stream);
+        fe->AppendFrameLayer(i, nullptr, &stream);
+        expected.push_back(FrameBytes(cell.CellObject(), i, cell.Rng()));
+      }
+    }
+
+    {
+      auto fc = FileContainer::Open(file);
+      auto chunk = fc->LoadChunk(2);
+      std::vector<FrameFormat::FrameRecord> frames;
+      uint32_t codec = 0;
+      uint64_t dataSize = 0;
+      ASSERT_TRUE(FrameFormat::ReadDirectory(chunk->MetaDataPointer(), (size_t)chunk->Header().MetaDataSize(),
+                                             (size_t)chunk->Header().BinDataSize(), frames, codec, dataSize));
+      ASSERT_EQ(codec, format >= FrameFormat::FIRST_CODEC_FILE_FORMAT ? (uint32_t)IChunkCodec::Delta
+                                                                     : (uint32_t)IChunkCodec::None);
+    }
+
+    {
+      auto ts = TimeStream::Open(file);
+      ASSERT_EQ(ts->LayerCount(), expected.size());
+      for (size_t i = 0; i < expected.size(); i++)
+      {
+        ts->MoveTo(i);
+        auto layer = ts->Current();
+        ASSERT_TRUE(FrameBytes(layer.GetCell(), layer.GetTime(), layer.GetRng()) == expected[i]);
+      }
+    }
+    remove(file.c_str());
+  }
+}
+
+TEST(Streams, HalfFloats)
+{
+  const float exact[] = { 0.0f, 1.0f, -0.5f, 65504.0f, 1.0f / 1024, std::ldexp(1.0f, -24) };
+  for (size_t i = 0; i < sizeof(exact) / sizeof(exact[0]); i++)
+  { ASSERT_EQ(FrameFormat::HalfToFloat(FrameFormat::FloatToHalf(exact[i])), exact[i]); }
+
+  ASSERT_NEAR(FrameFormat::HalfToFloat(FrameFormat::FloatToHalf(1.0f / 3)), 1.0f / 3, 1e-3f / 3);
+  ASSERT_EQ(FrameFormat::FloatToHalf(1e6f), 0x7c00);
+  ASSERT_EQ(FrameFormat::FloatToHalf(1e-9f), 0);
+}
+
+TEST(Streams, StorageProfiles)
+{
+  const std::string file = "stream_tests_profiles.cell";
+  auto sim = CreateStreamSimulator();
+  sim->DoIterations(20);
+  const CellWithRng &cell = *sim->Cells()[0];
+  const Cell &expected = cell.CellObject();
+  const double range = 2.0 * GlobalSimParams::GetRef()->GetParameter(SimParameter::Double::R_Cell, true);
+  const double step = range / 65535;
+
+  size_t fullSize = FrameBytes(expected, 0.0, cell.Rng()).size();
+  FrameFormat::Profile profiles[] = { FrameFormat::Analysis, FrameFormat::Topology };
+  for (size_t p = 0; p < sizeof(profiles) / sizeof(profiles[0]); p++)
+  {
+    MemoryStream frame;
+    Serializer::SerializeFrame(expected, 0.0, cell.Rng(), frame, profiles[p], range);
+    ASSERT_LT(frame.Length(), fullSize / 2);
+    ASSERT_EQ(DeSerializer::DeserializeFrameProfile(frame.GetBuffer(), frame.Length()), profiles[p]);
+
+    {
+      auto ts = TimeStream::Create(file, expected, cell.Rng(), 100500);
+      ts->Append(*GlobalSimParams::GetRef());
+      ts->Append(expected, 0.5, cell.Rng());
+      ts->SetProfile(profiles[p]);
+      ts->Append(expected, 1.0, cell.Rng());
+    }
+
+    // The full layer is loaded first, the lossy one must not keep its values
+    auto ts = TimeStream::Open(file);
+    ts->MoveTo(0);
+    ASSERT_EQ(ts->Current().GetProfile(), FrameFormat::Full);
+    ts->MoveTo(1);
+    auto layer = ts->Current();
+    ASSERT_EQ(layer.GetProfile(), profiles[p]);
+    ASSERT_EQ(layer.GetTime(), 1.0);
+    const Cell &actual = layer.GetCell();
+    for (size_t i = 0; i < expected.MTs().size(); i++)
+    {
+      const MT *e = expected.MTs()[i], *a = actual.MTs()[i];
+      ASSERT_EQ(e->State(), a->State());
+      ASSERT_EQ(e->BoundChromosome() == nullptr ? -1 : (int)e->BoundChromosome()->ID(),
+                a->BoundChromosome() == nullptr ? -1 : (int)a->BoundChromosome()->ID());
+      ASSERT_EQ(a->ForceOffset().x, 0.0);
+      if (profiles[p] == FrameFormat::Analysis)
+      {
+        ASSERT_NEAR(a->Length(), e->Length(), step);
+        ASSERT_NEAR(a->Direction().x, e->Direction().x, 1e-3);
+        ASSERT_NEAR(a->Direction().y, e->Direction().y, 1e-3);
+        ASSERT_NEAR(a->Direction().z, e->Direction().z, 1e-3);
+      }
+      else
+      {
+        ASSERT_EQ(a->Length(), 0.0);
+        ASSERT_EQ(a->Direction().x, vec3r::DEFAULT_DIRECT.x);
+        ASSERT_EQ(a->Direction().y, vec3r::DEFAULT_DIRECT.y);
+        ASSERT_EQ(a->Direction().z, vec3r::DEFAULT_DIRECT.z);
+      }
+    }
+    for (size_t i = 0; i < expected.Chromosomes().size(); i++)
+    {
+      vec3r e = (vec3r)expected.Chromosomes()[i]->Position(), a = (vec3r)actual.Chromosomes()[i]->Position();
+      ASSERT_EQ(e.x, a.x);
+      ASSERT_EQ(e.y, a.y);
+      ASSERT_EQ(e.z, a.z);
+    }
+    ts.reset();
+    remove(file.c_str());
+  }
+}
+
+TEST(Streams, AsyncWriter)
+{
+  std::vector<Random::State> states(3);
+  for (size_t i = 0; i < states.size(); i++)
+  { Random::Initialize(states[i], 100500, (uint32_t)i); }
+  auto sim = SimulatorFactory::Create(states, nullptr, nullptr, SimulatorConfig(SimulatorConfig::CPU, 1));
+
+  std::vector<std::string> files;
+  std::vector<std::unique_ptr<TimeStream> > streams;
+  std::vector<TimeStream *> pointers;
+  for (size_t i = 0; i < states.size(); i++)
+  {
+    files.push_back("stream_tests_async" + std::to_string(i) + ".cell");
+    streams.push_back(TimeStream::Create(files[i], sim->Cells()[i]->CellObject(), sim->Cells()[i]->Rng(), 100500));
+    streams[i]->Append(*GlobalSimParams::GetRef());
+    pointers.push_back(streams[i].get());
+  }
+
+  // The simulation goes on while layers are written, so they must be snapshots
+  std::vector<std::vector<std::vector<uint8_t> > > expected(states.size());
+  {
+    AsyncWriter writer(pointers, 2);
+    for (int layer = 0; layer < 25; layer++)
+    {
+      sim->DoIteration();
+      for (size_t i = 0; i < states.size(); i++)
+      {
+        const CellWithRng &cell = *sim->Cells()[i];
+        writer.Append(i, cell.CellObject(), layer, cell.Rng());
+        expected[i].push_back(FrameBytes(cell.CellObject(), layer, cell.Rng()));
+      }
+    }
+    writer.Wait();
+  }
+  streams.clear();
+
+  for (size_t i = 0; i < files.size(); i++)
+  {
+    auto ts = TimeStream::Open(files[i]);
+    ASSERT_EQ(ts->LayerCount(), expected[i].size());
+    for (size_t j = 0; j < expected[i].size(); j++)
+    {
+      ts->MoveTo(j);
+      auto layer = ts->Current();
+      ASSERT_TRUE(FrameBytes(layer.GetCell(), layer.GetTime(), layer.GetRng()) == expected[i][j]);
+    }
+    ts.reset();
+    remove(files[i].c_str());
+  }
+}